@@ -0,0 +1,321 @@
+#pragma once
+
+#include "../include/InvalidMatrixFormat.hpp"
+#include "../include/Matrix.hpp"
+#include "../include/MatrixView.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @class FixedMatrix
+ * @brief A dense R x C matrix of doubles whose shape is known at compile time, for small transforms.
+ *
+ * The elements live inline in a row-major std::array, so a FixedMatrix never allocates, copies like a struct
+ * and has no reference count. All arithmetic is constexpr and the loops over rows and columns are unrolled at
+ * compile time, which leaves the compiler straight-line code to keep in registers and vectorize. Shapes are
+ * checked at compile time as well: multiplying a 3 x 4 by a 3 x 4 matrix does not compile.
+ *
+ * Conversions from Matrix and MatrixView copy R * C elements, to_matrix() copies them back.
+ *
+ * Example usage:
+ * @code
+ * constexpr FixedMatrix<3, 3> rotation({0, -1, 0,
+ *                                       1, 0, 0,
+ *                                       0, 0, 1});
+ * constexpr FixedMatrix<3, 3> identity = rotation * rotation.inverse();
+ * FixedMatrix<3, 3> transform(matrix.view().sub_view(0, 0, 3, 3));
+ * @endcode
+ */
+template <int R, int C>
+class FixedMatrix
+{
+    static_assert(R > 0 && C > 0, "A FixedMatrix must have at least one row and one column.");
+
+public:
+    /**
+     * @brief Constructs a matrix of zeros.
+     */
+    constexpr FixedMatrix() : elements{} {}
+
+    /**
+     * @brief Constructs a matrix from its elements in row-major order, FixedMatrix<2, 2>({1, 2, 3, 4}).
+     *
+     * Taking a built-in array lets a braced list bind directly, so it never competes with the conversions from Matrix.
+     */
+    constexpr explicit FixedMatrix(const double (&values)[R * C]) : elements{}
+    {
+        unroll<R * C>([&](auto i)
+                      { elements[i] = values[i]; });
+    }
+
+    /**
+     * @brief Copies an R x C matrix.
+     *
+     * @throws InvalidMatrixFormat If the matrix is not R x C.
+     */
+    explicit FixedMatrix(const Matrix &matrix) : elements{}
+    {
+        check_shape(matrix.get_rows(), matrix.get_cols());
+        for (int i = 0; i < R; i++)
+        {
+            Span<const double> row = matrix.row(i);
+            std::copy(row.begin(), row.end(), elements.data() + i * C);
+        }
+    }
+
+    /**
+     * @brief Copies an R x C view of any layout, padding reads as zero.
+     *
+     * @throws InvalidMatrixFormat If the view is not R x C.
+     */
+    explicit FixedMatrix(const MatrixView &view) : elements{}
+    {
+        check_shape(view.get_rows(), view.get_cols());
+        view.copy_to(elements.data(), C);
+    }
+
+    /**
+     * @brief Returns the identity matrix.
+     */
+    static constexpr FixedMatrix identity()
+    {
+        static_assert(R == C, "Only square matrices have an identity.");
+
+        FixedMatrix result;
+        unroll<R>([&](auto i)
+                  { result.elements[i * C + i] = 1.0; });
+        return result;
+    }
+
+    static constexpr int get_rows() { return R; }
+    static constexpr int get_cols() { return C; }
+
+    constexpr double *data() { return elements.data(); }
+    constexpr const double *data() const { return elements.data(); }
+
+    /**
+     * @brief Returns the element at the specified row and column. Only checked in debug builds.
+     */
+    constexpr double &operator()(int row, int col)
+    {
+        assert(row >= 0 && row < R && col >= 0 && col < C);
+        return elements[row * C + col];
+    }
+
+    constexpr double operator()(int row, int col) const
+    {
+        assert(row >= 0 && row < R && col >= 0 && col < C);
+        return elements[row * C + col];
+    }
+
+    constexpr FixedMatrix operator+(const FixedMatrix &other) const
+    {
+        FixedMatrix result;
+        unroll<R * C>([&](auto i)
+                      { result.elements[i] = elements[i] + other.elements[i]; });
+        return result;
+    }
+
+    constexpr FixedMatrix operator-(const FixedMatrix &other) const
+    {
+        FixedMatrix result;
+        unroll<R * C>([&](auto i)
+                      { result.elements[i] = elements[i] - other.elements[i]; });
+        return result;
+    }
+
+    constexpr FixedMatrix operator*(double scalar) const
+    {
+        FixedMatrix result;
+        unroll<R * C>([&](auto i)
+                      { result.elements[i] = elements[i] * scalar; });
+        return result;
+    }
+
+    constexpr FixedMatrix &operator+=(const FixedMatrix &other) { return *this = *this + other; }
+    constexpr FixedMatrix &operator-=(const FixedMatrix &other) { return *this = *this - other; }
+    constexpr FixedMatrix &operator*=(double scalar) { return *this = *this * scalar; }
+
+    /**
+     * @brief Multiplies with a C x N matrix.
+     *
+     * Row i of the result is accumulated as the sum over k of A(i, k) times row k of B, so the innermost
+     * operations run along contiguous rows and map onto SIMD multiply-adds.
+     */
+    template <int N>
+    constexpr FixedMatrix<R, N> operator*(const FixedMatrix<C, N> &other) const
+    {
+        FixedMatrix<R, N> result;
+        unroll<R>([&](auto i)
+                  { unroll<C>([&](auto k)
+                              {
+            double a = elements[i * C + k];
+            unroll<N>([&](auto j)
+                      { result.elements[i * N + j] += a * other.elements[k * N + j]; }); }); });
+        return result;
+    }
+
+    constexpr FixedMatrix<C, R> transpose() const
+    {
+        FixedMatrix<C, R> result;
+        unroll<R>([&](auto i)
+                  { unroll<C>([&](auto j)
+                              { result.elements[j * R + i] = elements[i * C + j]; }); });
+        return result;
+    }
+
+    /**
+     * @brief Returns the inverse, computed by Gauss-Jordan elimination with partial pivoting.
+     *
+     * @throws std::domain_error If the matrix is singular. In a constant expression this is a compile error.
+     */
+    constexpr FixedMatrix inverse() const
+    {
+        static_assert(R == C, "Only square matrices have an inverse.");
+
+        FixedMatrix left = *this;
+        FixedMatrix right = identity();
+        for (int column = 0; column < R; column++)
+        {
+            int pivot = column;
+            for (int i = column + 1; i < R; i++)
+            {
+                if (magnitude(left(i, column)) > magnitude(left(pivot, column)))
+                {
+                    pivot = i;
+                }
+            }
+            if (left(pivot, column) == 0.0)
+            {
+                throw std::domain_error("Matrix is singular and can not be inverted.");
+            }
+            if (pivot != column)
+            {
+                left.swap_rows(pivot, column);
+                right.swap_rows(pivot, column);
+            }
+
+            double scale = 1.0 / left(column, column);
+            left.scale_row(column, scale);
+            right.scale_row(column, scale);
+            for (int i = 0; i < R; i++)
+            {
+                double factor = left(i, column);
+                if (i != column && factor != 0.0)
+                {
+                    left.subtract_row(i, column, factor);
+                    right.subtract_row(i, column, factor);
+                }
+            }
+        }
+        return right;
+    }
+
+    constexpr bool operator==(const FixedMatrix &other) const
+    {
+        for (int i = 0; i < R * C; i++)
+        {
+            if (elements[i] != other.elements[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const FixedMatrix &other) const { return !(*this == other); }
+
+    /**
+     * @brief Copies the elements into a new Matrix.
+     */
+    Matrix to_matrix() const
+    {
+        Matrix result = Matrix::uninitialized(R, C);
+        for (int i = 0; i < R; i++)
+        {
+            std::copy(elements.data() + i * C, elements.data() + (i + 1) * C, result.row(i).begin());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns a view of the elements, so that a FixedMatrix can be passed to MatrixOperator.
+     *
+     * The view does not own the elements and must not outlive this matrix.
+     */
+    MatrixView view() const
+    {
+        return MatrixView(std::shared_ptr<const double[]>(std::shared_ptr<const double[]>(), elements.data()), R, C, 0, 0);
+    }
+
+private:
+    std::array<double, R * C> elements;
+
+    template <int, int>
+    friend class FixedMatrix;
+
+    /**
+     * @brief Calls f with std::integral_constant indices 0 to N - 1, expanded at compile time.
+     */
+    template <int N, typename F>
+    static constexpr void unroll(F &&f)
+    {
+        unroll(f, std::make_integer_sequence<int, N>());
+    }
+
+    template <typename F, int... I>
+    static constexpr void unroll(F &f, std::integer_sequence<int, I...>)
+    {
+        (f(std::integral_constant<int, I>()), ...);
+    }
+
+    static constexpr double magnitude(double value)
+    {
+        return value < 0.0 ? -value : value;
+    }
+
+    static void check_shape(int rows, int cols)
+    {
+        if (rows != R || cols != C)
+        {
+            throw InvalidMatrixFormat("Shape does not match the FixedMatrix.");
+        }
+    }
+
+    constexpr void swap_rows(int first, int second)
+    {
+        for (int j = 0; j < C; j++)
+        {
+            double value = elements[first * C + j];
+            elements[first * C + j] = elements[second * C + j];
+            elements[second * C + j] = value;
+        }
+    }
+
+    constexpr void scale_row(int row, double scale)
+    {
+        unroll<C>([&](auto j)
+                  { elements[row * C + j] *= scale; });
+    }
+
+    constexpr void subtract_row(int row, int source, double factor)
+    {
+        unroll<C>([&](auto j)
+                  { elements[row * C + j] -= factor * elements[source * C + j]; });
+    }
+};
+
+/**
+ * @brief Multiplies every element by a scalar, scalar * matrix.
+ */
+template <int R, int C>
+constexpr FixedMatrix<R, C> operator*(double scalar, const FixedMatrix<R, C> &matrix)
+{
+    return matrix * scalar;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "../include/ThreadPool.hpp"
+
+#include <cstdint>
+
+/**
+ * @struct GemmBlockSizes
+ * @brief Cache blocking parameters for GemmKernel.
+ *
+ * The defaults are chosen so that a kc x nr sliver of packed B stays in L1, an mc x kc block of
+ * packed A stays in L2 and a kc x nc panel of packed B stays in L3.
+ */
+struct GemmBlockSizes
+{
+    int mc = 128;
+    int kc = 256;
+    int nc = 2048;
+};
+
+/**
+ * @class GemmKernel
+ * @brief Cache-blocked, register-tiled general matrix multiplication on raw storage.
+ *
+ * The kernel follows the usual three level blocking scheme: B is packed into kc x nc panels,
+ * A is packed into mc x kc blocks and an mr x nr micro-kernel accumulates a tile of C in registers
+ * while streaming through contiguous packed data.
+ *
+ * The micro-kernel and its tile shape come from SimdKernels, so the widest instruction set supported
+ * by the running CPU is used. Small products that fit into a single block, like the matrices of a batch,
+ * skip the blocking loops and pack A one register panel at a time.
+ *
+ * Operands are described by a pointer and a row and column stride, so transposed operands
+ * can be passed without materializing them. The element type is float or double, each with its
+ * own micro-kernel and tile shape. Float operands may also be accumulated into a double C: they are
+ * widened while they are packed and multiplied by the double micro-kernel.
+ *
+ * multiply_int8() multiplies int8 operands with exact int32 accumulation and dequantizes the result
+ * as it is added to a float C, with packing and micro-kernels of its own, see Int8KernelTable.
+ *
+ * Example usage:
+ * @code
+ * GemmKernel kernel;
+ * kernel.multiply(m, n, k, a, k, 1, b, n, 1, c, n); // C += A * B, all row-major
+ * kernel.multiply_int8(m, n, k, qa, k, a_scales, qb, n, b_scales, d, n); // D += diag(a_scales) QA QB diag(b_scales)
+ * @endcode
+ */
+class GemmKernel
+{
+public:
+    /**
+     * @brief Constructs a GemmKernel with the default block sizes.
+     */
+    GemmKernel();
+
+    /**
+     * @brief Constructs a GemmKernel with the given block sizes.
+     *
+     * @param block_sizes The cache blocking parameters to use.
+     *
+     * @throws std::invalid_argument If any of the block sizes is not positive.
+     */
+    explicit GemmKernel(const GemmBlockSizes &block_sizes);
+
+    /**
+     * @brief Computes C += alpha * A * B.
+     *
+     * Element (i, j) of an operand X is read from x[i * x_row_stride + j * x_col_stride].
+     * C is always written with unit column stride. alpha is applied while A is packed, so it costs nothing extra.
+     * The operands have element type S and C has element type T, float and double or both the same.
+     *
+     * @param m The number of rows in A and C.
+     * @param n The number of columns in B and C.
+     * @param k The number of columns in A and rows in B.
+     * @param a Pointer to the first element of A.
+     * @param a_row_stride Distance between consecutive rows of A.
+     * @param a_col_stride Distance between consecutive columns of A.
+     * @param b Pointer to the first element of B.
+     * @param b_row_stride Distance between consecutive rows of B.
+     * @param b_col_stride Distance between consecutive columns of B.
+     * @param c Pointer to the first element of C.
+     * @param c_row_stride Distance between consecutive rows of C.
+     * @param alpha The factor the product is scaled by before it is added to C.
+     */
+    template <typename S, typename T>
+    void multiply(int m, int n, int k,
+                  const S *a, int a_row_stride, int a_col_stride,
+                  const S *b, int b_row_stride, int b_col_stride,
+                  T *c, int c_row_stride, double alpha = 1.0) const;
+
+    /**
+     * @brief Computes C += alpha * A * B on the given thread pool.
+     *
+     * C is partitioned into a grid of 2D tiles whose sides are multiples of the micro-kernel tile,
+     * and every tile is computed as an independent blocked product by one worker. Each worker packs
+     * into its own thread local buffers. The calling thread helps with queued tasks until all tiles are done,
+     * so it is safe to call from one of the pool's own workers.
+     *
+     * The parameters are the same as for the serial overload.
+     */
+    template <typename S, typename T>
+    void multiply(ThreadPool &pool, int m, int n, int k,
+                  const S *a, int a_row_stride, int a_col_stride,
+                  const S *b, int b_row_stride, int b_col_stride,
+                  T *c, int c_row_stride, double alpha = 1.0) const;
+
+    /**
+     * @brief Computes C += diag(a_row_scales) * A * B * diag(b_col_scales) for int8 A and B, both row-major.
+     *
+     * The products are summed exactly in int32 over slices of 4 * kc steps of the shared dimension, which keeps the
+     * packed blocks at the byte size of the double kernel's. Every slice is scaled and added to C by the micro-kernel,
+     * so no int32 result matrix is ever stored.
+     *
+     * @param a_row_scales The m scale factors of the rows of A.
+     * @param b_col_scales The n scale factors of the columns of B.
+     */
+    void multiply_int8(int m, int n, int k,
+                       const std::int8_t *a, int a_row_stride, const float *a_row_scales,
+                       const std::int8_t *b, int b_row_stride, const float *b_col_scales,
+                       float *c, int c_row_stride) const;
+
+    /**
+     * @brief Computes the int8 product on the given thread pool, tiled like the parallel multiply().
+     */
+    void multiply_int8(ThreadPool &pool, int m, int n, int k,
+                       const std::int8_t *a, int a_row_stride, const float *a_row_scales,
+                       const std::int8_t *b, int b_row_stride, const float *b_col_scales,
+                       float *c, int c_row_stride) const;
+
+    const GemmBlockSizes &get_block_sizes() const;
+
+private:
+    GemmBlockSizes block_sizes;
+};
@@ -1,19 +1,26 @@
 #pragma once
 
+#include "../include/MatrixAllocator.hpp"
+#include "../include/MatrixExpression.hpp"
 #include "../include/MatrixView.hpp"
 #include "../include/TransposedMatrixView.hpp"
 #include "../include/PaddedMatrixView.hpp"
+#include "../include/Span.hpp"
 
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
 #include <vector>
 
-// Forward declaration of MatrixView
-class MatrixView;
+class MatrixOperator;
 
 /**
- * @class Matrix
- * @brief Represents a matrix of double values.
+ * @class BasicMatrix
+ * @brief Represents a matrix of float or double values.
  *
- * This class represents a matrix of double values and provides basic operations on matrices.
+ * This class represents a matrix of float or double values and provides basic operations on matrices.
+ * Matrix and FloatMatrix name the two element types. Both are compiled once in Matrix.cpp, other element
+ * types are not supported.
  *
  * Example usage:
  * @code
@@ -27,29 +34,90 @@ class MatrixView;
  * @endcode
  *
  * This will create a 2x3 matrix and set its elements to the values provided.
+ *
+ * Matrices are values with copy-on-write storage. A copy, like a view, shares the elements of the original
+ * and costs no more than a reference count increment. The first mutating access through a matrix whose storage
+ * is shared gives it a private copy, so writes never show through other copies, and views keep the elements
+ * they were taken from. Moves transfer the storage.
+ *
+ * Pointers and spans returned by data(), row() and column() write straight into the storage. They are
+ * invalidated by copying the matrix, take a fresh one after every copy.
  */
-class Matrix
+template <typename T>
+class BasicMatrix
 {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                  "Matrix elements are float or double.");
+
 public:
+    using value_type = T;
+
+    /**
+     * @brief Alignment in bytes of the first element. Matches a cache line and an AVX-512 register.
+     */
+    static constexpr std::size_t ALIGNMENT = MatrixAllocator::ALIGNMENT;
+
     /**
      * @brief Constructs a Matrix object with the specified number of rows and columns.
      *
-     * Initializes the matrix with zeros.
+     * Initializes the matrix with zeros. Rows are default_leading_dimension(c) elements apart.
+     *
+     * @param r The number of rows in the matrix.
+     * @param c The number of columns in the matrix.
+     */
+    BasicMatrix(int r, int c);
+
+    /**
+     * @brief Constructs a zero-initialized Matrix whose rows are leading_dimension elements apart.
      *
      * @param r The number of rows in the matrix.
      * @param c The number of columns in the matrix.
+     * @param leading_dimension The distance between the starts of consecutive rows, in elements.
+     *
+     * @throws std::invalid_argument If leading_dimension is smaller than c.
      */
-    Matrix(int r, int c);
+    BasicMatrix(int r, int c, int leading_dimension);
+
+    /**
+     * @brief Constructs a Matrix whose elements are left uninitialized, for results that overwrite every element.
+     *
+     * Skips the zero fill of Matrix(int, int), which costs as much as a copy of the matrix. Only the padding at the
+     * end of each row is zeroed. Storage comes from MatrixAllocator::get_default() like for every matrix.
+     */
+    static BasicMatrix uninitialized(int r, int c);
+
+    /**
+     * @brief Returns the row pitch used for a matrix with the given number of columns.
+     *
+     * Rows of at least a cache line of elements are padded to a whole number of cache lines, so that every row
+     * starts 64-byte aligned. If that makes the row pitch a multiple of 4 KiB, one more cache line is
+     * added: otherwise walking down a column hits the same cache set on every row and loads 4K-alias
+     * with earlier stores. Narrower matrices are stored densely.
+     */
+    static int default_leading_dimension(int cols);
 
     /**
      * @brief Transposes the current matrix.
      *
      * This function creates a new matrix where the rows and columns are swapped.
-     * The original matrix remains unchanged.
+     * The original matrix remains unchanged. The copy is done by the cache-oblivious TransposeKernel,
+     * MatrixOperator::transpose() runs it on a thread pool.
      *
      * @return A new matrix that is the transpose of the current matrix.
      */
-    Matrix transpose() const;
+    BasicMatrix transpose() const;
+
+    /**
+     * @brief Transposes a square matrix in place, without allocating.
+     *
+     * @throws InvalidMatrixFormat If the matrix is not square.
+     */
+    void transpose_in_place();
+
+    /**
+     * @brief Returns a view of the whole matrix that shares its data.
+     */
+    BasicMatrixView<T> view() const;
 
     /**
      * @brief Returns a view of the transposed matrix.
@@ -63,7 +131,7 @@ public:
      *
      * @see MatrixView
      */
-    TransposedMatrixView transpose_view() const;
+    BasicTransposedMatrixView<T> transpose_view() const;
 
     /**
      * @brief Creates a square view of the current matrix.
@@ -77,18 +145,21 @@ public:
      *
      * @note This function should not be used in production code. It is only intended for testing and debugging purposes.
      */
-    PaddedMatrixView create_square_view() const;
+    BasicPaddedMatrixView<T> create_square_view() const;
 
     /**
      * @brief This method is for testing purposes only and should not be used in production.
      *
      * Use set_element() to set data in the matrix.
      */
-    void set_data(const std::vector<std::vector<double>> &newData);
+    void set_data(const std::vector<std::vector<T>> &newData);
 
     /**
      * @brief Overloads the subscript operator to access elements in the matrix.
      *
+     * This is the checked accessor: the index is validated on every call, in every build type.
+     * Loops over many elements should use unchecked(), row(), column() or data() instead.
+     *
      * @param row The row index of the element to access.
      * @param col The column index of the element to access.
      *
@@ -96,7 +167,7 @@ public:
      *
      * @throws std::out_of_range If the specified column or row index is out of bounds.
      */
-    double &operator()(int row, int col);
+    T &operator()(int row, int col);
 
     /**
      * @brief Overloads the subscript operator to access elements in the matrix.
@@ -108,42 +179,151 @@ public:
      *
      * @throws std::out_of_range If the specified column or row index is out of bounds.
      */
-    const double &operator()(int row, int col) const;
+    const T &operator()(int row, int col) const;
 
     /**
-     * @brief Overloads the addition operator. Adds two matrices element-wise and returns a new matrix.
+     * @brief Returns a pointer to the first element. The elements are stored row-major, rows are get_leading_dimension() elements apart.
      *
-     * @param other The other matrix to add to the current matrix.
+     * The pointer is aligned to ALIGNMENT bytes. The non-const overload first gives the matrix storage of its own.
      */
-    Matrix operator+(const Matrix &other) const;
+    T *data()
+    {
+        detach();
+        return storage.get();
+    }
+
+    const T *data() const { return storage.get(); }
 
     /**
-     * @brief Overloads the subtraction operator. Adds two matrices element-wise and returns a new matrix.
+     * @brief Returns the distance between the starts of consecutive rows, in elements. At least get_cols().
      *
-     * @param other The other matrix to add to the current matrix.
+     * The elements between the end of a row and the start of the next one are padding. They are zero
+     * initialized but carry no meaning and may be overwritten by element-wise operations.
      */
-    Matrix operator-(const Matrix &other) const;
+    int get_leading_dimension() const { return leading_dimension; }
 
     /**
-     *  @brief Overloads the multiplication operator to multiply a matrix by a scalar.
+     * @brief Returns the element at the specified row and column without bounds checks.
      *
-     * @param scalar The scalar to multiply with, have to be convertible to double.
+     * Debug builds assert that the index is valid, release builds compile this down to a single load. The non-const
+     * overload adds a check of the reference count for copy-on-write.
      */
-    template <typename T>
-    Matrix operator*(const T scalar) const
+    T &unchecked(int row, int col)
     {
+        assert(is_valid_index(row, col));
+        detach();
+        return storage[static_cast<std::ptrdiff_t>(row) * leading_dimension + col];
+    }
 
-        static_assert(std::is_convertible<T, double>::value,
-                      "Scalar type must be convertible to double.");
+    T unchecked(int row, int col) const
+    {
+        assert(is_valid_index(row, col));
+        return storage[static_cast<std::ptrdiff_t>(row) * leading_dimension + col];
+    }
+
+    /**
+     * @brief Returns the elements of a row as a contiguous span. Only checked in debug builds.
+     */
+    Span<T> row(int i)
+    {
+        assert(i >= 0 && i < rows);
+        detach();
+        return Span<T>(storage.get() + static_cast<std::ptrdiff_t>(i) * leading_dimension, cols);
+    }
+
+    Span<const T> row(int i) const
+    {
+        assert(i >= 0 && i < rows);
+        return Span<const T>(storage.get() + static_cast<std::ptrdiff_t>(i) * leading_dimension, cols);
+    }
+
+    /**
+     * @brief Returns the elements of a column as a strided span. Only checked in debug builds.
+     */
+    StridedSpan<T> column(int j)
+    {
+        assert(j >= 0 && j < cols);
+        detach();
+        return StridedSpan<T>(storage.get() + j, rows, leading_dimension);
+    }
 
-        Matrix result(rows, cols);
-        for (int i = 0; i < rows; i++)
+    StridedSpan<const T> column(int j) const
+    {
+        assert(j >= 0 && j < cols);
+        return StridedSpan<const T>(storage.get() + j, rows, leading_dimension);
+    }
+
+    /**
+     * @brief Evaluates an element-wise expression of matrices and views, e.g. a + b - c * 2, in a single pass.
+     *
+     * The operators +, - and scalar * are defined in MatrixExpression.hpp and only build the expression.
+     *
+     * @throws InvalidMatrixFormat If the shapes of the operands do not match, when the expression is built.
+     */
+    template <typename E>
+    BasicMatrix(const MatrixExpression<E> &expression) : BasicMatrix(expression.get_rows(), expression.get_cols(),
+                                                                     default_leading_dimension(expression.get_cols()), false)
+    {
+        static_assert(std::is_same<typename E::value_type, T>::value, "The expression has a different element type.");
+
+        evaluate_into(expression, storage.get(), leading_dimension);
+    }
+
+    /**
+     * @brief Evaluates an element-wise expression into this matrix.
+     *
+     * The existing storage is reused if the shape matches, no copy or view shares it and the expression does not
+     * read this matrix through a view, e.g. a = a + b * 2 allocates nothing. Otherwise the result is evaluated into
+     * new storage, shared storage is never copied just to be overwritten.
+     */
+    template <typename E>
+    BasicMatrix &operator=(const MatrixExpression<E> &expression)
+    {
+        std::size_t size = rows > 0 ? static_cast<std::size_t>(rows - 1) * leading_dimension + cols : 0;
+        if (expression.get_rows() != rows || expression.get_cols() != cols || storage.use_count() > 1 ||
+            expression.derived().may_alias(storage.get(), leading_dimension, size))
         {
-            for (int j = 0; j < cols; j++)
-            {
-                result(i, j) = get_element(i, j) * static_cast<double>(scalar);
-            }
+            return *this = BasicMatrix(expression);
         }
+
+        evaluate_into(expression, storage.get(), leading_dimension);
+        return *this;
+    }
+
+    /**
+     * @brief Adds a matrix, view or expression element-wise in place. Allocates nothing unless the storage is shared.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not match.
+     */
+    template <typename U>
+    BasicMatrix &operator+=(const U &other)
+    {
+        return *this = *this + other;
+    }
+
+    /**
+     * @brief Subtracts a matrix, view or expression element-wise in place.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not match.
+     */
+    template <typename U>
+    BasicMatrix &operator-=(const U &other)
+    {
+        return *this = *this - other;
+    }
+
+    /**
+     * @brief Multiplies every element by a scalar in place.
+     *
+     * @param scalar The scalar to multiply with, have to be convertible to double.
+     */
+    template <typename S>
+    BasicMatrix &operator*=(const S scalar)
+    {
+        static_assert(std::is_convertible<S, double>::value,
+                      "Scalar type must be convertible to double.");
+
+        return *this = *this * scalar;
     }
 
     /**
@@ -155,7 +335,7 @@ public:
      *
      * @throws std::out_of_range If the specified column or row index is out of bounds.
      */
-    void set_element(int row, int col, double val);
+    void set_element(int row, int col, T val);
 
     /**
      * @brief Retrieves the value of an element in the matrix at the specified column and row.
@@ -167,7 +347,7 @@ public:
      *
      * @throws std::out_of_range If the specified column or row index is out of bounds.
      */
-    double get_element(int row, int col) const;
+    T get_element(int row, int col) const;
 
     void display() const;
     int get_rows() const;
@@ -175,9 +355,38 @@ public:
 
 private:
     int rows, cols;
-    std::shared_ptr<double[]> data;
+    int leading_dimension;
+    std::shared_ptr<T[]> storage;
+
+    BasicMatrix(int r, int c, int leading_dimension, bool zero_initialize);
+
+    /**
+     * @brief Gives the matrix storage of its own before a write, if copies or views share the current one.
+     */
+    void detach()
+    {
+        if (storage.use_count() > 1)
+        {
+            clone_storage(true);
+        }
+    }
+
+    /**
+     * @brief Replaces the storage with a new buffer of the same shape, holding a copy of the elements if keep_contents is set.
+     */
+    void clone_storage(bool keep_contents);
 
     bool is_valid_index(int row, int col) const;
 
-    friend class MatrixView;
-};
\ No newline at end of file
+    friend class BasicMatrixView<T>;
+    friend class MatrixOperator;
+};
+
+using Matrix = BasicMatrix<double>;
+using FloatMatrix = BasicMatrix<float>;
+
+template <typename T>
+MatrixOperand<T>::MatrixOperand(const BasicMatrix<T> &matrix) : first(matrix.data()),
+                                                                rows(matrix.get_rows()),
+                                                                cols(matrix.get_cols()),
+                                                                row_stride(matrix.get_leading_dimension()) {}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @struct MatrixAllocatorStats
+ * @brief Counters of a MatrixAllocator.
+ */
+struct MatrixAllocatorStats
+{
+    /**
+     * @brief Allocations served from a cache without going to the heap.
+     */
+    std::size_t hits = 0;
+
+    /**
+     * @brief Allocations that went to the heap.
+     */
+    std::size_t misses = 0;
+
+    /**
+     * @brief Bytes of freed buffers the allocator keeps for reuse.
+     */
+    std::size_t bytes_held = 0;
+};
+
+/**
+ * @class MatrixAllocator
+ * @brief Interface for the allocator that provides the storage of Matrix objects and other matrix buffers.
+ *
+ * Buffers are aligned to ALIGNMENT bytes and not initialized. Every buffer remembers the allocator it came
+ * from, so the default allocator can be replaced at any time, but an allocator must outlive its buffers.
+ *
+ * Example usage:
+ * @code
+ * HeapMatrixAllocator heap;
+ * MatrixAllocator::set_default(&heap);
+ * ...
+ * MatrixAllocator::set_default(nullptr); // Back to the pool
+ * @endcode
+ */
+class MatrixAllocator
+{
+public:
+    /**
+     * @brief Alignment in bytes of every buffer. Matches a cache line and an AVX-512 register.
+     */
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    virtual ~MatrixAllocator() = default;
+
+    /**
+     * @brief Returns an uninitialized buffer of count doubles aligned to ALIGNMENT bytes.
+     *
+     * @throws std::bad_alloc If the memory can not be allocated.
+     */
+    virtual double *allocate(std::size_t count) = 0;
+
+    /**
+     * @brief Releases a buffer returned by allocate(count) of this allocator.
+     */
+    virtual void deallocate(double *buffer, std::size_t count) = 0;
+
+    virtual MatrixAllocatorStats get_stats() const = 0;
+
+    /**
+     * @brief Allocates a buffer of count elements that is handed back to this allocator when the last owner drops it.
+     *
+     * Buffers of other element types than double are carved from a double buffer of at least the same size.
+     */
+    template <typename T = double>
+    std::shared_ptr<T[]> allocate_shared(std::size_t count)
+    {
+        std::size_t doubles = (count * sizeof(T) + sizeof(double) - 1) / sizeof(double);
+        std::shared_ptr<double[]> buffer(allocate(doubles), [this, doubles](double *memory)
+                                         { deallocate(memory, doubles); });
+        return std::shared_ptr<T[]>(buffer, reinterpret_cast<T *>(buffer.get()));
+    }
+
+    /**
+     * @brief Returns the allocator new matrices take their storage from. A process wide PooledMatrixAllocator unless replaced.
+     */
+    static MatrixAllocator &get_default();
+
+    /**
+     * @brief Replaces the default allocator. nullptr restores the process wide pool.
+     */
+    static void set_default(MatrixAllocator *allocator);
+};
+
+/**
+ * @class HeapMatrixAllocator
+ * @brief Allocates every buffer from the heap and frees it right away. Every allocation counts as a miss.
+ */
+class HeapMatrixAllocator : public MatrixAllocator
+{
+public:
+    double *allocate(std::size_t count) override;
+    void deallocate(double *buffer, std::size_t count) override;
+    MatrixAllocatorStats get_stats() const override;
+
+private:
+    std::atomic<std::size_t> misses{0};
+};
+
+/**
+ * @class PooledMatrixAllocator
+ * @brief Recycles freed buffers by size class, with a free list per thread in front of a shared one.
+ *
+ * Requests are rounded up to a multiple of 64 bytes up to 256 bytes and to one of four size classes per
+ * power of two beyond that, which wastes at most a fifth of a larger buffer. A freed buffer goes to the free
+ * list of the freeing thread while that holds less than thread_cache_bytes, then to the shared free list
+ * while that holds less than shared_cache_bytes, and otherwise back to the heap. Allocations look in the same
+ * order, so a loop that creates and drops matrices of the same shape touches neither a lock nor the heap
+ * after its first iteration.
+ *
+ * A thread's free list is released into the shared list when the thread exits. Buffers larger than the
+ * biggest size class bypass the pool.
+ */
+class PooledMatrixAllocator : public MatrixAllocator
+{
+public:
+    /**
+     * @param thread_cache_bytes The most a thread keeps for itself.
+     * @param shared_cache_bytes The most the shared free list keeps.
+     */
+    explicit PooledMatrixAllocator(std::size_t thread_cache_bytes = std::size_t(32) << 20,
+                                   std::size_t shared_cache_bytes = std::size_t(256) << 20);
+    ~PooledMatrixAllocator() override;
+
+    PooledMatrixAllocator(const PooledMatrixAllocator &) = delete;
+    PooledMatrixAllocator &operator=(const PooledMatrixAllocator &) = delete;
+
+    double *allocate(std::size_t count) override;
+    void deallocate(double *buffer, std::size_t count) override;
+    MatrixAllocatorStats get_stats() const override;
+
+    /**
+     * @brief Returns the cached buffers of the shared free list and of the calling thread to the heap.
+     */
+    void release_cached();
+
+    /**
+     * @brief Returns the number of bytes a request for count doubles occupies, the size of its size class.
+     */
+    static std::size_t rounded_size(std::size_t count);
+
+    /**
+     * @brief The free lists and counters, shared with the per-thread caches. Defined in the source file.
+     */
+    struct Pool;
+
+private:
+    std::shared_ptr<Pool> pool;
+};
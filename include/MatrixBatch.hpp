@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixView.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+class MatrixOperator;
+
+/**
+ * @class BasicMatrixBatch
+ * @brief A batch of equally shaped float or double matrices in one contiguous buffer. MatrixBatch and FloatMatrixBatch name the two.
+ *
+ * The matrices are stored one after the other, each row-major with rows get_cols() elements apart. Every
+ * matrix starts get_stride() elements after the previous one, on a cache line boundary. A strided batch is
+ * what MatrixOperator::gemm_batched() works on: one allocation for thousands of small matrices, and no
+ * per-matrix bookkeeping.
+ *
+ * Like Matrix, a batch has copy-on-write storage. Copies and views share the elements until the first write
+ * through a batch whose storage is shared, which gives that batch a private copy.
+ *
+ * Example usage:
+ * @code
+ * MatrixBatch a(1000, 16, 16);
+ * MatrixBatch b(1000, 16, 16);
+ * a(0, 1, 2) = 3.0; // Element (1, 2) of matrix 0
+ * MatrixBatch c = mat_operator.matmul_batched(a, b);
+ * Matrix first = c.get_matrix(0);
+ * @endcode
+ */
+template <typename T>
+class BasicMatrixBatch
+{
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                  "Matrix elements are float or double.");
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs a batch of count zero-initialized rows x cols matrices.
+     *
+     * @throws std::invalid_argument If count, rows or cols is negative.
+     */
+    BasicMatrixBatch(int count, int rows, int cols);
+
+    /**
+     * @brief Constructs a batch whose elements are left uninitialized, for results that overwrite every element.
+     */
+    static BasicMatrixBatch uninitialized(int count, int rows, int cols);
+
+    int get_count() const;
+    int get_rows() const;
+    int get_cols() const;
+
+    /**
+     * @brief Returns the distance between the first elements of consecutive matrices, at least rows * cols.
+     */
+    std::size_t get_stride() const;
+
+    /**
+     * @brief Returns a pointer to the first element of matrix index. The non-const overload first gives the batch storage of its own.
+     *
+     * @throws std::out_of_range If index is not in [0, get_count()).
+     */
+    T *data(int index);
+    const T *data(int index) const;
+
+    /**
+     * @brief Returns element (row, col) of matrix index.
+     *
+     * @throws std::out_of_range If any of the indices is out of bounds.
+     */
+    T &operator()(int index, int row, int col);
+    const T &operator()(int index, int row, int col) const;
+
+    /**
+     * @brief Returns a view of matrix index. It shares the storage and keeps its elements if the batch is written afterwards.
+     *
+     * @throws std::out_of_range If index is not in [0, get_count()).
+     */
+    BasicMatrixView<T> view(int index) const;
+
+    /**
+     * @brief Copies matrix index into a new Matrix.
+     *
+     * @throws std::out_of_range If index is not in [0, get_count()).
+     */
+    BasicMatrix<T> get_matrix(int index) const;
+
+    /**
+     * @brief Overwrites matrix index with the elements of a view of any layout.
+     *
+     * @throws std::out_of_range If index is not in [0, get_count()).
+     * @throws InvalidMatrixFormat If the view is not get_rows() x get_cols().
+     */
+    void set_matrix(int index, const BasicMatrixView<T> &matrix);
+
+private:
+    int count, rows, cols;
+    std::size_t stride;
+    std::shared_ptr<T[]> storage;
+
+    BasicMatrixBatch(int count, int rows, int cols, bool zero_initialize);
+
+    /**
+     * @brief Gives the batch storage of its own before a write, if copies or views share the current one.
+     */
+    void detach()
+    {
+        if (storage.use_count() > 1)
+        {
+            clone_storage(true);
+        }
+    }
+
+    void clone_storage(bool keep_contents);
+
+    void check_index(int index) const;
+
+    friend class MatrixOperator;
+};
+
+using MatrixBatch = BasicMatrixBatch<double>;
+using FloatMatrixBatch = BasicMatrixBatch<float>;
@@ -0,0 +1,392 @@
+#pragma once
+
+#include "../include/InvalidMatrixFormat.hpp"
+#include "../include/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+// Forward declarations, the operands are built from these.
+template <typename T>
+class BasicMatrix;
+template <typename T>
+class BasicMatrixView;
+
+/**
+ * @class MatrixExpression
+ * @brief Base of the lazy element-wise expressions built by +, - and scalar * on matrices and views.
+ *
+ * An expression only records its operands. Nothing is computed until it is assigned to a Matrix or
+ * written out with evaluate_into(), which then makes a single pass over the operands: each row is
+ * processed in strips of STRIP elements, every node of the tree is applied to the strip with the
+ * SIMD kernels while it is still in L1, and only the final strip is written to memory. An N-term
+ * expression therefore reads every operand once and writes the result once, instead of allocating
+ * and streaming through N - 1 temporaries.
+ *
+ * Operands are held by pointer, so an expression must not outlive the matrices and views it was built
+ * from. Store it in a Matrix rather than in an auto variable. All operands of an expression have the same
+ * element type, its value_type; mixing float and double operands does not compile.
+ *
+ * Example usage:
+ * @code
+ * Matrix d = a + b - c * 0.5;
+ * d = d + a;
+ * @endcode
+ *
+ * Every node type E provides, besides get_rows(), get_cols() and value_type:
+ * - element(row, col), a single element;
+ * - strip(row, col, count, scratch), a pointer to count consecutive elements of a row, which either
+ *   points into an operand or into the first of the TEMPORARIES strips at scratch;
+ * - evaluate_into(row, col, count, out, scratch), the same elements written to out;
+ * - may_alias(out, out_row_stride, out_size), whether writing the result to out could overwrite an
+ *   element of an operand before it has been read.
+ */
+template <typename E>
+class MatrixExpression
+{
+public:
+    /**
+     * @brief The number of elements of a row that are evaluated together. 2 KiB per temporary strip of doubles.
+     */
+    static constexpr int STRIP = 256;
+
+    const E &derived() const { return static_cast<const E &>(*this); }
+
+    int get_rows() const { return derived().get_rows(); }
+    int get_cols() const { return derived().get_cols(); }
+
+    /**
+     * @brief Evaluates a single element. Prefer assigning the whole expression to a Matrix.
+     */
+    auto operator()(int row, int col) const { return derived().element(row, col); }
+};
+
+/**
+ * @class MatrixOperand
+ * @brief A leaf of an expression that reads the row-major storage of a Matrix.
+ */
+template <typename T>
+class MatrixOperand : public MatrixExpression<MatrixOperand<T>>
+{
+public:
+    using value_type = T;
+
+    static constexpr int TEMPORARIES = 0;
+
+    explicit MatrixOperand(const BasicMatrix<T> &matrix);
+
+    int get_rows() const { return rows; }
+    int get_cols() const { return cols; }
+
+    T element(int row, int col) const { return first[static_cast<std::ptrdiff_t>(row) * row_stride + col]; }
+
+    const T *strip(int row, int col, int, T *) const
+    {
+        return first + static_cast<std::ptrdiff_t>(row) * row_stride + col;
+    }
+
+    void evaluate_into(int row, int col, int count, T *out, T *scratch) const
+    {
+        const T *values = strip(row, col, count, scratch);
+        if (values != out)
+        {
+            std::copy(values, values + count, out);
+        }
+    }
+
+    /**
+     * Reading and writing the same element at the same position is safe, anything else that overlaps is not.
+     */
+    bool may_alias(const T *out, int out_row_stride, std::size_t out_size) const
+    {
+        if (first == out && row_stride == out_row_stride)
+        {
+            return false;
+        }
+
+        const T *last = first + (rows > 0 ? static_cast<std::size_t>(rows - 1) * row_stride + cols : 0);
+        return first < out + out_size && out < last;
+    }
+
+private:
+    const T *first;
+    int rows, cols;
+    int row_stride;
+};
+
+/**
+ * @class MatrixViewOperand
+ * @brief A leaf of an expression that reads a MatrixView, honouring its strides and padding.
+ *
+ * Rows with unit column stride are read in place. Other layouts, and strips that reach into the padding,
+ * are gathered into a temporary strip first.
+ */
+template <typename T>
+class MatrixViewOperand : public MatrixExpression<MatrixViewOperand<T>>
+{
+public:
+    using value_type = T;
+
+    static constexpr int TEMPORARIES = 1;
+
+    explicit MatrixViewOperand(const BasicMatrixView<T> &view);
+
+    int get_rows() const { return rows; }
+    int get_cols() const { return cols; }
+
+    T element(int row, int col) const
+    {
+        return row < data_rows && col < data_cols
+                   ? origin[static_cast<std::ptrdiff_t>(row) * row_stride + static_cast<std::ptrdiff_t>(col) * col_stride]
+                   : T(0);
+    }
+
+    const T *strip(int row, int col, int count, T *scratch) const
+    {
+        if (col_stride == 1 && row < data_rows && col + count <= data_cols)
+        {
+            return origin + static_cast<std::ptrdiff_t>(row) * row_stride + col;
+        }
+
+        evaluate_into(row, col, count, scratch, scratch);
+        return scratch;
+    }
+
+    void evaluate_into(int row, int col, int count, T *out, T *) const
+    {
+        int stored = row < data_rows ? std::clamp(data_cols - col, 0, count) : 0;
+        const T *values = origin + static_cast<std::ptrdiff_t>(row) * row_stride + static_cast<std::ptrdiff_t>(col) * col_stride;
+        for (int j = 0; j < stored; j++)
+        {
+            out[j] = values[static_cast<std::ptrdiff_t>(j) * col_stride];
+        }
+        std::fill(out + stored, out + count, T(0));
+    }
+
+    /**
+     * Views may be transposed or shifted relative to the destination, so any overlap counts.
+     */
+    bool may_alias(const T *out, int, std::size_t out_size) const
+    {
+        if (data_rows == 0 || data_cols == 0)
+        {
+            return false;
+        }
+
+        std::ptrdiff_t row_span = static_cast<std::ptrdiff_t>(data_rows - 1) * row_stride;
+        std::ptrdiff_t col_span = static_cast<std::ptrdiff_t>(data_cols - 1) * col_stride;
+        const T *first = origin + std::min<std::ptrdiff_t>(row_span, 0) + std::min<std::ptrdiff_t>(col_span, 0);
+        const T *last = origin + std::max<std::ptrdiff_t>(row_span, 0) + std::max<std::ptrdiff_t>(col_span, 0) + 1;
+        return first < out + out_size && out < last;
+    }
+
+private:
+    const T *origin;
+    int rows, cols;
+    int row_stride, col_stride;
+    int data_rows, data_cols;
+};
+
+/**
+ * @brief The element-wise operations an ElementwiseMatrixExpression can apply.
+ */
+enum class ElementwiseOperation
+{
+    Add,
+    Subtract
+};
+
+/**
+ * @class ElementwiseMatrixExpression
+ * @brief The element-wise sum or difference of two expressions of the same shape.
+ *
+ * The left operand is evaluated into the first TEMPORARIES of the left subtree, the right operand into the
+ * strips after those, and the result into the first strip. Every strip starts at the same column, so a
+ * result strip can only coincide exactly with an operand strip, which the element-wise kernels allow.
+ */
+template <typename L, typename R, ElementwiseOperation Operation>
+class ElementwiseMatrixExpression : public MatrixExpression<ElementwiseMatrixExpression<L, R, Operation>>
+{
+    static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                  "Both operands of an element-wise operation must have the same element type.");
+
+public:
+    using value_type = typename L::value_type;
+
+    static constexpr int TEMPORARIES = std::max(1, L::TEMPORARIES + R::TEMPORARIES);
+
+    /**
+     * @throws InvalidMatrixFormat If the operands do not have the same shape.
+     */
+    ElementwiseMatrixExpression(const L &left, const R &right) : left(left), right(right)
+    {
+        if (left.get_rows() != right.get_rows() || left.get_cols() != right.get_cols())
+        {
+            throw InvalidMatrixFormat(Operation == ElementwiseOperation::Add
+                                          ? "Invalid format for matrix addition. Number of rows and number of columns must match."
+                                          : "Invalid format for matrix subtraction. Number of rows and number of columns must match.");
+        }
+    }
+
+    int get_rows() const { return left.get_rows(); }
+    int get_cols() const { return left.get_cols(); }
+
+    value_type element(int row, int col) const
+    {
+        return Operation == ElementwiseOperation::Add ? left.element(row, col) + right.element(row, col)
+                                                      : left.element(row, col) - right.element(row, col);
+    }
+
+    const value_type *strip(int row, int col, int count, value_type *scratch) const
+    {
+        evaluate_into(row, col, count, scratch, scratch);
+        return scratch;
+    }
+
+    void evaluate_into(int row, int col, int count, value_type *out, value_type *scratch) const
+    {
+        const value_type *x = left.strip(row, col, count, scratch);
+        const value_type *y = right.strip(row, col, count, scratch + L::TEMPORARIES * MatrixExpression<L>::STRIP);
+
+        const SimdKernelTable<value_type> &kernels = SimdKernels::get<value_type>();
+        if (Operation == ElementwiseOperation::Add)
+        {
+            kernels.add(x, y, out, count);
+        }
+        else
+        {
+            kernels.subtract(x, y, out, count);
+        }
+    }
+
+    bool may_alias(const value_type *out, int out_row_stride, std::size_t out_size) const
+    {
+        return left.may_alias(out, out_row_stride, out_size) || right.may_alias(out, out_row_stride, out_size);
+    }
+
+private:
+    L left;
+    R right;
+};
+
+/**
+ * @class ScaledMatrixExpression
+ * @brief An expression multiplied element-wise by a scalar.
+ */
+template <typename E>
+class ScaledMatrixExpression : public MatrixExpression<ScaledMatrixExpression<E>>
+{
+public:
+    using value_type = typename E::value_type;
+
+    static constexpr int TEMPORARIES = std::max(1, E::TEMPORARIES);
+
+    ScaledMatrixExpression(const E &operand, value_type scalar) : operand(operand), scalar(scalar) {}
+
+    int get_rows() const { return operand.get_rows(); }
+    int get_cols() const { return operand.get_cols(); }
+
+    value_type element(int row, int col) const { return operand.element(row, col) * scalar; }
+
+    const value_type *strip(int row, int col, int count, value_type *scratch) const
+    {
+        evaluate_into(row, col, count, scratch, scratch);
+        return scratch;
+    }
+
+    void evaluate_into(int row, int col, int count, value_type *out, value_type *scratch) const
+    {
+        SimdKernels::get<value_type>().scale(operand.strip(row, col, count, scratch), scalar, out, count);
+    }
+
+    bool may_alias(const value_type *out, int out_row_stride, std::size_t out_size) const
+    {
+        return operand.may_alias(out, out_row_stride, out_size);
+    }
+
+private:
+    E operand;
+    value_type scalar;
+};
+
+/**
+ * @brief Maps a type that can appear in an expression to the node that reads it. Other types have no node.
+ */
+template <typename T, typename = void>
+struct MatrixExpressionNode
+{
+};
+
+template <typename T>
+struct MatrixExpressionNode<BasicMatrix<T>>
+{
+    using type = MatrixOperand<T>;
+};
+
+template <typename T>
+struct MatrixExpressionNode<T, std::enable_if_t<std::is_base_of<BasicMatrixView<typename T::value_type>, T>::value>>
+{
+    using type = MatrixViewOperand<typename T::value_type>;
+};
+
+template <typename T>
+struct MatrixExpressionNode<T, std::enable_if_t<std::is_base_of<MatrixExpression<T>, T>::value>>
+{
+    using type = T;
+};
+
+template <typename T>
+using MatrixExpressionNodeOf = typename MatrixExpressionNode<std::decay_t<T>>::type;
+
+/**
+ * @brief Writes an expression to a row-major destination whose rows are out_row_stride elements apart.
+ *
+ * The destination must not overlap the operands in any other way than an operand element being
+ * overwritten by the result at the same position, see may_alias().
+ */
+template <typename E>
+void evaluate_into(const MatrixExpression<E> &expression, typename E::value_type *out, int out_row_stride)
+{
+    using value_type = typename E::value_type;
+    constexpr int STRIP = MatrixExpression<E>::STRIP;
+    alignas(64) value_type scratch[std::max(1, E::TEMPORARIES) * STRIP];
+
+    const E &node = expression.derived();
+    int rows = node.get_rows();
+    int cols = node.get_cols();
+    for (int i = 0; i < rows; i++)
+    {
+        value_type *out_row = out + static_cast<std::ptrdiff_t>(i) * out_row_stride;
+        for (int j = 0; j < cols; j += STRIP)
+        {
+            node.evaluate_into(i, j, std::min(STRIP, cols - j), out_row + j, scratch);
+        }
+    }
+}
+
+template <typename L, typename R>
+ElementwiseMatrixExpression<MatrixExpressionNodeOf<L>, MatrixExpressionNodeOf<R>, ElementwiseOperation::Add>
+operator+(const L &left, const R &right)
+{
+    return {MatrixExpressionNodeOf<L>(left), MatrixExpressionNodeOf<R>(right)};
+}
+
+template <typename L, typename R>
+ElementwiseMatrixExpression<MatrixExpressionNodeOf<L>, MatrixExpressionNodeOf<R>, ElementwiseOperation::Subtract>
+operator-(const L &left, const R &right)
+{
+    return {MatrixExpressionNodeOf<L>(left), MatrixExpressionNodeOf<R>(right)};
+}
+
+/**
+ * @brief Multiplies a matrix, view or expression by a scalar, which has to be convertible to double.
+ *
+ * The scalar is converted to the element type of the operand.
+ */
+template <typename E, typename T, typename = std::enable_if_t<std::is_convertible<T, double>::value>>
+ScaledMatrixExpression<MatrixExpressionNodeOf<E>> operator*(const E &operand, const T scalar)
+{
+    using value_type = typename MatrixExpressionNodeOf<E>::value_type;
+    return {MatrixExpressionNodeOf<E>(operand), static_cast<value_type>(scalar)};
+}
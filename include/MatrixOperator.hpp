@@ -1,12 +1,109 @@
 #pragma once
 
 #include "./Matrix.hpp"
+#include "./MatrixBatch.hpp"
+#include "./QuantizedMatrix.hpp"
+#include "./SparseMatrix.hpp"
+#include "./Vector.hpp"
+#include "./GemmKernel.hpp"
+#include "./TransposeKernel.hpp"
+#include "./SparseKernel.hpp"
+#include "./VectorKernel.hpp"
+#include "./ThreadPool.hpp"
+#include "./StrassenThresholds.hpp"
+#include "./StrassenWorkspace.hpp"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class MatrixOperator
+ * @brief Matrix arithmetic on float and double matrices, optionally on a thread pool.
+ *
+ * Every operation is a member template on the element type, compiled for float and double in MatrixOperator.cpp.
+ * Both operands of an operation have the same element type, alpha and beta are given as double either way.
+ * The mixed precision products are the exception: matmul_mixed() accumulates float operands in double and
+ * matmul_quantized() accumulates int8 operands in int32.
+ *
+ * Matrix-vector work takes a Vector and goes through gemv(), ger(), dot() and axpy(), which stream the matrix once
+ * with the kernels of VectorKernel instead of treating the vector as an n x 1 matrix product. Sparse matrices are
+ * multiplied with dense vectors and matrices by spmv() and spmm(), see SparseKernel.
+ *
+ * Example usage:
+ * @code
+ * MatrixOperator mat_operator(8);
+ * Matrix c = mat_operator.matmul(a, b);
+ * FloatMatrix d = mat_operator.matmul(e.transpose_view(), f.view());
+ * Matrix g = mat_operator.matmul_mixed(e, f);
+ * Vector y = mat_operator.gemv(a.transpose_view(), x);
+ * Vector z = mat_operator.spmv(sparse, y);
+ * @endcode
+ */
 class MatrixOperator
 {
 public:
     MatrixOperator() {}
 
+    /**
+     * @brief Constructs a MatrixOperator that runs large products on the given thread pool.
+     *
+     * @param pool The pool to schedule work on. It must outlive the MatrixOperator.
+     */
+    explicit MatrixOperator(ThreadPool &pool);
+
+    /**
+     * @brief Constructs a MatrixOperator that owns a work-stealing thread pool with the given number of workers.
+     *
+     * @param thread_count The number of worker threads. Zero gives a serial MatrixOperator.
+     */
+    explicit MatrixOperator(size_t thread_count);
+
+    /**
+     * @brief Returns the number of threads products are computed on, 1 when running serially.
+     */
+    size_t get_thread_count() const;
+
+    /**
+     * @brief Sets the amount of work below which products are computed serially.
+     *
+     * The work of a product is measured as m * n * k. Below the threshold the cost of scheduling
+     * tiles on the pool outweighs the gain from running them in parallel.
+     *
+     * @param min_work The smallest m * n * k that is computed in parallel.
+     */
+    void set_parallel_threshold(long long min_work);
+
+    long long get_parallel_threshold() const;
+
+    /**
+     * @brief Sets how many levels of the Strassen recursion run their seven sub-products as concurrent tasks.
+     *
+     * Below that depth the recursion continues serially inside each task. Has no effect without a thread pool.
+     *
+     * @param depth The number of parallel recursion levels, 0 for a fully serial recursion.
+     *
+     * @throws std::invalid_argument If depth is negative.
+     */
+    void set_strassen_parallel_depth(int depth);
+
+    int get_strassen_parallel_depth() const;
+
+    /**
+     * @brief Sets the crossover sizes between Strassen's algorithm and the blocked GEMM kernel.
+     *
+     * New MatrixOperator objects start with StrassenThresholds::startup_defaults(), which reads the
+     * config file written by the autotuner if there is one.
+     *
+     * @param thresholds The thresholds to use.
+     *
+     * @throws std::invalid_argument If a threshold is negative.
+     */
+    void set_strassen_thresholds(const StrassenThresholds &thresholds);
+
+    const StrassenThresholds &get_strassen_thresholds() const;
+
     /**
      * @brief Adds two matrices element-wise.
      *
@@ -22,9 +119,269 @@ public:
      *
      * @note The input matrices must have the same dimensions.
      */
-    Matrix add(const Matrix &m1, const Matrix &m2) const;
+    template <typename T>
+    BasicMatrix<T> add(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const;
+
+    /**
+     * @brief Multiplies two matrices.
+     *
+     * Products where every dimension is larger than the Strassen threshold for their shape are computed with
+     * Strassen's algorithm, everything else goes straight to the cache-blocked GEMM kernel.
+     *
+     * @param m1 The left-hand matrix.
+     * @param m2 The right-hand matrix.
+     *
+     * @return The matrix product m1 * m2.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in m1 does not match the number of rows in m2.
+     */
+    template <typename T>
+    BasicMatrix<T> matmul(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const;
+
+    /**
+     * @brief Multiplies two matrices, taking Strassen's scratch memory from the given workspace.
+     *
+     * The workspace grows to the size the product needs and is reused as is when it is already large enough,
+     * so repeated products of similar size allocate their scratch memory only once.
+     *
+     * @param m1 The left-hand matrix.
+     * @param m2 The right-hand matrix.
+     * @param workspace The workspace to carve Strassen's temporaries from.
+     *
+     * @return The matrix product m1 * m2.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in m1 does not match the number of rows in m2.
+     */
+    template <typename T>
+    BasicMatrix<T> matmul(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2, StrassenWorkspace &workspace) const;
+
+    /**
+     * @brief Multiplies two views, reading transposed operands in place.
+     *
+     * Pass transpose_view() for a transposed operand and view() for a plain one, e.g. matmul(a.transpose_view(), b.view())
+     * for A^T * B. The GEMM kernel packs transposed operands straight from their storage, so NT, TN and TT products cost
+     * the same as NN ones. Above the Strassen threshold a transposed operand is first transposed into the workspace, and
+     * padded views are always copied there.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in m1 does not match the number of rows in m2.
+     */
+    template <typename T>
+    BasicMatrix<T> matmul(const BasicMatrixView<T> &m1, const BasicMatrixView<T> &m2) const;
+
+    /**
+     * @brief Multiplies two views, taking scratch memory from the given workspace.
+     */
+    template <typename T>
+    BasicMatrix<T> matmul(const BasicMatrixView<T> &m1, const BasicMatrixView<T> &m2, StrassenWorkspace &workspace) const;
+
+    /**
+     * @brief Computes C = alpha * A * B + beta * C into the caller's matrix, like BLAS dgemm.
+     *
+     * C keeps its storage. With beta = 0 the previous contents of C are ignored, so they may be uninitialized or NaN.
+     * Products below the Strassen threshold for their shape are accumulated straight into C by the GEMM kernel. Larger
+     * ones are computed with Strassen's algorithm, which needs an m x n block of workspace for the product unless beta is 0.
+     *
+     * @param alpha The factor of the product.
+     * @param a The m x k left-hand matrix.
+     * @param b The k x n right-hand matrix.
+     * @param beta The factor of the previous contents of C.
+     * @param c The m x n output matrix.
+     *
+     * c may also be a or b, or share storage with them: it gets storage of its own and the operands keep their elements.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    template <typename T>
+    void gemm(double alpha, const BasicMatrix<T> &a, const BasicMatrix<T> &b, double beta, BasicMatrix<T> &c) const;
+
+    /**
+     * @brief Computes C = alpha * A * B + beta * C, taking Strassen's scratch memory from the given workspace.
+     *
+     * Once the workspace has grown to the size the product needs, repeated calls allocate nothing on the serial path.
+     * The parallel paths only allocate the thread pool's task bookkeeping.
+     */
+    template <typename T>
+    void gemm(double alpha, const BasicMatrix<T> &a, const BasicMatrix<T> &b, double beta, BasicMatrix<T> &c, StrassenWorkspace &workspace) const;
+
+    /**
+     * @brief Computes C = alpha * A * B + beta * C for views, e.g. C += A^T * B with gemm(1, a.transpose_view(), b.view(), 1, c).
+     *
+     * Transposed operands are handled as in matmul(const MatrixView &, const MatrixView &). a and b may view c,
+     * they read the elements c had before the call.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    template <typename T>
+    void gemm(double alpha, const BasicMatrixView<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c) const;
+
+    template <typename T>
+    void gemm(double alpha, const BasicMatrixView<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c, StrassenWorkspace &workspace) const;
+
+    /**
+     * @brief Computes C[i] = alpha * A[i] * B[i] + beta * C[i] for every matrix i of a strided batch.
+     *
+     * The batch is split over the thread pool by whole products, at least BATCH_GRAIN multiply-adds per task, and every
+     * product is computed serially by the GEMM kernel straight on the batch storage. Small products thus pay neither for
+     * Strassen's recursion, nor for tiling over the pool, nor for allocations. c may share storage with a or b, it then
+     * gets storage of its own.
+     *
+     * @throws InvalidMatrixFormat If the batches differ in size or the shapes do not fit together.
+     */
+    template <typename T>
+    void gemm_batched(double alpha, const BasicMatrixBatch<T> &a, const BasicMatrixBatch<T> &b, double beta, BasicMatrixBatch<T> &c) const;
+
+    /**
+     * @brief Multiplies the matrices of two strided batches pairwise.
+     *
+     * @throws InvalidMatrixFormat If the batches differ in size or the shapes do not fit together.
+     */
+    template <typename T>
+    BasicMatrixBatch<T> matmul_batched(const BasicMatrixBatch<T> &a, const BasicMatrixBatch<T> &b) const;
+
+    /**
+     * @brief Multiplies a[i] * b[i] for every pair of views. The shapes may differ from one pair to the next.
+     *
+     * Transposed views are read in place and padded views are copied first. The products are spread over the pool
+     * like those of gemm_batched().
+     *
+     * @throws InvalidMatrixFormat If the vectors differ in length or the shapes of a pair do not fit together.
+     */
+    template <typename T>
+    std::vector<BasicMatrix<T>> matmul_batched(const std::vector<BasicMatrixView<T>> &a, const std::vector<BasicMatrixView<T>> &b) const;
+
+    /**
+     * @brief Multiplies two float matrices with double accumulation and returns the double product.
+     *
+     * The operands keep their float storage, half the memory traffic of double operands, and are widened to double
+     * while the GEMM kernel packs them, so every product and sum is computed by the double micro-kernel. The blocked
+     * kernel is used for every size, Strassen's algorithm would give away the accuracy this is for.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in m1 does not match the number of rows in m2.
+     */
+    Matrix matmul_mixed(const FloatMatrix &m1, const FloatMatrix &m2) const;
+
+    /**
+     * @brief Multiplies two float views with double accumulation, reading transposed operands in place.
+     */
+    Matrix matmul_mixed(const FloatMatrixView &m1, const FloatMatrixView &m2) const;
 
-    Matrix matmul(const Matrix &m1, const Matrix &m2) const;
+    /**
+     * @brief Computes C = alpha * A * B + beta * C for float A and B and double C, accumulating in double.
+     *
+     * Padded views are copied to float scratch memory first. With beta = 0 the previous contents of C are ignored.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    void gemm_mixed(double alpha, const FloatMatrixView &a, const FloatMatrixView &b, double beta, Matrix &c) const;
+
+    /**
+     * @brief Multiplies two int8 quantized matrices with int32 accumulation and returns the dequantized float product.
+     *
+     * Element (i, j) of the result is m1_scale(i) * m2_scale(j) times the int32 dot product of row i and column j, scaled
+     * by the micro-kernel as it is written, see GemmKernel::multiply_int8(). Quantize m1 with QuantizationAxis::PerRow and
+     * m2 with QuantizationAxis::PerColumn so that every element of the product has a single scale.
+     *
+     * @throws std::invalid_argument If m1 is not quantized per row or m2 is not quantized per column.
+     * @throws InvalidMatrixFormat If the number of columns in m1 does not match the number of rows in m2.
+     */
+    FloatMatrix matmul_quantized(const QuantizedMatrix &m1, const QuantizedMatrix &m2) const;
+
+    /**
+     * @brief Multiplies a matrix by a vector and returns A * x.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in a does not match the size of x.
+     */
+    template <typename T>
+    BasicVector<T> gemv(const BasicMatrix<T> &a, const BasicVector<T> &x) const;
+
+    /**
+     * @brief Multiplies a view by a vector, e.g. gemv(a.transpose_view(), x) for A^T * x without transposing A.
+     */
+    template <typename T>
+    BasicVector<T> gemv(const BasicMatrixView<T> &a, const BasicVector<T> &x) const;
+
+    /**
+     * @brief Computes y = alpha * A * x + beta * y into the caller's vector, like BLAS dgemv.
+     *
+     * A is read in place whatever its layout: plain views row by row, transposed views column by column. The padding of
+     * a padded view is known to be zero and is skipped. Runs on the thread pool when A has more than ELEMENTWISE_GRAIN
+     * elements. With beta = 0 the previous contents of y are ignored. y may share storage with x or a, it then gets
+     * storage of its own.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    template <typename T>
+    void gemv(double alpha, const BasicMatrixView<T> &a, const BasicVector<T> &x, double beta, BasicVector<T> &y) const;
+
+    /**
+     * @brief Computes the rank-1 update A += alpha * x * y^T in place.
+     *
+     * @throws InvalidMatrixFormat If a is not x.get_size() x y.get_size().
+     */
+    template <typename T>
+    void ger(double alpha, const BasicVector<T> &x, const BasicVector<T> &y, BasicMatrix<T> &a) const;
+
+    /**
+     * @brief Returns the dot product of two vectors.
+     *
+     * @throws InvalidMatrixFormat If the vectors differ in size.
+     */
+    template <typename T>
+    T dot(const BasicVector<T> &x, const BasicVector<T> &y) const;
+
+    /**
+     * @brief Computes y += alpha * x in place.
+     *
+     * @throws InvalidMatrixFormat If the vectors differ in size.
+     */
+    template <typename T>
+    void axpy(double alpha, const BasicVector<T> &x, BasicVector<T> &y) const;
+
+    /**
+     * @brief Multiplies a sparse matrix by a dense vector and returns A * x.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in a does not match the size of x.
+     */
+    template <typename T>
+    BasicVector<T> spmv(const BasicSparseMatrix<T> &a, const BasicVector<T> &x) const;
+
+    /**
+     * @brief Computes y = alpha * A * x + beta * y for a sparse A in either format.
+     *
+     * CSR matrices are multiplied row by row, CSC matrices, such as the transpose() of a CSR matrix, column by column.
+     * Runs on the thread pool, split by nonzeros, when A has more than ELEMENTWISE_GRAIN of them. With beta = 0 the
+     * previous contents of y are ignored. y may share storage with x, it then gets storage of its own.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    template <typename T>
+    void spmv(double alpha, const BasicSparseMatrix<T> &a, const BasicVector<T> &x, double beta, BasicVector<T> &y) const;
+
+    /**
+     * @brief Multiplies a sparse matrix by a dense matrix and returns the dense product A * B.
+     *
+     * @throws InvalidMatrixFormat If the number of columns in a does not match the number of rows in b.
+     */
+    template <typename T>
+    BasicMatrix<T> spmm(const BasicSparseMatrix<T> &a, const BasicMatrix<T> &b) const;
+
+    /**
+     * @brief Multiplies a sparse matrix by a dense view, e.g. spmm(a, b.transpose_view()) for A * B^T.
+     */
+    template <typename T>
+    BasicMatrix<T> spmm(const BasicSparseMatrix<T> &a, const BasicMatrixView<T> &b) const;
+
+    /**
+     * @brief Computes C = alpha * A * B + beta * C for a sparse A and dense B and C.
+     *
+     * B is read in place when its rows are contiguous, transposed and padded views are copied to scratch memory first.
+     * A dense times sparse product D * S is the transpose of spmm(s.transpose(), d.transpose_view()). With beta = 0 the
+     * previous contents of C are ignored. b may view c, it reads the elements c had before the call.
+     *
+     * @throws InvalidMatrixFormat If the shapes do not fit together.
+     */
+    template <typename T>
+    void spmm(double alpha, const BasicSparseMatrix<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c) const;
 
     /**
      * @brief Calculates the Hadamard product of two matrices.
@@ -41,45 +398,110 @@ public:
      *
      * @note The Hadamard product is only defined for matrices of the same dimensions.
      */
-    double hadamard_product(const Matrix &m1, const Matrix &m2) const;
+    template <typename T>
+    T hadamard_product(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const;
 
-    MatrixView merge_top_bottom(const MatrixView &m1_view, const MatrixView &m2_view) const;
+    /**
+     * @brief Returns the transpose of a matrix, computed on the thread pool when there is one and the matrix is large enough.
+     */
+    template <typename T>
+    BasicMatrix<T> transpose(const BasicMatrix<T> &m) const;
 
-    MatrixView merge_side_to_side(const MatrixView &m1_view, const MatrixView &m2_view) const;
+    /**
+     * @brief Transposes a square matrix in place, on the thread pool when there is one and the matrix is large enough.
+     *
+     * @throws InvalidMatrixFormat If the matrix is not square.
+     */
+    template <typename T>
+    void transpose_in_place(BasicMatrix<T> &m) const;
+
+    template <typename T>
+    BasicMatrixView<T> merge_top_bottom(const BasicMatrixView<T> &m1_view, const BasicMatrixView<T> &m2_view) const;
+
+    template <typename T>
+    BasicMatrixView<T> merge_side_to_side(const BasicMatrixView<T> &m1_view, const BasicMatrixView<T> &m2_view) const;
 
 private:
-    const int STRASSEN_THRESHOLD = 0;
+    StrassenThresholds strassen_thresholds = StrassenThresholds::startup_defaults();
+
+    GemmKernel gemm_kernel;
+
+    ThreadPool *thread_pool = nullptr;
+    std::shared_ptr<ThreadPool> owned_thread_pool;
+    long long parallel_threshold = 128LL * 128 * 128;
+    int strassen_parallel_depth = 2;
 
     /**
-     * @brief Performs matrix multiplication using Strassen's algorithm if the number of rows in the first matrix is greater than the given threshold.
-     *        Otherwise, it uses the naive matrix multiplication algorithm.
-     *
-     * @param m1 The first matrix.
-     * @param m2 The second matrix.
-     * @param threshold The threshold value for switching between Strassen's algorithm and the naive algorithm.
-     *
-     * @return The result of the matrix multiplication.
+     * @brief Element-wise operations and row loops hand out chunks of at least this many elements to the pool.
      *
-     * @throws InvalidMatrixFormat If the number of columns in the first matrix does not match the number of rows in the second matrix.
-     *
-     * @note This function assumes that the matrices are square and have dimensions that are powers of 2.
+     * They are memory bound, so smaller chunks cost more in scheduling than they gain in bandwidth.
      */
-    Matrix strassen(const Matrix &m1, const Matrix &m2, int threshold) const;
+    static constexpr std::size_t ELEMENTWISE_GRAIN = 1 << 15;
 
-    MatrixView strassen(const MatrixView &m1_view, const MatrixView &m2_view, int threshold) const;
+    /**
+     * @brief Calls fn(begin, end) over chunks of [0, count) on the pool, or once for the whole range when running serially.
+     */
+    void for_each_chunk(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &fn) const;
+
+    /**
+     * @brief Batched products hand out chunks of at least this many multiply-adds to the pool.
+     */
+    static constexpr long long BATCH_GRAIN = 1LL << 18;
 
     /**
-     * @brief Performs matrix multiplication using the naive algorithm.
+     * @brief Calls fn(begin, end) over chunks of [0, count) products of about work_per_product multiply-adds each.
      *
-     * This function takes two matrices as input and returns a new matrix.
-     * Each element in the new matrix is the sum of the products of corresponding elements in the input matrices.
+     * Runs serially unless the whole batch reaches the parallel threshold.
+     */
+    void for_each_batch_chunk(std::size_t count, long long work_per_product, const std::function<void(std::size_t, std::size_t)> &fn) const;
+
+    /**
+     * @brief Returns how many rows of the given width make up one ELEMENTWISE_GRAIN chunk.
+     */
+    static std::size_t rows_per_chunk(int cols);
+
+    /**
+     * @brief Returns true if a memory bound operation on this many elements is worth splitting over the pool.
+     */
+    bool runs_in_parallel(std::size_t elements) const;
+
+    /**
+     * @brief Computes C += A * B for row-major operands, in parallel when a pool is set and the product is large enough.
+     */
+    template <typename T>
+    void run_gemm_kernel(int m, int n, int k,
+                         const T *a, int a_row_stride,
+                         const T *b, int b_row_stride,
+                         T *c, int c_row_stride) const;
+
+    /**
+     * @brief Computes C += alpha * A * B for operands with any strides. The operands have element type S, C has element type T.
+     */
+    template <typename S, typename T>
+    void run_gemm_kernel(int m, int n, int k,
+                         const S *a, int a_row_stride, int a_col_stride,
+                         const S *b, int b_row_stride, int b_col_stride,
+                         T *c, int c_row_stride, double alpha) const;
+
+    /**
+     * @brief Writes a view into a dense row-major buffer with rows get_cols() apart and returns the buffer.
+     */
+    template <typename T>
+    const T *copy_dense(const BasicMatrixView<T> &view, T *out) const;
+
+    /**
+     * @brief Strassen-Winograd recursion on row-major blocks of any shape. Computes C = A * B for m x k times k x n.
      *
-     * @param m1 The first input matrix.
-     * @param m2 The second input matrix.
+     * The products are written into the quadrants of C. The temporaries of this level are carved off the front
+     * of workspace, the rest is handed down to the sub-products. See StrassenWorkspace::required_size() for the amount needed.
      *
-     * @return A new matrix containing that is the matrix product of the two matrices.
+     * While parallel_depth is positive and a thread pool is set, the seven sub-products are submitted to the pool
+     * and the calling thread helps running queued tasks until they are done.
      */
-    Matrix naive_matmul(const Matrix &m1, const Matrix &m2) const;
-
-    MatrixView naive_matmul(const MatrixView &m1_view, const MatrixView &m2_view) const;
+    template <typename T>
+    void strassen(int m, int k, int n,
+                  const T *a, int a_row_stride,
+                  const T *b, int b_row_stride,
+                  T *c, int c_row_stride,
+                  int threshold, int parallel_depth, T *workspace) const;
 };
\ No newline at end of file
@@ -1,30 +1,40 @@
 #pragma once
 
+#include "../include/MatrixExpression.hpp"
+
 #include <array>
 #include <optional>
-
-// Forward declaration of Matrix.
-class Matrix;
+#include <memory>
 
 /**
- * @class MatrixView
- * @brief Provides a view into a matrix
+ * @class BasicMatrixView
+ * @brief Provides a view into a matrix of float or double elements. MatrixView and FloatMatrixView name the two.
  *
  * This class provides a view into a matrix so that operations can be performed without having
  * to allocate new memory.
  *
+ * A view is described entirely by metadata: a pointer to its first element, its shape, a row stride
+ * and a column stride, and the extent of the stored data. Elements outside the stored extent but inside
+ * the shape read as zero, which is how padded views are represented. Transposing, taking a sub-block
+ * and padding only change that metadata, so all of them are O(1), and element access is a plain
+ * non-virtual index computation.
+ *
+ * Kernels can skip element access altogether and work on data(), get_row_stride() and get_col_stride().
+ *
  * Example usage:
  * @code
- * MatrixView transpose = matrix.transpose();
+ * MatrixView transpose = matrix.view().transpose();
+ * MatrixView block = transpose.sub_view(0, 0, 2, 2);
  * @endcode
  *
  * This will return a view so that new memory don't have to be allocated to transpose matrix.
  *
  */
-class MatrixView
+template <typename T>
+class BasicMatrixView
 {
 public:
-    virtual ~MatrixView() = default;
+    using value_type = T;
 
     /**
      * @brief Constructs a MatrixView object that provides a view into a parent matrix.
@@ -35,7 +45,19 @@ public:
      * @param row_off The row offset from the parent matrix's origin.
      * @param col_off The column offset from the parent matrix's origin.
      */
-    MatrixView(std::shared_ptr<const double[]> data, int r, int c, int row_off, int col_off);
+    BasicMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off);
+
+    /**
+     * @brief Constructs a MatrixView object with an explicit row stride.
+     *
+     * @param data A pointer to the parent matrix's data.
+     * @param r The number of rows in the view.
+     * @param c The number of columns in the view.
+     * @param row_off The row offset from the parent matrix's origin.
+     * @param col_off The column offset from the parent matrix's origin.
+     * @param row_stride The number of elements between consecutive rows in the parent data.
+     */
+    BasicMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off, int row_stride);
 
     /**
      * @brief Returns the element at the specified row and column in the view.
@@ -46,55 +68,110 @@ public:
      * @param row The row index of the element to retrieve.
      * @param col The column index of the element to retrieve.
      *
-     * @return The value of the element at the specified row and column in the view.
+     * @return The value of the element at the specified row and column in the view, 0 in the padding.
+     *
+     * @throws std::out_of_range If the index is outside the view.
      */
-    virtual double get_element(int row, int col) const;
+    T get_element(int row, int col) const;
 
     /**
-     * @brief Overloads get_element to take in an additional parameter to modify the step size.
-     *
-     * This function retrieves the element at the given row and column in the view with the step size given by the parameter.
-     * For example this is used in PaddedMatrixView for correct data access when using padded views.
+     * @brief Returns a view of the transpose. Only the metadata changes.
+     */
+    BasicMatrixView transpose() const;
+
+    /**
+     * @brief Returns a view of the r x c block starting at (row, col). Only the metadata changes.
      *
-     * @param row The row index of the element to retrieve.
-     * @param col The column index of the element to retrieve.
+     * @throws std::out_of_range If the block does not fit into the view.
+     */
+    BasicMatrixView sub_view(int row, int col, int r, int c) const;
+
+    /**
+     * @brief Returns an r x c view that reads as this view extended with zeros. Only the metadata changes.
      *
-     * @return The value of the element at the specified row and column in the view.
+     * @throws std::invalid_argument If r or c is smaller than the current shape.
      */
-    double get_element(int row, int col, int stride) const;
+    BasicMatrixView padded(int r, int c) const;
 
     /**
      * @brief Splits the matrix view into four equal-sized sub-matrices.
      *
      * This function divides the current matrix view into four equal-sized sub-matrices.
-     * The original matrix view remains unchanged.
+     * The original matrix view remains unchanged. The sub-matrices keep the strides and padding of this view.
      *
      * @throws InvalidMatrixFormat if the matrix view is not square.
      *
-     * @return An array of four MatrixView objects representing the sub-matrices.
+     * @return An array of four views representing the sub-matrices.
      *         The order of the sub-matrices is as follows:
      *         - upper_left: The upper-left sub-matrix.
      *         - upper_right: The upper-right sub-matrix.
      *         - lower_left: The lower-left sub-matrix.
      *         - lower_right: The lower-right sub-matrix.
      */
-    std::array<MatrixView, 4> split() const;
-
-    Matrix convert_to_matrix(int row_start, int row_end, int col_start, int col_end) const;
+    std::array<BasicMatrixView, 4> split() const;
 
-    MatrixView operator+(const MatrixView &other) const;
+    BasicMatrix<T> convert_to_matrix(int row_start, int row_end, int col_start, int col_end) const;
 
-    MatrixView operator-(const MatrixView &other) const;
+    /**
+     * @brief Writes the view, including its zero padding, into a dense row-major buffer.
+     *
+     * @param out The first element of the destination.
+     * @param out_row_stride The distance between consecutive rows of the destination.
+     */
+    void copy_to(T *out, int out_row_stride) const;
 
     void display() const;
     int get_rows() const;
     int get_cols() const;
 
+    /**
+     * @brief Returns a pointer to element (0, 0) of the stored data. Only valid if get_data_rows() and get_data_cols() are positive.
+     */
+    const T *data() const;
+
+    int get_row_stride() const;
+    int get_col_stride() const;
+
+    /**
+     * @brief Returns the number of stored rows. Rows from here up to get_rows() are zero padding.
+     */
+    int get_data_rows() const;
+
+    /**
+     * @brief Returns the number of stored columns. Columns from here up to get_cols() are zero padding.
+     */
+    int get_data_cols() const;
+
+    bool is_padded() const;
+
+protected:
+    /**
+     * @brief Constructs a view from its full metadata.
+     */
+    BasicMatrixView(std::shared_ptr<const T[]> owner, const T *origin, int r, int c,
+                    int row_stride, int col_stride, int data_rows, int data_cols);
+
 private:
-    std::shared_ptr<const double[]> parent_data;
+    std::shared_ptr<const T[]> parent_data;
+    const T *origin;
     int rows, cols;
-    int row_offset, col_offset;
+    int row_stride, col_stride;
+    int data_rows, data_cols;
+
+    T element(int row, int col) const
+    {
+        return row < data_rows && col < data_cols ? origin[row * row_stride + col * col_stride] : T(0);
+    }
+};
+
+using MatrixView = BasicMatrixView<double>;
+using FloatMatrixView = BasicMatrixView<float>;
 
-    friend class TransposedMatrixView;
-    friend class PaddedMatrixView;
-};
\ No newline at end of file
+template <typename T>
+MatrixViewOperand<T>::MatrixViewOperand(const BasicMatrixView<T> &view) : origin(view.data()),
+                                                                          rows(view.get_rows()),
+                                                                          cols(view.get_cols()),
+                                                                          row_stride(view.get_row_stride()),
+                                                                          col_stride(view.get_col_stride()),
+                                                                          data_rows(view.get_data_rows()),
+                                                                          data_cols(view.get_data_cols()) {}
@@ -4,16 +4,33 @@
 
 #include <memory>
 
-class PaddedMatrixView : public MatrixView
+/**
+ * @class BasicPaddedMatrixView
+ * @brief A MatrixView of row-major data extended with zeros to a larger shape.
+ *
+ * The padding is part of the MatrixView metadata, so a PaddedMatrixView can be passed around and copied
+ * as a plain MatrixView without losing it.
+ */
+template <typename T>
+class BasicPaddedMatrixView : public BasicMatrixView<T>
 {
 public:
-    PaddedMatrixView(std::shared_ptr<const double[]> data, int r, int c, int p_rows, int p_cols);
+    /**
+     * @param data A pointer to the parent matrix's data.
+     * @param r The number of rows in the view.
+     * @param c The number of columns in the view.
+     * @param p_rows The number of rows of the data.
+     * @param p_cols The number of columns of the data.
+     */
+    BasicPaddedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int p_rows, int p_cols);
 
-    double get_element(int row, int col) const override;
+    /**
+     * @brief Constructs a padded view of data whose rows are data_row_stride elements apart.
+     *
+     * @param data_row_stride The leading dimension of the data, at least p_cols.
+     */
+    BasicPaddedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int p_rows, int p_cols, int data_row_stride);
+};
 
-private:
-    int rows;
-    int cols;
-    int parent_rows;
-    int parent_cols;
-};
\ No newline at end of file
+using PaddedMatrixView = BasicPaddedMatrixView<double>;
+using FloatPaddedMatrixView = BasicPaddedMatrixView<float>;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixView.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The direction along which a QuantizedMatrix shares its scale factors.
+ */
+enum class QuantizationAxis
+{
+    PerRow,
+    PerColumn
+};
+
+/**
+ * @class QuantizedMatrix
+ * @brief A dense row-major matrix of int8 values with one float scale factor per row or per column.
+ *
+ * Element (i, j) stands for scale * value(i, j), with the scale of row i or of column j. quantize() chooses
+ * symmetric scales, the largest magnitude of the row or column divided by 127, so zero stays exact and
+ * every value lies in [-127, 127].
+ *
+ * MatrixOperator::matmul_quantized() multiplies a left operand quantized per row with a right operand
+ * quantized per column. Every element of the product then has the single scale row_scale * col_scale,
+ * which is applied once to its int32 sum.
+ *
+ * Example usage:
+ * @code
+ * QuantizedMatrix qa = QuantizedMatrix::quantize(a.view(), QuantizationAxis::PerRow);
+ * QuantizedMatrix qb = QuantizedMatrix::quantize(b.view(), QuantizationAxis::PerColumn);
+ * FloatMatrix c = mat_operator.matmul_quantized(qa, qb);
+ * @endcode
+ */
+class QuantizedMatrix
+{
+public:
+    /**
+     * @brief Constructs a matrix from its int8 values in row-major order and their scale factors.
+     *
+     * @param rows The number of rows.
+     * @param cols The number of columns.
+     * @param values The rows * cols values.
+     * @param scales One scale per row for QuantizationAxis::PerRow, one per column for QuantizationAxis::PerColumn.
+     * @param axis The direction the scales apply along.
+     *
+     * @throws std::invalid_argument If rows or cols is negative.
+     * @throws InvalidMatrixFormat If the number of values or scales does not match the shape.
+     */
+    QuantizedMatrix(int rows, int cols, std::vector<std::int8_t> values, std::vector<float> scales, QuantizationAxis axis);
+
+    /**
+     * @brief Quantizes a float or double view of any layout with symmetric scales along the given axis.
+     *
+     * A row or column of zeros gets the scale 1, and so does one whose largest magnitude / 127 is too small for a
+     * float. Its values are then quantized to zero.
+     *
+     * @throws std::invalid_argument If the view holds a NaN, or a magnitude whose scale does not fit into a float.
+     */
+    template <typename T>
+    static QuantizedMatrix quantize(const BasicMatrixView<T> &view, QuantizationAxis axis);
+
+    int get_rows() const;
+    int get_cols() const;
+    QuantizationAxis get_axis() const;
+
+    /**
+     * @brief Returns a pointer to the first value. Rows are get_cols() values apart.
+     */
+    const std::int8_t *data() const;
+
+    const std::vector<float> &get_scales() const;
+
+    /**
+     * @brief Returns the int8 value at the specified row and column, without its scale.
+     *
+     * @throws std::out_of_range If the specified column or row index is out of bounds.
+     */
+    std::int8_t get_value(int row, int col) const;
+
+    /**
+     * @brief Returns the matrix the values stand for, every value multiplied by its scale.
+     */
+    FloatMatrix dequantize() const;
+
+private:
+    int rows;
+    int cols;
+    QuantizationAxis axis;
+    std::vector<std::int8_t> values;
+    std::vector<float> scales;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Instruction set levels that SimdKernels can dispatch to, ordered from least to most capable.
+ */
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @struct SimdKernelTable
+ * @brief The set of vectorized kernels implemented for one instruction set level and element type.
+ *
+ * The GEMM micro-kernel computes C += A * B for one gemm_mr x gemm_nr tile, where A is a packed panel
+ * of gemm_mr rows stored column by column and B is a packed sliver of gemm_nr columns stored row by row.
+ * Only the leading tile_rows x tile_cols part of the tile is written back to C.
+ *
+ * The transpose micro-kernel writes the transpose of a transpose_tile x transpose_tile tile of in to out,
+ * shuffling whole rows in registers. The tiles must not overlap.
+ *
+ * A register holds twice as many floats as doubles, so the float tables use wider tiles.
+ */
+template <typename T>
+struct SimdKernelTable
+{
+    SimdLevel level;
+
+    int gemm_mr;
+    int gemm_nr;
+    void (*gemm_micro_kernel)(int kc, const T *a, const T *b,
+                              T *c, int c_row_stride, int tile_rows, int tile_cols);
+
+    void (*add)(const T *x, const T *y, T *out, std::size_t n);
+    void (*subtract)(const T *x, const T *y, T *out, std::size_t n);
+    void (*scale)(const T *x, T scalar, T *out, std::size_t n);
+    T (*dot)(const T *x, const T *y, std::size_t n);
+    void (*axpy)(T alpha, const T *x, T *y, std::size_t n);
+
+    int transpose_tile;
+    void (*transpose_micro_kernel)(const T *in, int in_row_stride, T *out, int out_row_stride);
+};
+
+/**
+ * @struct Int8KernelTable
+ * @brief The quantized GEMM micro-kernel of one instruction set level.
+ *
+ * The int8 operands are widened to int16 and packed in pairs of consecutive k steps, so that one multiply-add
+ * of 16-bit lanes (pmaddwd) forms two products and their sum in every 32-bit lane. For every pair q a packed
+ * panel of A stores the gemm_mr pairs (a(i, 2q), a(i, 2q + 1)) and a packed sliver of B stores the gemm_nr pairs
+ * (b(2q, j), b(2q + 1, j)). An odd k is padded with a zero step.
+ *
+ * The micro-kernel sums k_pairs pairs exactly in int32 and dequantizes on the way out,
+ * c(i, j) += row_scales[i] * col_scales[j] * sum. Only the leading tile_rows x tile_cols part of the tile is written.
+ */
+struct Int8KernelTable
+{
+    SimdLevel level;
+
+    int gemm_mr;
+    int gemm_nr;
+    void (*gemm_micro_kernel)(int k_pairs, const std::int16_t *a, const std::int16_t *b,
+                              const float *row_scales, const float *col_scales,
+                              float *c, int c_row_stride, int tile_rows, int tile_cols);
+};
+
+/**
+ * @class SimdKernels
+ * @brief Selects the best kernel table for the running CPU.
+ *
+ * The CPU is inspected with CPUID the first time the kernels are requested and the most capable
+ * supported level is used from then on. force_level() overrides the choice, which is mainly useful
+ * for testing the lower levels on a machine that supports the higher ones.
+ *
+ * Example usage:
+ * @code
+ * SimdKernels::get().add(x, y, out, n);
+ * SimdKernels::get<float>().dot(x, y, n);
+ * SimdKernels::get_int8().gemm_mr;
+ * SimdKernels::force_level(SimdLevel::Scalar);
+ * @endcode
+ */
+class SimdKernels
+{
+public:
+    /**
+     * @brief Returns the kernel table for elements of type T currently in use. Implemented for float and double.
+     */
+    template <typename T = double>
+    static const SimdKernelTable<T> &get();
+
+    /**
+     * @brief Returns the int8 kernel table of the level currently in use.
+     *
+     * AVX-512F has no 16-bit integer multiply-add, so the AVX-512 level uses the AVX2 kernel.
+     */
+    static const Int8KernelTable &get_int8();
+
+    /**
+     * @brief Returns the most capable level supported by both the CPU and this build.
+     */
+    static SimdLevel detect_level();
+
+    /**
+     * @brief Returns the level of the kernel table currently in use.
+     */
+    static SimdLevel active_level();
+
+    /**
+     * @brief Forces the kernels of a specific level to be used, for every element type.
+     *
+     * @param level The level to switch to.
+     *
+     * @throws std::invalid_argument If the level is not supported by the CPU or was not compiled in.
+     */
+    static void force_level(SimdLevel level);
+
+    /**
+     * @brief Restores the automatically detected level.
+     */
+    static void reset_level();
+
+    /**
+     * @brief Returns true if the given level can be used on this machine. AVX-512 also requires AVX2, whose int8 kernel it uses.
+     */
+    static bool is_supported(SimdLevel level);
+};
+
+template <>
+const SimdKernelTable<double> &SimdKernels::get<double>();
+
+template <>
+const SimdKernelTable<float> &SimdKernels::get<float>();
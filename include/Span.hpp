@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @class Span
+ * @brief A non-owning view of count contiguous elements, like C++20's std::span.
+ *
+ * Indexing is only bounds checked in debug builds.
+ *
+ * Example usage:
+ * @code
+ * for (double &value : matrix.row(i))
+ * {
+ *     value *= 2.0;
+ * }
+ * @endcode
+ */
+template <typename T>
+class Span
+{
+public:
+    Span(T *first, std::size_t count) : first(first), count(count) {}
+
+    T *data() const { return first; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T *begin() const { return first; }
+    T *end() const { return first + count; }
+
+    T &operator[](std::size_t index) const
+    {
+        assert(index < count);
+        return first[index];
+    }
+
+private:
+    T *first;
+    std::size_t count;
+};
+
+/**
+ * @class StridedIterator
+ * @brief A random access iterator over elements that are a fixed distance apart, e.g. a matrix column.
+ *
+ * It keeps the first element and an index rather than a moving pointer, so the end iterator of a column
+ * never points outside the matrix.
+ */
+template <typename T>
+class StridedIterator
+{
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    StridedIterator(T *first, difference_type index, difference_type stride) : first(first), index(index), stride(stride) {}
+
+    T &operator*() const { return first[index * stride]; }
+    T *operator->() const { return first + index * stride; }
+    T &operator[](difference_type offset) const { return first[(index + offset) * stride]; }
+
+    StridedIterator &operator++()
+    {
+        index++;
+        return *this;
+    }
+
+    StridedIterator operator++(int)
+    {
+        StridedIterator previous = *this;
+        index++;
+        return previous;
+    }
+
+    StridedIterator &operator--()
+    {
+        index--;
+        return *this;
+    }
+
+    StridedIterator operator--(int)
+    {
+        StridedIterator previous = *this;
+        index--;
+        return previous;
+    }
+
+    StridedIterator &operator+=(difference_type offset)
+    {
+        index += offset;
+        return *this;
+    }
+
+    StridedIterator &operator-=(difference_type offset)
+    {
+        index -= offset;
+        return *this;
+    }
+
+    StridedIterator operator+(difference_type offset) const { return StridedIterator(first, index + offset, stride); }
+    StridedIterator operator-(difference_type offset) const { return StridedIterator(first, index - offset, stride); }
+    difference_type operator-(const StridedIterator &other) const { return index - other.index; }
+
+    bool operator==(const StridedIterator &other) const { return index == other.index; }
+    bool operator!=(const StridedIterator &other) const { return index != other.index; }
+    bool operator<(const StridedIterator &other) const { return index < other.index; }
+    bool operator>(const StridedIterator &other) const { return index > other.index; }
+    bool operator<=(const StridedIterator &other) const { return index <= other.index; }
+    bool operator>=(const StridedIterator &other) const { return index >= other.index; }
+
+private:
+    T *first;
+    difference_type index;
+    difference_type stride;
+};
+
+/**
+ * @class StridedSpan
+ * @brief A non-owning view of count elements that are stride elements apart.
+ *
+ * Indexing is only bounds checked in debug builds.
+ */
+template <typename T>
+class StridedSpan
+{
+public:
+    StridedSpan(T *first, std::size_t count, std::ptrdiff_t stride) : first(first), count(count), stride(stride) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::ptrdiff_t get_stride() const { return stride; }
+
+    StridedIterator<T> begin() const { return StridedIterator<T>(first, 0, stride); }
+    StridedIterator<T> end() const { return StridedIterator<T>(first, static_cast<std::ptrdiff_t>(count), stride); }
+
+    T &operator[](std::size_t index) const
+    {
+        assert(index < count);
+        return first[static_cast<std::ptrdiff_t>(index) * stride];
+    }
+
+private:
+    T *first;
+    std::size_t count;
+    std::ptrdiff_t stride;
+};
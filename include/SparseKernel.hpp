@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../include/ThreadPool.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class SparseKernel
+ * @brief Sparse times dense products on raw compressed arrays: SpMV with a vector and SpMM with a row-major matrix.
+ *
+ * A sparse operand is given by its major size and its offsets, indices and values arrays, see BasicSparseMatrix.
+ * The CSR kernels gather: every row of the result is one pass over a row of A. The CSC kernels scatter: every
+ * column of A is added into the rows of the result it has elements in. In the SpMM kernels every element of A
+ * scales a row of B into a row of C with the SIMD axpy kernel of the running CPU, see SimdKernels. Elements are
+ * float or double.
+ *
+ * The parallel overloads balance by nonzeros, not by lines: partition() cuts the lines into parts holding about the
+ * same number of elements, so a few dense rows do not end up on one worker. CSR products give every part its own rows
+ * of the result. CSC SpMM gives every worker a slice of the columns of C, and CSC SpMV, whose parts would all write
+ * the same y, accumulates every part into a private vector that is summed afterwards. The calling thread helps with
+ * queued tasks until they are done, so they are safe to call from one of the pool's own workers.
+ *
+ * Example usage:
+ * @code
+ * SparseKernel::csr_spmv(a.get_rows(), offsets, indices, values, 1.0, x, y); // y += A * x
+ * SparseKernel::csr_spmm(pool, a.get_rows(), n, offsets, indices, values, 1.0, b, n, c, n); // C += A * B
+ * @endcode
+ */
+class SparseKernel
+{
+public:
+    /**
+     * @brief Returns parts + 1 line boundaries that cut [0, lines) into parts of about the same number of nonzeros.
+     *
+     * Boundaries never decrease, the first one is 0 and the last one is lines. Lines are never split, a line denser
+     * than a part gets a part of its own.
+     */
+    static std::vector<int> partition(int lines, const std::size_t *offsets, int parts);
+
+    /**
+     * @brief Computes y += alpha * A * x for a CSR matrix A with the given number of rows.
+     */
+    template <typename T>
+    static void csr_spmv(int rows, const std::size_t *offsets, const int *indices, const T *values, T alpha, const T *x, T *y);
+
+    /**
+     * @brief Computes y += alpha * A * x on the given thread pool, in parts of rows balanced by nonzeros.
+     */
+    template <typename T>
+    static void csr_spmv(ThreadPool &pool, int rows, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *x, T *y);
+
+    /**
+     * @brief Computes y += alpha * A * x for a rows x cols CSC matrix A.
+     */
+    template <typename T>
+    static void csc_spmv(int rows, int cols, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *x, T *y);
+
+    /**
+     * @brief Computes y += alpha * A * x on the given thread pool, in parts of columns that sum into private copies of y.
+     */
+    template <typename T>
+    static void csc_spmv(ThreadPool &pool, int rows, int cols, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *x, T *y);
+
+    /**
+     * @brief Computes C += alpha * A * B for a CSR matrix A with the given number of rows and row-major B and C with n columns.
+     *
+     * @param b_row_stride Distance between consecutive rows of B.
+     * @param c_row_stride Distance between consecutive rows of C.
+     */
+    template <typename T>
+    static void csr_spmm(int rows, int n, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *b, int b_row_stride, T *c, int c_row_stride);
+
+    /**
+     * @brief Computes C += alpha * A * B on the given thread pool, in parts of rows balanced by nonzeros.
+     */
+    template <typename T>
+    static void csr_spmm(ThreadPool &pool, int rows, int n, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *b, int b_row_stride, T *c, int c_row_stride);
+
+    /**
+     * @brief Computes C += alpha * A * B for a CSC matrix A with the given number of columns and row-major B and C with n columns.
+     */
+    template <typename T>
+    static void csc_spmm(int cols, int n, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *b, int b_row_stride, T *c, int c_row_stride);
+
+    /**
+     * @brief Computes C += alpha * A * B on the given thread pool, in slices of the columns of B and C.
+     */
+    template <typename T>
+    static void csc_spmm(ThreadPool &pool, int cols, int n, const std::size_t *offsets, const int *indices, const T *values,
+                         T alpha, const T *b, int b_row_stride, T *c, int c_row_stride);
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixView.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief The compressed direction of a BasicSparseMatrix: rows for CSR, columns for CSC.
+ */
+enum class SparseFormat
+{
+    CSR,
+    CSC
+};
+
+/**
+ * @brief One element of a sparse matrix given as (row, col, value), the input of BasicSparseMatrix::from_triplets().
+ */
+template <typename T>
+struct SparseTriplet
+{
+    int row;
+    int col;
+    T value;
+};
+
+/**
+ * @class BasicSparseMatrix
+ * @brief A float or double matrix that stores only its nonzero elements, in CSR or CSC form. SparseMatrix and FloatSparseMatrix name the two.
+ *
+ * The matrix is made of major lines, the rows for SparseFormat::CSR and the columns for SparseFormat::CSC. The
+ * elements of line l are stored at positions [offsets[l], offsets[l + 1]) of indices, which holds their minor index
+ * in ascending order, and of values. CSC is the layout of the transpose: transpose() swaps the shape and the format
+ * and keeps the arrays, so A^T costs nothing whichever form A has.
+ *
+ * The arrays are immutable once built and shared between copies and transposes. MatrixOperator::spmv() and
+ * MatrixOperator::spmm() multiply a sparse matrix with a dense Vector or Matrix, so mixed pipelines keep their dense
+ * operands as they are, see SparseKernel.
+ *
+ * Example usage:
+ * @code
+ * SparseMatrix a = SparseMatrix::from_triplets(3, 3, {{0, 0, 2.0}, {1, 2, -1.0}, {2, 1, 4.0}});
+ * Vector y = mat_operator.spmv(a, x);                      // y = A * x
+ * Matrix c = mat_operator.spmm(a.transpose(), b.view());   // C = A^T * B
+ * @endcode
+ */
+template <typename T>
+class BasicSparseMatrix
+{
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                  "Matrix elements are float or double.");
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs a rows x cols matrix without nonzero elements.
+     *
+     * @throws std::invalid_argument If rows or cols is negative.
+     */
+    BasicSparseMatrix(int rows, int cols, SparseFormat format = SparseFormat::CSR);
+
+    /**
+     * @brief Constructs a matrix from its compressed arrays.
+     *
+     * @param offsets One offset per major line plus one, starting at 0 and ending at the number of nonzeros.
+     * @param indices The minor index of every nonzero, ascending within each line.
+     * @param values The value of every nonzero.
+     *
+     * @throws std::invalid_argument If rows or cols is negative.
+     * @throws InvalidMatrixFormat If the arrays do not describe a rows x cols matrix in the given format.
+     */
+    BasicSparseMatrix(int rows, int cols, std::vector<std::size_t> offsets, std::vector<int> indices, std::vector<T> values,
+                      SparseFormat format);
+
+    /**
+     * @brief Builds a matrix from (row, col, value) triplets in any order. Duplicates are summed.
+     *
+     * @throws std::out_of_range If a triplet lies outside of the matrix.
+     */
+    static BasicSparseMatrix from_triplets(int rows, int cols, const std::vector<SparseTriplet<T>> &triplets,
+                                           SparseFormat format = SparseFormat::CSR);
+
+    /**
+     * @brief Keeps the elements of a dense view of any layout whose magnitude is above drop_tolerance.
+     */
+    static BasicSparseMatrix from_dense(const BasicMatrixView<T> &view, SparseFormat format = SparseFormat::CSR,
+                                        T drop_tolerance = T(0));
+
+    static BasicSparseMatrix from_dense(const BasicMatrix<T> &matrix, SparseFormat format = SparseFormat::CSR,
+                                        T drop_tolerance = T(0));
+
+    /**
+     * @brief Returns the transpose, which shares the arrays of this matrix in the other format.
+     */
+    BasicSparseMatrix transpose() const;
+
+    /**
+     * @brief Returns the same matrix in the given format, compressing along the other direction if it differs.
+     */
+    BasicSparseMatrix to_format(SparseFormat target) const;
+
+    /**
+     * @brief Expands the matrix into a dense Matrix.
+     */
+    BasicMatrix<T> to_dense() const;
+
+    int get_rows() const;
+    int get_cols() const;
+    SparseFormat get_format() const;
+
+    /**
+     * @brief Returns the number of stored elements.
+     */
+    std::size_t get_nonzeros() const;
+
+    const std::vector<std::size_t> &get_offsets() const;
+    const std::vector<int> &get_indices() const;
+    const std::vector<T> &get_values() const;
+
+    /**
+     * @brief Returns element (row, col), zero if it is not stored. Searches the major line in O(log nonzeros per line).
+     *
+     * @throws std::out_of_range If the index is out of bounds.
+     */
+    T get_element(int row, int col) const;
+
+    void display() const;
+
+private:
+    struct Arrays
+    {
+        std::vector<std::size_t> offsets;
+        std::vector<int> indices;
+        std::vector<T> values;
+    };
+
+    int rows, cols;
+    SparseFormat format;
+    std::shared_ptr<const Arrays> arrays;
+
+    BasicSparseMatrix(int rows, int cols, SparseFormat format, std::shared_ptr<const Arrays> arrays);
+
+    /**
+     * @brief Returns the number of major lines, rows for CSR and columns for CSC.
+     */
+    int get_major_size() const;
+};
+
+using SparseMatrix = BasicSparseMatrix<double>;
+using FloatSparseMatrix = BasicSparseMatrix<float>;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @struct StrassenThresholds
+ * @brief Crossover sizes between Strassen's algorithm and the blocked GEMM kernel.
+ *
+ * A product m x k times k x n uses Strassen's algorithm when its smallest dimension is greater than the
+ * threshold for its shape. Near-square products (largest dimension at most RECTANGULAR_ASPECT_RATIO times
+ * the smallest) use the square threshold, all other products the rectangular one.
+ *
+ * Thresholds can be persisted in a small text file with one "key value" pair per line:
+ * @code
+ * square 512
+ * rectangular never
+ * @endcode
+ */
+struct StrassenThresholds
+{
+    static constexpr int NEVER = 2147483647;
+    static constexpr double RECTANGULAR_ASPECT_RATIO = 2.0;
+
+    int square = 256;
+    int rectangular = NEVER;
+
+    /**
+     * @brief Returns the threshold that applies to an m x k times k x n product.
+     */
+    int threshold_for(int m, int k, int n) const;
+
+    /**
+     * @brief Reads thresholds from a config file.
+     *
+     * Keys that are missing from the file keep their default value.
+     *
+     * @param path The path of the config file.
+     *
+     * @return The thresholds read from the file.
+     *
+     * @throws std::runtime_error If the file cannot be opened or contains an invalid line.
+     */
+    static StrassenThresholds load(const std::string &path);
+
+    /**
+     * @brief Writes the thresholds to a config file, creating parent directories as needed.
+     *
+     * @param path The path of the config file.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string &path) const;
+
+    /**
+     * @brief Returns the default config file location.
+     *
+     * This is $LINALG_STRASSEN_CONFIG if set, otherwise $XDG_CONFIG_HOME/linear-algebra/strassen.conf
+     * or ~/.config/linear-algebra/strassen.conf. An empty string is returned if none of these can be determined.
+     */
+    static std::string default_config_path();
+
+    /**
+     * @brief Returns the thresholds loaded from the default config file.
+     *
+     * The file is read once per process. If it does not exist or cannot be parsed the built-in defaults are used.
+     */
+    static const StrassenThresholds &startup_defaults();
+};
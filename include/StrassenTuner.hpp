@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixOperator.hpp"
+#include "../include/StrassenThresholds.hpp"
+#include "../include/ThreadPool.hpp"
+
+#include <vector>
+
+/**
+ * @class StrassenTuner
+ * @brief Measures the crossover between Strassen's algorithm and the blocked GEMM kernel on the current machine.
+ *
+ * For every candidate size the tuner times one product with the blocked kernel and one with Strassen's algorithm
+ * recursing down to half that size, and picks the smallest size where Strassen wins. Near-square and rectangular
+ * products are tuned separately.
+ *
+ * Example usage:
+ * @code
+ * StrassenTuner tuner;
+ * StrassenThresholds thresholds = tuner.tune();
+ * thresholds.save(StrassenThresholds::default_config_path());
+ * @endcode
+ */
+class StrassenTuner
+{
+public:
+    /**
+     * @brief Aspect ratio of the products used to tune the rectangular threshold.
+     */
+    static constexpr int RECTANGULAR_TUNING_RATIO = 4;
+
+    /**
+     * @brief Constructs a StrassenTuner that benchmarks serial products.
+     */
+    StrassenTuner();
+
+    /**
+     * @brief Constructs a StrassenTuner that benchmarks products on the given thread pool.
+     *
+     * @param pool The pool to run the benchmarks on. It must outlive the tuner.
+     */
+    explicit StrassenTuner(ThreadPool &pool);
+
+    /**
+     * @brief Sets the candidate sizes, i.e. the smallest dimension of the benchmarked products.
+     *
+     * @param candidate_sizes The sizes to try. They are tried in ascending order.
+     *
+     * @throws std::invalid_argument If the list is empty or contains a size smaller than 2.
+     */
+    void set_sizes(const std::vector<int> &candidate_sizes);
+
+    /**
+     * @brief Sets how many times each product is timed. The fastest run is used.
+     *
+     * @throws std::invalid_argument If repetitions is not positive.
+     */
+    void set_repetitions(int repetitions);
+
+    /**
+     * @brief Runs the benchmarks and returns the measured thresholds.
+     */
+    StrassenThresholds tune() const;
+
+private:
+    ThreadPool *thread_pool = nullptr;
+    std::vector<int> sizes = {128, 256, 512, 1024};
+    int repetitions = 3;
+
+    /**
+     * @brief Returns the largest size at which the blocked kernel still wins for s x s times s x (aspect_ratio * s) products.
+     */
+    int find_crossover(int aspect_ratio) const;
+
+    double time_matmul(const MatrixOperator &mat_operator, const Matrix &m1, const Matrix &m2) const;
+
+    MatrixOperator create_operator(const StrassenThresholds &thresholds) const;
+};
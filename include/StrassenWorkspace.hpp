@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class StrassenWorkspace
+ * @brief Preallocated scratch memory for MatrixOperator's Strassen recursion.
+ *
+ * The exact amount of scratch memory a Strassen product needs is known up front from its shape,
+ * the crossover threshold and the parallel depth. A workspace allocates it in a single block and every
+ * recursion level carves its temporaries off the front of the block it is given, bump-pointer style,
+ * passing the rest on to its sub-products. No allocation happens inside the recursion.
+ *
+ * The block only grows, so passing the same workspace to many matmul calls allocates once for the largest product.
+ * It comes from MatrixAllocator::get_default(), so even short lived workspaces reuse pooled memory.
+ *
+ * Example usage:
+ * @code
+ * StrassenWorkspace workspace;
+ * for (...)
+ * {
+ *     Matrix C = mat_operator.matmul(A, B, workspace);
+ * }
+ * @endcode
+ */
+class StrassenWorkspace
+{
+public:
+    StrassenWorkspace();
+
+    /**
+     * @brief Returns the number of elements a Strassen product of an m x k and a k x n matrix needs.
+     *
+     * This covers the temporaries of every recursion level. Levels that run their sub-products in parallel
+     * reserve separate scratch for each of them.
+     *
+     * @param threshold Products whose smallest dimension is at or below this are computed by the blocked kernel without scratch memory.
+     * @param parallel_depth The number of recursion levels whose sub-products run concurrently.
+     */
+    static std::size_t required_size(int m, int k, int n, int threshold, int parallel_depth);
+
+    /**
+     * @brief Makes sure the workspace holds at least count doubles. Existing contents are not preserved.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Makes sure the workspace holds at least count elements of type T and returns them.
+     */
+    template <typename T>
+    T *reserve_for(std::size_t count)
+    {
+        reserve((count * sizeof(T) + sizeof(double) - 1) / sizeof(double));
+        return reinterpret_cast<T *>(data());
+    }
+
+    double *data();
+    std::size_t capacity() const;
+
+    /**
+     * @brief Returns how many times the workspace has allocated memory.
+     */
+    std::size_t get_allocation_count() const;
+
+private:
+    std::shared_ptr<double[]> buffer;
+    std::size_t buffer_capacity;
+    std::size_t allocation_count;
+};
@@ -6,15 +6,39 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+#include "./WorkStealingDeque.hpp"
 
 class ThreadPool
 {
 public:
+    /**
+     * @brief How tasks are distributed over the workers.
+     *
+     * SharedQueue: every task goes through one queue behind one mutex. Simple and fair, but all workers
+     * contend on the lock, which hurts recursive, fine-grained workloads.
+     *
+     * WorkStealing: every worker owns a Chase-Lev deque. Tasks submitted from a worker go to the bottom
+     * of its own deque and are popped LIFO; tasks submitted from outside the pool go to a global injection
+     * queue. Idle workers steal FIFO from the top of randomly chosen victims.
+     */
+    enum class Scheduling
+    {
+        SharedQueue,
+        WorkStealing
+    };
+
     /**
      * Constructs a ThreadPool object with the specified number of worker threads.
      * @param pool_size The number of worker threads to create in the pool.
+     * @param scheduling How tasks are distributed over the workers.
      */
-    ThreadPool(size_t pool_size);
+    ThreadPool(size_t pool_size, Scheduling scheduling = Scheduling::SharedQueue);
 
     /**
      * Destroys the ThreadPool object and terminates all worker threads.
@@ -47,15 +71,118 @@ public:
 
         std::future<return_type> future = wrapper->get_future();
 
+        submit([wrapper]()
+               { (*wrapper)(); });
+
+        return future;
+    }
+
+    /**
+     * @brief Runs one queued task on the calling thread, if there is one.
+     *
+     * In work-stealing mode a worker first pops from its own deque, then takes from the injection queue
+     * and finally tries to steal from the other workers.
+     *
+     * @return true if a task was run, false if no task was found.
+     */
+    bool run_pending_task();
+
+    /**
+     * @brief Waits for a future while running queued tasks on the calling thread.
+     *
+     * A worker that blocks on a future of a task it submitted itself can deadlock a fixed-size pool once every
+     * worker is waiting. Helping with the queue instead guarantees progress, so tasks may safely submit and wait
+     * for subtasks recursively.
+     *
+     * @param future The future to wait for.
+     * @return The result of the future.
+     */
+    template <typename T>
+    T wait_and_help(std::future<T> &future)
+    {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            tasks.emplace([wrapper]()
-                          { (*wrapper)(); });
+            if (!run_pending_task())
+            {
+                future.wait_for(std::chrono::microseconds(100));
+            }
         }
 
-        return future;
+        return future.get();
+    }
+
+    /**
+     * @brief Calls fn(chunk_begin, chunk_end) for consecutive chunks covering [begin, end), in parallel.
+     *
+     * The range is cut into chunks of at least grain indices, about CHUNKS_PER_WORKER per worker so that
+     * uneven chunks still balance. All chunks share one task state: a handful of helper tasks are submitted
+     * at once and claim chunks from an atomic counter, and the caller claims chunks as well. The call returns
+     * when every chunk is done, which is tracked by a single countdown instead of one future per chunk.
+     * While waiting, the caller runs queued tasks, so parallel_for may be nested inside pool tasks.
+     *
+     * Ranges that fit into one chunk run inline on the calling thread.
+     *
+     * @throws Rethrows the first exception thrown by fn, after all chunks have finished.
+     */
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F &&fn)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+
+        size_t chunk = chunk_size(end - begin, grain);
+        size_t chunk_count = (end - begin + chunk - 1) / chunk;
+
+        run_chunks(chunk_count, [&](size_t index)
+                   {
+            size_t chunk_begin = begin + index * chunk;
+            fn(chunk_begin, std::min(end, chunk_begin + chunk)); });
+    }
+
+    /**
+     * @brief Reduces [begin, end) in parallel.
+     *
+     * Every chunk is mapped with map(chunk_begin, chunk_end) and the partial results are folded into identity
+     * with combine, in chunk order. Chunking only depends on the range, grain and pool size, so repeated calls
+     * give bit-identical floating point results.
+     *
+     * @throws Rethrows the first exception thrown by map, after all chunks have finished.
+     */
+    template <typename T, typename Map, typename Combine>
+    T parallel_reduce(size_t begin, size_t end, size_t grain, T identity, Map &&map, Combine &&combine)
+    {
+        if (end <= begin)
+        {
+            return identity;
+        }
+
+        size_t chunk = chunk_size(end - begin, grain);
+        size_t chunk_count = (end - begin + chunk - 1) / chunk;
+        std::vector<T> partials(chunk_count, identity);
+
+        run_chunks(chunk_count, [&](size_t index)
+                   {
+            size_t chunk_begin = begin + index * chunk;
+            partials[index] = map(chunk_begin, std::min(end, chunk_begin + chunk)); });
+
+        T result = identity;
+        for (const T &partial : partials)
+        {
+            result = combine(result, partial);
+        }
+
+        return result;
     }
 
+    /**
+     * @brief Returns the number of worker threads in the pool.
+     */
+    size_t size() const;
+
+    Scheduling get_scheduling() const;
+
 private:
     std::vector<std::thread> workers;
     std::queue<std::function<void()>> tasks;
@@ -63,4 +190,20 @@ private:
     std::mutex queue_mutex;
     std::condition_variable condition;
     bool stop;
+
+    Scheduling scheduling;
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+    std::atomic<size_t> pending_tasks{0};
+    std::atomic<size_t> injected_tasks{0};
+    std::atomic<size_t> idle_workers{0};
+
+    static constexpr size_t CHUNKS_PER_WORKER = 4;
+
+    void submit(std::function<void()> task);
+    void submit_copies(const std::function<void()> &task, size_t copies);
+    size_t chunk_size(size_t count, size_t grain) const;
+    void run_chunks(size_t chunk_count, const std::function<void(size_t)> &run_chunk);
+    bool take_task(std::function<void()> &task);
+    void run_shared_queue_worker();
+    void run_work_stealing_worker(size_t index);
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../include/ThreadPool.hpp"
+
+/**
+ * @class TransposeKernel
+ * @brief Cache-oblivious matrix transposition on raw row-major storage.
+ *
+ * The matrix is halved along its longer side until the blocks fit into L1, so both the rows read and the
+ * columns written stay cache and TLB resident at every level of the memory hierarchy without tuning for it.
+ * The blocks are transposed in transpose_tile x transpose_tile tiles by the SIMD micro-kernel of the running
+ * CPU, see SimdKernels. Elements are float or double.
+ *
+ * The parallel overloads split the matrix into bands or block pairs that are transposed independently. The
+ * calling thread helps with queued tasks until they are done, so they are safe to call from one of the pool's
+ * own workers.
+ *
+ * Example usage:
+ * @code
+ * TransposeKernel::transpose(rows, cols, in, cols, out, rows);
+ * TransposeKernel::transpose_in_place(n, data, n);
+ * @endcode
+ */
+class TransposeKernel
+{
+public:
+    /**
+     * @brief Blocks of at most LEAF_SIZE x LEAF_SIZE elements end the recursion. Two of them take 16 KiB.
+     */
+    static constexpr int LEAF_SIZE = 32;
+
+    /**
+     * @brief Writes the transpose of the rows x cols matrix in to the cols x rows matrix out. They must not overlap.
+     *
+     * @param in_row_stride Distance between consecutive rows of in.
+     * @param out_row_stride Distance between consecutive rows of out.
+     */
+    template <typename T>
+    static void transpose(int rows, int cols, const T *in, int in_row_stride, T *out, int out_row_stride);
+
+    /**
+     * @brief Writes the transpose of in to out on the given thread pool, in bands along the longer side.
+     */
+    template <typename T>
+    static void transpose(ThreadPool &pool, int rows, int cols, const T *in, int in_row_stride, T *out, int out_row_stride);
+
+    /**
+     * @brief Transposes the n x n matrix at data in place.
+     */
+    template <typename T>
+    static void transpose_in_place(int n, T *data, int row_stride);
+
+    /**
+     * @brief Transposes the n x n matrix at data in place on the given thread pool.
+     *
+     * Every task handles a diagonal block or swaps a pair of blocks mirrored across the diagonal.
+     */
+    template <typename T>
+    static void transpose_in_place(ThreadPool &pool, int n, T *data, int row_stride);
+};
@@ -4,21 +4,36 @@
 
 #include <memory>
 
-class TransposedMatrixView : public MatrixView
+/**
+ * @class BasicTransposedMatrixView
+ * @brief A MatrixView of the transpose of row-major data.
+ *
+ * The transpose is expressed through the strides of MatrixView: moving along a row of the view moves down
+ * a column of the data. No element access is overridden, so a TransposedMatrixView can be passed around
+ * and copied as a plain MatrixView without losing its layout.
+ */
+template <typename T>
+class BasicTransposedMatrixView : public BasicMatrixView<T>
 {
 public:
-    TransposedMatrixView(std::shared_ptr<const double[]> data, int r, int c, int row_off, int col_off);
-
     /**
-     * @brief Returns the element at the specified row and column in the transposed matrix view.
-     *
-     * This function simulates accessing an element in a transposed matrix by reversing the row and column indices.
-     * It calls the base class (MatrixView) to retrieve the element at the transposed position.
+     * @brief Constructs an r x c view of the transpose of c x r row-major data.
      *
-     * @param row The row index in the transposed matrix view.
-     * @param col The column index in the transposed matrix view.
+     * @param data A pointer to the parent matrix's data.
+     * @param r The number of rows in the view, i.e. the number of columns of the data.
+     * @param c The number of columns in the view, i.e. the number of rows of the data.
+     * @param row_off The row offset into the view.
+     * @param col_off The column offset into the view.
+     */
+    BasicTransposedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off);
+
+    /**
+     * @brief Constructs a view of the transpose of data whose rows are data_row_stride elements apart.
      *
-     * @return The element at the specified row and column in the transposed matrix view.
+     * @param data_row_stride The leading dimension of the data, at least r.
      */
-    double get_element(int row, int col) const override;
-};
\ No newline at end of file
+    BasicTransposedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off, int data_row_stride);
+};
+
+using TransposedMatrixView = BasicTransposedMatrixView<double>;
+using FloatTransposedMatrixView = BasicTransposedMatrixView<float>;
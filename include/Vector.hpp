@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../include/MatrixAllocator.hpp"
+#include "../include/MatrixView.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class MatrixOperator;
+
+/**
+ * @class BasicVector
+ * @brief A dense vector of float or double values. Vector and FloatVector name the two.
+ *
+ * The elements are contiguous and start on a cache line, which is what the gemv, ger, dot and axpy kernels of
+ * MatrixOperator work on. A Matrix(n, 1) holds the same values, but every operation on it is a matrix product.
+ *
+ * Like Matrix, a vector has copy-on-write storage. Copies and views share the elements until the first write
+ * through a vector whose storage is shared, which gives that vector a private copy.
+ *
+ * Example usage:
+ * @code
+ * Vector x({1.0, 2.0, 3.0});
+ * Vector y = mat_operator.gemv(a.view(), x); // y = A * x
+ * double norm_squared = mat_operator.dot(y, y);
+ * @endcode
+ */
+template <typename T>
+class BasicVector
+{
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                  "Vector elements are float or double.");
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs a zero-initialized vector of size elements.
+     *
+     * @throws std::invalid_argument If size is negative.
+     */
+    explicit BasicVector(int size);
+
+    /**
+     * @brief Constructs a vector holding a copy of the given values.
+     */
+    explicit BasicVector(const std::vector<T> &values);
+
+    /**
+     * @brief Constructs a vector whose elements are left uninitialized, for results that overwrite every element.
+     */
+    static BasicVector uninitialized(int size);
+
+    int get_size() const;
+
+    /**
+     * @brief Returns a pointer to the first element. The non-const overload first gives the vector storage of its own.
+     */
+    T *data()
+    {
+        detach();
+        return storage.get();
+    }
+
+    const T *data() const { return storage.get(); }
+
+    /**
+     * @brief Returns element i.
+     *
+     * @throws std::out_of_range If i is not in [0, get_size()).
+     */
+    T &operator()(int i);
+    const T &operator()(int i) const;
+
+    /**
+     * @brief Sets element i to val.
+     *
+     * @throws std::out_of_range If i is not in [0, get_size()).
+     */
+    void set_element(int i, T val);
+
+    /**
+     * @brief Returns element i.
+     *
+     * @throws std::out_of_range If i is not in [0, get_size()).
+     */
+    T get_element(int i) const;
+
+    /**
+     * @brief Returns a get_size() x 1 view of the vector that shares its data, for use with matrix operations.
+     */
+    BasicMatrixView<T> view() const;
+
+    /**
+     * @brief Copies the elements into a std::vector.
+     */
+    std::vector<T> to_std_vector() const;
+
+    void display() const;
+
+private:
+    int size;
+    std::shared_ptr<T[]> storage;
+
+    BasicVector(int size, bool zero_initialize);
+
+    /**
+     * @brief Gives the vector storage of its own before a write, if copies or views share the current one.
+     */
+    void detach()
+    {
+        if (storage.use_count() > 1)
+        {
+            clone_storage(true);
+        }
+    }
+
+    /**
+     * @brief Replaces the storage with a new buffer of the same size, holding a copy of the elements if keep_contents is set.
+     */
+    void clone_storage(bool keep_contents);
+
+    void check_index(int i) const;
+
+    friend class MatrixOperator;
+};
+
+using Vector = BasicVector<double>;
+using FloatVector = BasicVector<float>;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../include/ThreadPool.hpp"
+
+#include <cstddef>
+
+/**
+ * @class VectorKernel
+ * @brief Matrix-vector and vector-vector kernels on raw storage: gemv, ger, dot and axpy, like their BLAS level 1 and 2 namesakes.
+ *
+ * These operations touch every element of the matrix once, so they are bound by memory bandwidth. They never pack
+ * or pad, and stream the operands in the order they are stored, using the dot and axpy kernels of the running CPU,
+ * see SimdKernels. A matrix with unit column stride is read row by row with dot, one with unit row stride, such as a
+ * transposed view, column by column with axpy into a slice of y that stays in L1. Elements are float or double.
+ *
+ * The parallel overloads split the output, so workers never write the same element. The calling thread helps with
+ * queued tasks until they are done, so they are safe to call from one of the pool's own workers.
+ *
+ * Example usage:
+ * @code
+ * VectorKernel::gemv(m, n, 1.0, a, n, 1, x, y); // y += A * x, A row-major
+ * VectorKernel::gemv(n, m, 1.0, a, 1, n, x, z); // z += A^T * x
+ * VectorKernel::ger(m, n, -1.0, u, v, a, n);    // A -= u * v^T
+ * @endcode
+ */
+class VectorKernel
+{
+public:
+    /**
+     * @brief Computes y += alpha * A * x for an m x n matrix A and contiguous x and y. y must not overlap A or x.
+     *
+     * @param a_row_stride Distance between consecutive rows of A.
+     * @param a_col_stride Distance between consecutive columns of A.
+     */
+    template <typename T>
+    static void gemv(int m, int n, T alpha, const T *a, int a_row_stride, int a_col_stride, const T *x, T *y);
+
+    /**
+     * @brief Computes y += alpha * A * x on the given thread pool, in slices of y.
+     */
+    template <typename T>
+    static void gemv(ThreadPool &pool, int m, int n, T alpha, const T *a, int a_row_stride, int a_col_stride, const T *x, T *y);
+
+    /**
+     * @brief Computes the rank-1 update A += alpha * x * y^T for an m x n row-major A.
+     *
+     * @param a_row_stride Distance between consecutive rows of A.
+     */
+    template <typename T>
+    static void ger(int m, int n, T alpha, const T *x, const T *y, T *a, int a_row_stride);
+
+    /**
+     * @brief Computes the rank-1 update on the given thread pool, in bands of rows.
+     */
+    template <typename T>
+    static void ger(ThreadPool &pool, int m, int n, T alpha, const T *x, const T *y, T *a, int a_row_stride);
+
+    /**
+     * @brief Returns the dot product of the n elements of x and y.
+     */
+    template <typename T>
+    static T dot(std::size_t n, const T *x, const T *y);
+
+    /**
+     * @brief Returns the dot product on the given thread pool.
+     *
+     * The partial sums are added in a fixed order, so repeated calls on the same pool give bit-identical results.
+     */
+    template <typename T>
+    static T dot(ThreadPool &pool, std::size_t n, const T *x, const T *y);
+
+    /**
+     * @brief Computes y += alpha * x for the n elements of x and y.
+     */
+    template <typename T>
+    static void axpy(std::size_t n, T alpha, const T *x, T *y);
+
+    /**
+     * @brief Computes y += alpha * x on the given thread pool.
+     */
+    template <typename T>
+    static void axpy(ThreadPool &pool, std::size_t n, T alpha, const T *x, T *y);
+};
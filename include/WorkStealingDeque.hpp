@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class WorkStealingDeque
+ * @brief A Chase-Lev work-stealing deque of task pointers.
+ *
+ * The owning thread pushes and pops at the bottom (LIFO), which keeps recently spawned, cache-hot subtasks
+ * on the thread that spawned them. Any other thread may steal from the top (FIFO), which hands out the oldest
+ * and usually largest tasks. Only push() and pop() are restricted to the owner; steal() is safe from any thread.
+ *
+ * The ring buffer doubles when full. Old buffers are kept until the deque is destroyed because a concurrent
+ * thief may still be reading from them.
+ *
+ * The deque does not own the tasks it holds: whoever pops or steals a task is responsible for deleting it.
+ *
+ * Based on Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+ */
+class WorkStealingDeque
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param initial_capacity The initial capacity of the ring buffer. It is rounded up to a power of 2.
+     */
+    explicit WorkStealingDeque(std::size_t initial_capacity = 64);
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /**
+     * @brief Pushes a task at the bottom. Owner thread only.
+     */
+    void push(Task *task);
+
+    /**
+     * @brief Pops the most recently pushed task. Owner thread only.
+     *
+     * @return The task, or nullptr if the deque is empty or a thief took the last task.
+     */
+    Task *pop();
+
+    /**
+     * @brief Takes the oldest task. Safe from any thread.
+     *
+     * @return The task, or nullptr if the deque is empty or another thread won the race for it.
+     */
+    Task *steal();
+
+    /**
+     * @brief Returns the number of tasks in the deque. The value may be stale when other threads are active.
+     */
+    std::size_t size() const;
+
+private:
+    struct Buffer
+    {
+        explicit Buffer(std::int64_t capacity);
+
+        Task *get(std::int64_t index) const;
+        void put(std::int64_t index, Task *task);
+
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<Task *>[]> slots;
+    };
+
+    std::atomic<std::int64_t> top;
+    std::atomic<std::int64_t> bottom;
+    std::atomic<Buffer *> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    Buffer *grow(Buffer *old_buffer, std::int64_t top_index, std::int64_t bottom_index);
+};
@@ -0,0 +1,368 @@
+#include "../include/GemmKernel.hpp"
+#include "../include/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    int round_up(int value, int multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    /**
+     * Packs an mc x kc block of A into panels of mr rows. Within a panel the data is stored
+     * column by column so that the micro-kernel reads mr consecutive values per k step.
+     * Rows beyond mc are zero filled so the micro-kernel never needs to special case edges.
+     * The values are converted to the element type of the buffer and scaled by alpha on the way,
+     * which is exact for alpha = 1.
+     */
+    template <typename S, typename T>
+    void pack_a(int mc, int kc, int mr, const S *a, int row_stride, int col_stride, T alpha, T *buffer)
+    {
+        for (int i0 = 0; i0 < mc; i0 += mr)
+        {
+            int panel_rows = std::min(mr, mc - i0);
+            for (int p = 0; p < kc; p++)
+            {
+                const S *column = a + i0 * row_stride + p * col_stride;
+                for (int i = 0; i < panel_rows; i++)
+                {
+                    buffer[i] = alpha * static_cast<T>(column[i * row_stride]);
+                }
+                for (int i = panel_rows; i < mr; i++)
+                {
+                    buffer[i] = 0;
+                }
+                buffer += mr;
+            }
+        }
+    }
+
+    /**
+     * Packs a kc x nc panel of B into slivers of nr columns, stored row by row.
+     * Columns beyond nc are zero filled.
+     */
+    template <typename S, typename T>
+    void pack_b(int kc, int nc, int nr, const S *b, int row_stride, int col_stride, T *buffer)
+    {
+        for (int j0 = 0; j0 < nc; j0 += nr)
+        {
+            int sliver_cols = std::min(nr, nc - j0);
+            for (int p = 0; p < kc; p++)
+            {
+                const S *row = b + p * row_stride + j0 * col_stride;
+                for (int j = 0; j < sliver_cols; j++)
+                {
+                    buffer[j] = static_cast<T>(row[j * col_stride]);
+                }
+                for (int j = sliver_cols; j < nr; j++)
+                {
+                    buffer[j] = 0;
+                }
+                buffer += nr;
+            }
+        }
+    }
+
+    /**
+     * Computes a product that fits into a single block, m <= mc, k <= kc and n <= nc. B is packed whole,
+     * A one panel of mr rows at a time right before the micro-kernel sweeps it across all of B, so the
+     * panel stays in L1 and nothing is packed that is not used straight away.
+     */
+    template <typename S, typename T>
+    void multiply_single_block(const SimdKernelTable<T> &kernels, int m, int n, int k,
+                               const S *a, int a_row_stride, int a_col_stride,
+                               const S *b, int b_row_stride, int b_col_stride,
+                               T *c, int c_row_stride, T alpha, T *packed_a, T *packed_b)
+    {
+        int mr = kernels.gemm_mr;
+        int nr = kernels.gemm_nr;
+
+        pack_b(k, n, nr, b, b_row_stride, b_col_stride, packed_b);
+        for (int ir = 0; ir < m; ir += mr)
+        {
+            int rows = std::min(mr, m - ir);
+            pack_a(rows, k, mr, a + ir * a_row_stride, a_row_stride, a_col_stride, alpha, packed_a);
+            for (int jr = 0; jr < n; jr += nr)
+            {
+                kernels.gemm_micro_kernel(k, packed_a, packed_b + jr * k,
+                                          c + ir * c_row_stride + jr, c_row_stride,
+                                          rows, std::min(nr, n - jr));
+            }
+        }
+    }
+
+    /**
+     * Packs an mc x kc block of int8 A into panels of mr rows for the int8 micro-kernel. For every pair
+     * of k steps a panel stores mr pairs of int16, row by row. Missing rows and the step after an odd kc are zero.
+     */
+    void pack_int8_a(int mc, int kc, int mr, const std::int8_t *a, int row_stride, std::int16_t *buffer)
+    {
+        for (int i0 = 0; i0 < mc; i0 += mr)
+        {
+            int panel_rows = std::min(mr, mc - i0);
+            for (int p = 0; p < kc; p += 2)
+            {
+                bool has_second = p + 1 < kc;
+                for (int i = 0; i < panel_rows; i++)
+                {
+                    const std::int8_t *row = a + (i0 + i) * row_stride + p;
+                    buffer[2 * i] = row[0];
+                    buffer[2 * i + 1] = has_second ? row[1] : 0;
+                }
+                std::fill(buffer + 2 * panel_rows, buffer + 2 * mr, 0);
+                buffer += 2 * mr;
+            }
+        }
+    }
+
+    /**
+     * Packs a kc x nc panel of int8 B into slivers of nr columns. For every pair of k steps a sliver
+     * stores the nr column pairs (b(p, j), b(p + 1, j)). Missing columns and the step after an odd kc are zero.
+     */
+    void pack_int8_b(int kc, int nc, int nr, const std::int8_t *b, int row_stride, std::int16_t *buffer)
+    {
+        for (int j0 = 0; j0 < nc; j0 += nr)
+        {
+            int sliver_cols = std::min(nr, nc - j0);
+            for (int p = 0; p < kc; p += 2)
+            {
+                const std::int8_t *first = b + p * row_stride + j0;
+                const std::int8_t *second = p + 1 < kc ? first + row_stride : nullptr;
+                for (int j = 0; j < nr; j++)
+                {
+                    buffer[2 * j] = j < sliver_cols ? first[j] : 0;
+                    buffer[2 * j + 1] = j < sliver_cols && second != nullptr ? second[j] : 0;
+                }
+                buffer += 2 * nr;
+            }
+        }
+    }
+
+    /**
+     * Partitions an m x n result into about four tiles per worker with sides that are multiples of mr and nr,
+     * kept roughly square to limit how often the same panels are packed, and calls fn(i0, j0, rows, cols) for
+     * every tile on the pool.
+     */
+    void for_each_tile(ThreadPool &pool, int m, int n, int mr, int nr, const std::function<void(int, int, int, int)> &fn)
+    {
+        double target_tiles = static_cast<double>(std::max<size_t>(pool.size(), 1) * 4);
+        double tile_side = std::sqrt(static_cast<double>(m) * n / target_tiles);
+
+        int tile_rows = std::min(round_up(std::max(static_cast<int>(tile_side), 1), mr), round_up(m, mr));
+        int tile_cols = std::min(round_up(std::max(static_cast<int>(tile_side), 1), nr), round_up(n, nr));
+
+        int tile_row_count = (m + tile_rows - 1) / tile_rows;
+        int tile_col_count = (n + tile_cols - 1) / tile_cols;
+
+        pool.parallel_for(0, static_cast<size_t>(tile_row_count) * tile_col_count, 1, [&](size_t first_tile, size_t last_tile)
+                          {
+            for (size_t tile = first_tile; tile < last_tile; tile++)
+            {
+                int i0 = static_cast<int>(tile / tile_col_count) * tile_rows;
+                int j0 = static_cast<int>(tile % tile_col_count) * tile_cols;
+                fn(i0, j0, std::min(tile_rows, m - i0), std::min(tile_cols, n - j0));
+            } });
+    }
+}
+
+GemmKernel::GemmKernel() : block_sizes() {}
+
+GemmKernel::GemmKernel(const GemmBlockSizes &sizes) : block_sizes(sizes)
+{
+    if (sizes.mc <= 0 || sizes.kc <= 0 || sizes.nc <= 0)
+    {
+        throw std::invalid_argument("Block sizes must be positive.");
+    }
+}
+
+/**
+ * Loop order follows the classic Goto/BLIS layout: jc over nc panels of B, pc over kc slices
+ * of the shared dimension, ic over mc blocks of A, then jr/ir over nr/mr register tiles.
+ * Products that fit into a single block take a shorter path without the blocking loops.
+ */
+template <typename S, typename T>
+void GemmKernel::multiply(int m, int n, int k,
+                          const S *a, int a_row_stride, int a_col_stride,
+                          const S *b, int b_row_stride, int b_col_stride,
+                          T *c, int c_row_stride, double alpha) const
+{
+    if (m <= 0 || n <= 0 || k <= 0)
+    {
+        return;
+    }
+
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    int mr = kernels.gemm_mr;
+    int nr = kernels.gemm_nr;
+
+    int kc_max = std::min(block_sizes.kc, k);
+    int mc_max = std::min(block_sizes.mc, m);
+    int nc_max = std::min(block_sizes.nc, n);
+
+    // Packing buffers are kept per thread, so repeated and concurrent calls do not allocate.
+    thread_local std::vector<T> packed_a;
+    thread_local std::vector<T> packed_b;
+    packed_a.resize(std::max<size_t>(packed_a.size(), round_up(mc_max, mr) * kc_max));
+    packed_b.resize(std::max<size_t>(packed_b.size(), round_up(nc_max, nr) * kc_max));
+
+    if (m <= block_sizes.mc && n <= block_sizes.nc && k <= block_sizes.kc)
+    {
+        multiply_single_block(kernels, m, n, k,
+                              a, a_row_stride, a_col_stride,
+                              b, b_row_stride, b_col_stride,
+                              c, c_row_stride, static_cast<T>(alpha), packed_a.data(), packed_b.data());
+        return;
+    }
+
+    for (int jc = 0; jc < n; jc += block_sizes.nc)
+    {
+        int nc = std::min(block_sizes.nc, n - jc);
+
+        for (int pc = 0; pc < k; pc += block_sizes.kc)
+        {
+            int kc = std::min(block_sizes.kc, k - pc);
+
+            pack_b(kc, nc, nr, b + pc * b_row_stride + jc * b_col_stride, b_row_stride, b_col_stride, packed_b.data());
+
+            for (int ic = 0; ic < m; ic += block_sizes.mc)
+            {
+                int mc = std::min(block_sizes.mc, m - ic);
+
+                pack_a(mc, kc, mr, a + ic * a_row_stride + pc * a_col_stride, a_row_stride, a_col_stride, static_cast<T>(alpha), packed_a.data());
+
+                for (int jr = 0; jr < nc; jr += nr)
+                {
+                    for (int ir = 0; ir < mc; ir += mr)
+                    {
+                        kernels.gemm_micro_kernel(kc,
+                                                  packed_a.data() + ir * kc,
+                                                  packed_b.data() + jr * kc,
+                                                  c + (ic + ir) * c_row_stride + jc + jr,
+                                                  c_row_stride,
+                                                  std::min(mr, mc - ir),
+                                                  std::min(nr, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename S, typename T>
+void GemmKernel::multiply(ThreadPool &pool, int m, int n, int k,
+                          const S *a, int a_row_stride, int a_col_stride,
+                          const S *b, int b_row_stride, int b_col_stride,
+                          T *c, int c_row_stride, double alpha) const
+{
+    if (m <= 0 || n <= 0 || k <= 0)
+    {
+        return;
+    }
+
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    for_each_tile(pool, m, n, kernels.gemm_mr, kernels.gemm_nr, [&](int i0, int j0, int rows, int cols)
+                  { multiply(rows, cols, k,
+                             a + i0 * a_row_stride, a_row_stride, a_col_stride,
+                             b + j0 * b_col_stride, b_row_stride, b_col_stride,
+                             c + i0 * c_row_stride + j0, c_row_stride, alpha); });
+}
+
+/**
+ * Same loop order as multiply(), with the shared dimension sliced in steps of 4 * kc.
+ */
+void GemmKernel::multiply_int8(int m, int n, int k,
+                               const std::int8_t *a, int a_row_stride, const float *a_row_scales,
+                               const std::int8_t *b, int b_row_stride, const float *b_col_scales,
+                               float *c, int c_row_stride) const
+{
+    if (m <= 0 || n <= 0 || k <= 0)
+    {
+        return;
+    }
+
+    const Int8KernelTable &kernels = SimdKernels::get_int8();
+    int mr = kernels.gemm_mr;
+    int nr = kernels.gemm_nr;
+    int kc_block = 4 * block_sizes.kc;
+
+    int kc_max = round_up(std::min(kc_block, k), 2);
+    int mc_max = std::min(block_sizes.mc, m);
+    int nc_max = std::min(block_sizes.nc, n);
+
+    thread_local std::vector<std::int16_t> packed_a;
+    thread_local std::vector<std::int16_t> packed_b;
+    packed_a.resize(std::max<size_t>(packed_a.size(), round_up(mc_max, mr) * kc_max));
+    packed_b.resize(std::max<size_t>(packed_b.size(), round_up(nc_max, nr) * kc_max));
+
+    for (int jc = 0; jc < n; jc += block_sizes.nc)
+    {
+        int nc = std::min(block_sizes.nc, n - jc);
+
+        for (int pc = 0; pc < k; pc += kc_block)
+        {
+            int kc = std::min(kc_block, k - pc);
+            int k_pairs = (kc + 1) / 2;
+
+            pack_int8_b(kc, nc, nr, b + pc * b_row_stride + jc, b_row_stride, packed_b.data());
+
+            for (int ic = 0; ic < m; ic += block_sizes.mc)
+            {
+                int mc = std::min(block_sizes.mc, m - ic);
+
+                pack_int8_a(mc, kc, mr, a + ic * a_row_stride + pc, a_row_stride, packed_a.data());
+
+                for (int jr = 0; jr < nc; jr += nr)
+                {
+                    for (int ir = 0; ir < mc; ir += mr)
+                    {
+                        kernels.gemm_micro_kernel(k_pairs,
+                                                  packed_a.data() + ir * 2 * k_pairs,
+                                                  packed_b.data() + jr * 2 * k_pairs,
+                                                  a_row_scales + ic + ir,
+                                                  b_col_scales + jc + jr,
+                                                  c + (ic + ir) * c_row_stride + jc + jr,
+                                                  c_row_stride,
+                                                  std::min(mr, mc - ir),
+                                                  std::min(nr, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void GemmKernel::multiply_int8(ThreadPool &pool, int m, int n, int k,
+                               const std::int8_t *a, int a_row_stride, const float *a_row_scales,
+                               const std::int8_t *b, int b_row_stride, const float *b_col_scales,
+                               float *c, int c_row_stride) const
+{
+    if (m <= 0 || n <= 0 || k <= 0)
+    {
+        return;
+    }
+
+    const Int8KernelTable &kernels = SimdKernels::get_int8();
+    for_each_tile(pool, m, n, kernels.gemm_mr, kernels.gemm_nr, [&](int i0, int j0, int rows, int cols)
+                  { multiply_int8(rows, cols, k,
+                                  a + i0 * a_row_stride, a_row_stride, a_row_scales + i0,
+                                  b + j0, b_row_stride, b_col_scales + j0,
+                                  c + i0 * c_row_stride + j0, c_row_stride); });
+}
+
+const GemmBlockSizes &GemmKernel::get_block_sizes() const
+{
+    return block_sizes;
+}
+
+template void GemmKernel::multiply(int, int, int, const float *, int, int, const float *, int, int, float *, int, double) const;
+template void GemmKernel::multiply(int, int, int, const double *, int, int, const double *, int, int, double *, int, double) const;
+template void GemmKernel::multiply(ThreadPool &, int, int, int, const float *, int, int, const float *, int, int, float *, int, double) const;
+template void GemmKernel::multiply(ThreadPool &, int, int, int, const double *, int, int, const double *, int, int, double *, int, double) const;
+template void GemmKernel::multiply(int, int, int, const float *, int, int, const float *, int, int, double *, int, double) const;
+template void GemmKernel::multiply(ThreadPool &, int, int, int, const float *, int, int, const float *, int, int, double *, int, double) const;
@@ -1,10 +1,15 @@
 #include "../include/Matrix.hpp"
 #include "../include/InvalidMatrixFormat.hpp"
+#include "../include/MatrixAllocator.hpp"
 #include "../include/MatrixView.hpp"
 #include "../include/TransposedMatrixView.hpp"
 #include "../include/PaddedMatrixView.hpp"
+#include "../include/TransposeKernel.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 /**
  * Finds the smallest integer k >= n such that k == 2^x for some integer x.
@@ -37,48 +42,143 @@ int find_square_shape(int rows, int cols)
                : find_smallest_integer_power_of_two(rows);
 }
 
-Matrix::Matrix(int r, int c) : rows(r),
-                               cols(c),
-                               data(std::shared_ptr<double[]>(new double[r * c](), std::default_delete<double[]>())) {}
+template <typename T>
+BasicMatrix<T>::BasicMatrix(int r, int c) : BasicMatrix(r, c, default_leading_dimension(c)) {}
 
-Matrix Matrix::transpose() const
+template <typename T>
+BasicMatrix<T>::BasicMatrix(int r, int c, int leading_dimension) : BasicMatrix(r, c, leading_dimension, true) {}
+
+/**
+ * Without zero initialization only the padding at the end of each row is cleared.
+ */
+template <typename T>
+BasicMatrix<T>::BasicMatrix(int r, int c, int leading_dimension, bool zero_initialize) : rows(r),
+                                                                                         cols(c),
+                                                                                         leading_dimension(leading_dimension)
+{
+    if (leading_dimension < c)
+    {
+        throw std::invalid_argument("Leading dimension must be at least the number of columns.");
+    }
+
+    std::size_t count = static_cast<std::size_t>(r) * leading_dimension;
+    storage = MatrixAllocator::get_default().allocate_shared<T>(count);
+    if (zero_initialize)
+    {
+        std::fill(storage.get(), storage.get() + count, T(0));
+        return;
+    }
+
+    for (int i = 0; i < r && leading_dimension > c; i++)
+    {
+        T *row = storage.get() + static_cast<std::ptrdiff_t>(i) * leading_dimension;
+        std::fill(row + c, row + leading_dimension, T(0));
+    }
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::uninitialized(int r, int c)
+{
+    return BasicMatrix(r, c, default_leading_dimension(c), false);
+}
+
+template <typename T>
+int BasicMatrix<T>::default_leading_dimension(int cols)
+{
+    constexpr int ELEMENTS_PER_CACHE_LINE = static_cast<int>(ALIGNMENT / sizeof(T));
+    constexpr int ELEMENTS_PER_PAGE = static_cast<int>(4096 / sizeof(T));
+
+    if (cols < ELEMENTS_PER_CACHE_LINE)
+    {
+        return cols;
+    }
+
+    int leading_dimension = (cols + ELEMENTS_PER_CACHE_LINE - 1) / ELEMENTS_PER_CACHE_LINE * ELEMENTS_PER_CACHE_LINE;
+    if (leading_dimension % ELEMENTS_PER_PAGE == 0)
+    {
+        leading_dimension += ELEMENTS_PER_CACHE_LINE;
+    }
+
+    return leading_dimension;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const
 {
     int transposed_rows = cols;
     int transposed_cols = rows;
 
-    Matrix transposed(transposed_rows, transposed_cols); // Cols and rows are flipped
+    BasicMatrix transposed = uninitialized(transposed_rows, transposed_cols); // Cols and rows are flipped
+    TransposeKernel::transpose(rows, cols, storage.get(), leading_dimension, transposed.data(), transposed.leading_dimension);
+
+    return transposed;
+}
 
-    for (int i = 0; i < transposed_rows; i++)
+template <typename T>
+void BasicMatrix<T>::transpose_in_place()
+{
+    if (rows != cols)
+    {
+        throw InvalidMatrixFormat("Matrix must be square to transpose in place.");
+    }
+
+    detach();
+    TransposeKernel::transpose_in_place(rows, storage.get(), leading_dimension);
+}
+
+/**
+ * The padding at the end of each row is copied along with the elements, or cleared if the contents are not kept.
+ */
+template <typename T>
+void BasicMatrix<T>::clone_storage(bool keep_contents)
+{
+    std::size_t count = static_cast<std::size_t>(rows) * leading_dimension;
+    std::shared_ptr<T[]> clone = MatrixAllocator::get_default().allocate_shared<T>(count);
+    if (keep_contents)
     {
-        for (int j = 0; j < transposed_cols; j++)
+        std::copy(storage.get(), storage.get() + count, clone.get());
+    }
+    else
+    {
+        for (int i = 0; i < rows && leading_dimension > cols; i++)
         {
-            transposed(i, j) = get_element(j, i);
+            T *row = clone.get() + static_cast<std::ptrdiff_t>(i) * leading_dimension;
+            std::fill(row + cols, row + leading_dimension, T(0));
         }
     }
 
-    return transposed;
+    storage = std::move(clone);
+}
+
+template <typename T>
+BasicMatrixView<T> BasicMatrix<T>::view() const
+{
+    return BasicMatrixView<T>(storage, rows, cols, 0, 0, leading_dimension);
 }
 
-TransposedMatrixView Matrix::transpose_view() const
+template <typename T>
+BasicTransposedMatrixView<T> BasicMatrix<T>::transpose_view() const
 {
     int transposed_rows = cols;
     int transposed_cols = rows;
 
-    return TransposedMatrixView(data, transposed_rows, transposed_cols, 0, 0);
+    return BasicTransposedMatrixView<T>(storage, transposed_rows, transposed_cols, 0, 0, leading_dimension);
 }
 
 /**
  * Note that MatrixView.get_element() will return 0.0 if the row or column index is out of bounds
  * so we only need to find the correct number of rows and columns and return a MatrixView of that shape.
  */
-PaddedMatrixView Matrix::create_square_view() const
+template <typename T>
+BasicPaddedMatrixView<T> BasicMatrix<T>::create_square_view() const
 {
     int shape = find_square_shape(rows, cols);
-    return PaddedMatrixView(data, shape, shape, rows, cols);
+    return BasicPaddedMatrixView<T>(storage, shape, shape, rows, cols, leading_dimension);
 }
 
 // This function should not be used in production code. Only for testing/debugging purposes.
-void Matrix::set_data(const std::vector<std::vector<double>> &newData)
+template <typename T>
+void BasicMatrix<T>::set_data(const std::vector<std::vector<T>> &newData)
 {
     if (newData.size() != rows)
     {
@@ -92,94 +192,58 @@ void Matrix::set_data(const std::vector<std::vector<double>> &newData)
             throw InvalidMatrixFormat("Number of columns in input data does not match number of columns in matrix.");
         }
 
-        for (int j = 0; j < cols; j++)
-        {
-            set_element(i, j, newData[i][j]);
-        }
+        std::copy(newData[i].begin(), newData[i].end(), row(i).begin());
     }
 }
 
-double &Matrix::operator()(int row, int col)
+template <typename T>
+T &BasicMatrix<T>::operator()(int row, int col)
 {
     if (!is_valid_index(row, col))
     {
         throw std::out_of_range("Matrix index out of bounds.");
     }
 
-    return data[row * cols + col];
+    detach();
+    return storage[row * leading_dimension + col];
 }
 
-const double &Matrix::operator()(int row, int col) const
+template <typename T>
+const T &BasicMatrix<T>::operator()(int row, int col) const
 {
     if (!is_valid_index(row, col))
     {
         throw std::out_of_range("Matrix index out of bounds.");
     }
 
-    return data[row * cols + col];
-}
-
-Matrix Matrix::operator+(const Matrix &other) const
-{
-    if (rows != other.get_rows() || cols != other.get_cols())
-    {
-        throw InvalidMatrixFormat("Invalid format for matrix addition. Number of rows and number of columns must match.");
-    }
-
-    Matrix result(rows, cols);
-
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < cols; j++)
-        {
-            result(i, j) = get_element(i, j) + other(i, j);
-        }
-    }
-
-    return result;
+    return storage[row * leading_dimension + col];
 }
 
-Matrix Matrix::operator-(const Matrix &other) const
-{
-    if (rows != other.get_rows() || cols != other.get_cols())
-    {
-        throw InvalidMatrixFormat("Invalid format for matrix addition. Number of rows and number of columns must match.");
-    }
-
-    Matrix result(rows, cols);
-
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < cols; j++)
-        {
-            result(i, j) = get_element(i, j) - other(i, j);
-        }
-    }
-
-    return result;
-}
-
-void Matrix::set_element(int row, int col, double val)
+template <typename T>
+void BasicMatrix<T>::set_element(int row, int col, T val)
 {
     if (!is_valid_index(row, col))
     {
         throw std::out_of_range("Matrix index out of bounds.");
     }
 
-    data[row * cols + col] = val;
+    detach();
+    storage[row * leading_dimension + col] = val;
 }
 
-double Matrix::get_element(int row, int col) const
+template <typename T>
+T BasicMatrix<T>::get_element(int row, int col) const
 {
     if (!is_valid_index(row, col))
     {
         throw std::out_of_range("Matrix index out of bounds.");
     }
 
-    return data[row * cols + col];
+    return storage[row * leading_dimension + col];
 }
 
-void Matrix::display() const
+template <typename T>
+void BasicMatrix<T>::display() const
 {
     for (int i = 0; i < rows; i++)
     {
@@ -191,17 +255,23 @@ void Matrix::display() const
     }
 }
 
-int Matrix::get_rows() const
+template <typename T>
+int BasicMatrix<T>::get_rows() const
 {
     return rows;
 }
 
-int Matrix::get_cols() const
+template <typename T>
+int BasicMatrix<T>::get_cols() const
 {
     return cols;
 }
 
-bool Matrix::is_valid_index(int row, int col) const
+template <typename T>
+bool BasicMatrix<T>::is_valid_index(int row, int col) const
 {
     return row >= 0 && row < rows && col >= 0 && col < cols;
 }
+
+template class BasicMatrix<float>;
+template class BasicMatrix<double>;
@@ -0,0 +1,362 @@
+#include "../include/MatrixAllocator.hpp"
+
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace
+{
+    /**
+     * Size classes run from 64 bytes up to 2^(LARGEST_EXPONENT + 1) bytes, 1 GiB.
+     */
+    constexpr int LARGEST_EXPONENT = 29;
+    constexpr std::size_t SMALL_LIMIT = 256;
+    constexpr int SMALL_CLASS_COUNT = SMALL_LIMIT / MatrixAllocator::ALIGNMENT;
+    constexpr int SIZE_CLASS_COUNT = SMALL_CLASS_COUNT + (LARGEST_EXPONENT - 7) * 4;
+
+    double *heap_allocate(std::size_t bytes)
+    {
+        return static_cast<double *>(::operator new(bytes, std::align_val_t(MatrixAllocator::ALIGNMENT)));
+    }
+
+    void heap_deallocate(double *buffer)
+    {
+        ::operator delete(buffer, std::align_val_t(MatrixAllocator::ALIGNMENT));
+    }
+
+    int highest_bit(std::size_t value)
+    {
+        int bit = 0;
+        while (value >>= 1)
+        {
+            bit++;
+        }
+        return bit;
+    }
+
+    /**
+     * Up to SMALL_LIMIT the classes are the multiples of 64 bytes. Beyond it, the requests between 2^e and
+     * 2^(e + 1) bytes are rounded up to a multiple of 2^(e - 2): 5, 6, 7 or 8 times that. Returns
+     * SIZE_CLASS_COUNT for requests larger than the largest class.
+     */
+    int size_class(std::size_t bytes)
+    {
+        if (bytes <= SMALL_LIMIT)
+        {
+            return bytes == 0 ? 0 : static_cast<int>((bytes - 1) / MatrixAllocator::ALIGNMENT);
+        }
+
+        int exponent = highest_bit(bytes - 1);
+        if (exponent > LARGEST_EXPONENT)
+        {
+            return SIZE_CLASS_COUNT;
+        }
+
+        std::size_t step = std::size_t(1) << (exponent - 2);
+        int quarters = static_cast<int>((bytes + step - 1) / step);
+        return SMALL_CLASS_COUNT + (exponent - 8) * 4 + quarters - 5;
+    }
+
+    std::size_t class_size(int size_class)
+    {
+        if (size_class < SMALL_CLASS_COUNT)
+        {
+            return static_cast<std::size_t>(size_class + 1) * MatrixAllocator::ALIGNMENT;
+        }
+
+        int exponent = 8 + (size_class - SMALL_CLASS_COUNT) / 4;
+        int quarters = 5 + (size_class - SMALL_CLASS_COUNT) % 4;
+        return static_cast<std::size_t>(quarters) << (exponent - 2);
+    }
+
+    using FreeLists = std::array<std::vector<double *>, SIZE_CLASS_COUNT>;
+
+    std::atomic<MatrixAllocator *> default_allocator{nullptr};
+}
+
+struct PooledMatrixAllocator::Pool
+{
+    Pool(std::size_t thread_cache_bytes, std::size_t shared_cache_bytes)
+        : thread_cache_bytes(thread_cache_bytes), shared_cache_bytes(shared_cache_bytes) {}
+
+    ~Pool()
+    {
+        release_shared();
+    }
+
+    /**
+     * Moves a buffer into the shared free list if there is room. Does not touch bytes_held.
+     */
+    bool keep(int size_class, double *buffer)
+    {
+        std::size_t size = class_size(size_class);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (shared_bytes + size > shared_cache_bytes)
+        {
+            return false;
+        }
+
+        free_lists[size_class].push_back(buffer);
+        shared_bytes += size;
+        return true;
+    }
+
+    double *take(int size_class)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<double *> &free_list = free_lists[size_class];
+        if (free_list.empty())
+        {
+            return nullptr;
+        }
+
+        double *buffer = free_list.back();
+        free_list.pop_back();
+        shared_bytes -= class_size(size_class);
+        return buffer;
+    }
+
+    void release_shared()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::vector<double *> &free_list : free_lists)
+        {
+            for (double *buffer : free_list)
+            {
+                heap_deallocate(buffer);
+            }
+            free_list.clear();
+        }
+        bytes_held.fetch_sub(shared_bytes, std::memory_order_relaxed);
+        shared_bytes = 0;
+    }
+
+    const std::size_t thread_cache_bytes;
+    const std::size_t shared_cache_bytes;
+
+    std::mutex mutex;
+    FreeLists free_lists;
+    std::size_t shared_bytes = 0;
+
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> bytes_held{0};
+};
+
+namespace
+{
+    /**
+     * The free lists one thread keeps for one pool. They hold on to the pool, so a thread may outlive the
+     * PooledMatrixAllocator that created them.
+     */
+    struct ThreadCache
+    {
+        explicit ThreadCache(std::shared_ptr<PooledMatrixAllocator::Pool> pool) : pool(std::move(pool)) {}
+
+        ~ThreadCache()
+        {
+            for (int size_class = 0; size_class < SIZE_CLASS_COUNT; size_class++)
+            {
+                for (double *buffer : free_lists[size_class])
+                {
+                    if (!pool->keep(size_class, buffer))
+                    {
+                        heap_deallocate(buffer);
+                        pool->bytes_held.fetch_sub(class_size(size_class), std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        std::shared_ptr<PooledMatrixAllocator::Pool> pool;
+        FreeLists free_lists;
+        std::size_t bytes = 0;
+    };
+
+    struct ThreadCaches
+    {
+        ~ThreadCaches();
+
+        std::vector<std::unique_ptr<ThreadCache>> caches;
+    };
+
+    /**
+     * Set once the caches of the thread are gone. Buffers freed after that, e.g. by destructors of static
+     * matrices, go straight to the shared free list.
+     */
+    thread_local bool thread_caches_destroyed = false;
+    thread_local ThreadCaches thread_caches;
+
+    ThreadCaches::~ThreadCaches()
+    {
+        thread_caches_destroyed = true;
+    }
+
+    ThreadCache *find_thread_cache(const std::shared_ptr<PooledMatrixAllocator::Pool> &pool)
+    {
+        if (thread_caches_destroyed)
+        {
+            return nullptr;
+        }
+
+        for (const std::unique_ptr<ThreadCache> &cache : thread_caches.caches)
+        {
+            if (cache->pool == pool)
+            {
+                return cache.get();
+            }
+        }
+
+        thread_caches.caches.push_back(std::make_unique<ThreadCache>(pool));
+        return thread_caches.caches.back().get();
+    }
+}
+
+/**
+ * The process wide pool is never destroyed, so matrices with static storage duration can still hand their
+ * buffers back to it at exit.
+ */
+MatrixAllocator &MatrixAllocator::get_default()
+{
+    MatrixAllocator *allocator = default_allocator.load(std::memory_order_acquire);
+    if (allocator != nullptr)
+    {
+        return *allocator;
+    }
+
+    static PooledMatrixAllocator *process_pool = new PooledMatrixAllocator();
+    return *process_pool;
+}
+
+void MatrixAllocator::set_default(MatrixAllocator *allocator)
+{
+    default_allocator.store(allocator, std::memory_order_release);
+}
+
+double *HeapMatrixAllocator::allocate(std::size_t count)
+{
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return heap_allocate(count * sizeof(double));
+}
+
+void HeapMatrixAllocator::deallocate(double *buffer, std::size_t)
+{
+    heap_deallocate(buffer);
+}
+
+MatrixAllocatorStats HeapMatrixAllocator::get_stats() const
+{
+    MatrixAllocatorStats stats;
+    stats.misses = misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+PooledMatrixAllocator::PooledMatrixAllocator(std::size_t thread_cache_bytes, std::size_t shared_cache_bytes)
+    : pool(std::make_shared<Pool>(thread_cache_bytes, shared_cache_bytes)) {}
+
+/**
+ * Free lists of other threads keep the pool alive until those threads exit.
+ */
+PooledMatrixAllocator::~PooledMatrixAllocator()
+{
+    release_cached();
+}
+
+double *PooledMatrixAllocator::allocate(std::size_t count)
+{
+    int size_class = ::size_class(count * sizeof(double));
+    if (size_class == SIZE_CLASS_COUNT)
+    {
+        pool->misses.fetch_add(1, std::memory_order_relaxed);
+        return heap_allocate(count * sizeof(double));
+    }
+
+    std::size_t size = class_size(size_class);
+    ThreadCache *cache = find_thread_cache(pool);
+    double *buffer = nullptr;
+    if (cache != nullptr && !cache->free_lists[size_class].empty())
+    {
+        buffer = cache->free_lists[size_class].back();
+        cache->free_lists[size_class].pop_back();
+        cache->bytes -= size;
+    }
+    else
+    {
+        buffer = pool->take(size_class);
+    }
+
+    if (buffer == nullptr)
+    {
+        pool->misses.fetch_add(1, std::memory_order_relaxed);
+        return heap_allocate(size);
+    }
+
+    pool->hits.fetch_add(1, std::memory_order_relaxed);
+    pool->bytes_held.fetch_sub(size, std::memory_order_relaxed);
+    return buffer;
+}
+
+void PooledMatrixAllocator::deallocate(double *buffer, std::size_t count)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    int size_class = ::size_class(count * sizeof(double));
+    if (size_class == SIZE_CLASS_COUNT)
+    {
+        heap_deallocate(buffer);
+        return;
+    }
+
+    // Counted before the buffer is visible to other threads, so that taking it never drops bytes_held below zero.
+    std::size_t size = class_size(size_class);
+    pool->bytes_held.fetch_add(size, std::memory_order_relaxed);
+
+    ThreadCache *cache = find_thread_cache(pool);
+    if (cache != nullptr && cache->bytes + size <= pool->thread_cache_bytes)
+    {
+        cache->free_lists[size_class].push_back(buffer);
+        cache->bytes += size;
+    }
+    else if (!pool->keep(size_class, buffer))
+    {
+        heap_deallocate(buffer);
+        pool->bytes_held.fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+
+MatrixAllocatorStats PooledMatrixAllocator::get_stats() const
+{
+    MatrixAllocatorStats stats;
+    stats.hits = pool->hits.load(std::memory_order_relaxed);
+    stats.misses = pool->misses.load(std::memory_order_relaxed);
+    stats.bytes_held = pool->bytes_held.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PooledMatrixAllocator::release_cached()
+{
+    if (!thread_caches_destroyed)
+    {
+        std::vector<std::unique_ptr<ThreadCache>> &caches = thread_caches.caches;
+        for (auto cache = caches.begin(); cache != caches.end(); ++cache)
+        {
+            if ((*cache)->pool == pool)
+            {
+                caches.erase(cache);
+                break;
+            }
+        }
+    }
+
+    pool->release_shared();
+}
+
+std::size_t PooledMatrixAllocator::rounded_size(std::size_t count)
+{
+    int size_class = ::size_class(count * sizeof(double));
+    return size_class == SIZE_CLASS_COUNT ? count * sizeof(double) : class_size(size_class);
+}
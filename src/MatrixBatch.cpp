@@ -0,0 +1,157 @@
+#include "../include/MatrixBatch.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+#include "../include/MatrixAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * The stride is rounded up to whole cache lines, so every matrix of the batch starts aligned like a Matrix does.
+ */
+template <typename T>
+BasicMatrixBatch<T>::BasicMatrixBatch(int count, int rows, int cols, bool zero_initialize) : count(count),
+                                                                                             rows(rows),
+                                                                                             cols(cols)
+{
+    if (count < 0 || rows < 0 || cols < 0)
+    {
+        throw std::invalid_argument("Batch size and matrix dimensions must not be negative.");
+    }
+
+    constexpr std::size_t ELEMENTS_PER_CACHE_LINE = MatrixAllocator::ALIGNMENT / sizeof(T);
+    std::size_t elements = static_cast<std::size_t>(rows) * cols;
+    stride = (elements + ELEMENTS_PER_CACHE_LINE - 1) / ELEMENTS_PER_CACHE_LINE * ELEMENTS_PER_CACHE_LINE;
+
+    std::size_t total = stride * count;
+    storage = MatrixAllocator::get_default().allocate_shared<T>(total);
+    if (zero_initialize)
+    {
+        std::fill(storage.get(), storage.get() + total, T(0));
+    }
+}
+
+template <typename T>
+BasicMatrixBatch<T>::BasicMatrixBatch(int count, int rows, int cols) : BasicMatrixBatch(count, rows, cols, true) {}
+
+template <typename T>
+BasicMatrixBatch<T> BasicMatrixBatch<T>::uninitialized(int count, int rows, int cols)
+{
+    return BasicMatrixBatch(count, rows, cols, false);
+}
+
+template <typename T>
+int BasicMatrixBatch<T>::get_count() const
+{
+    return count;
+}
+
+template <typename T>
+int BasicMatrixBatch<T>::get_rows() const
+{
+    return rows;
+}
+
+template <typename T>
+int BasicMatrixBatch<T>::get_cols() const
+{
+    return cols;
+}
+
+template <typename T>
+std::size_t BasicMatrixBatch<T>::get_stride() const
+{
+    return stride;
+}
+
+template <typename T>
+T *BasicMatrixBatch<T>::data(int index)
+{
+    check_index(index);
+    detach();
+    return storage.get() + index * stride;
+}
+
+template <typename T>
+const T *BasicMatrixBatch<T>::data(int index) const
+{
+    check_index(index);
+    return storage.get() + index * stride;
+}
+
+template <typename T>
+T &BasicMatrixBatch<T>::operator()(int index, int row, int col)
+{
+    if (row < 0 || row >= rows || col < 0 || col >= cols)
+    {
+        throw std::out_of_range("Matrix index out of bounds.");
+    }
+
+    return data(index)[row * cols + col];
+}
+
+template <typename T>
+const T &BasicMatrixBatch<T>::operator()(int index, int row, int col) const
+{
+    if (row < 0 || row >= rows || col < 0 || col >= cols)
+    {
+        throw std::out_of_range("Matrix index out of bounds.");
+    }
+
+    return data(index)[row * cols + col];
+}
+
+template <typename T>
+BasicMatrixView<T> BasicMatrixBatch<T>::view(int index) const
+{
+    check_index(index);
+    return BasicMatrixView<T>(std::shared_ptr<const T[]>(storage, storage.get() + index * stride), rows, cols, 0, 0);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrixBatch<T>::get_matrix(int index) const
+{
+    const T *first = data(index);
+    BasicMatrix<T> result = BasicMatrix<T>::uninitialized(rows, cols);
+    for (int i = 0; i < rows; i++)
+    {
+        std::copy(first + i * cols, first + (i + 1) * cols, result.row(i).begin());
+    }
+    return result;
+}
+
+template <typename T>
+void BasicMatrixBatch<T>::set_matrix(int index, const BasicMatrixView<T> &matrix)
+{
+    check_index(index);
+    if (matrix.get_rows() != rows || matrix.get_cols() != cols)
+    {
+        throw InvalidMatrixFormat("Shape does not match the matrices of the batch.");
+    }
+
+    matrix.copy_to(data(index), cols);
+}
+
+template <typename T>
+void BasicMatrixBatch<T>::clone_storage(bool keep_contents)
+{
+    std::size_t total = stride * count;
+    std::shared_ptr<T[]> clone = MatrixAllocator::get_default().allocate_shared<T>(total);
+    if (keep_contents)
+    {
+        std::copy(storage.get(), storage.get() + total, clone.get());
+    }
+    storage = std::move(clone);
+}
+
+template <typename T>
+void BasicMatrixBatch<T>::check_index(int index) const
+{
+    if (index < 0 || index >= count)
+    {
+        throw std::out_of_range("Batch index out of bounds.");
+    }
+}
+
+template class BasicMatrixBatch<float>;
+template class BasicMatrixBatch<double>;
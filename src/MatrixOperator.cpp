@@ -1,8 +1,127 @@
 #include "../include/MatrixOperator.hpp"
 #include "../include/Matrix.hpp"
+#include "../include/MatrixAllocator.hpp"
 #include "../include/InvalidMatrixFormat.hpp"
+#include "../include/SimdKernels.hpp"
 
-Matrix MatrixOperator::add(const Matrix &m1, const Matrix &m2) const
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * Computes x + sign * y row by row for rows x cols blocks. out may be x or y.
+     */
+    template <typename T>
+    void combine_blocks(int rows, int cols, const T *x, int x_stride, const T *y, int y_stride, int sign, T *out, int out_stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        for (int i = 0; i < rows; i++)
+        {
+            if (sign >= 0)
+            {
+                kernels.add(x + i * x_stride, y + i * y_stride, out + i * out_stride, cols);
+            }
+            else
+            {
+                kernels.subtract(x + i * x_stride, y + i * y_stride, out + i * out_stride, cols);
+            }
+        }
+    }
+
+    template <typename T>
+    void fill_block(int rows, int cols, T *block, int stride, T value)
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            std::fill(block + i * stride, block + i * stride + cols, value);
+        }
+    }
+
+    /**
+     * Scales a block in place. A factor of 0 overwrites the block with zeros, so NaNs in it do not survive.
+     */
+    template <typename T>
+    void scale_block(int rows, int cols, T *block, int stride, double factor)
+    {
+        if (factor == 0.0)
+        {
+            fill_block(rows, cols, block, stride, T(0));
+            return;
+        }
+
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        for (int i = 0; i < rows; i++)
+        {
+            kernels.scale(block + i * stride, static_cast<T>(factor), block + i * stride, cols);
+        }
+    }
+}
+
+MatrixOperator::MatrixOperator(ThreadPool &pool) : thread_pool(&pool) {}
+
+MatrixOperator::MatrixOperator(size_t thread_count)
+{
+    if (thread_count > 0)
+    {
+        owned_thread_pool = std::make_shared<ThreadPool>(thread_count, ThreadPool::Scheduling::WorkStealing);
+        thread_pool = owned_thread_pool.get();
+    }
+}
+
+size_t MatrixOperator::get_thread_count() const
+{
+    return thread_pool != nullptr ? thread_pool->size() : 1;
+}
+
+void MatrixOperator::set_parallel_threshold(long long min_work)
+{
+    parallel_threshold = min_work;
+}
+
+long long MatrixOperator::get_parallel_threshold() const
+{
+    return parallel_threshold;
+}
+
+void MatrixOperator::set_strassen_parallel_depth(int depth)
+{
+    if (depth < 0)
+    {
+        throw std::invalid_argument("Strassen parallel depth must not be negative.");
+    }
+
+    strassen_parallel_depth = depth;
+}
+
+int MatrixOperator::get_strassen_parallel_depth() const
+{
+    return strassen_parallel_depth;
+}
+
+void MatrixOperator::set_strassen_thresholds(const StrassenThresholds &thresholds)
+{
+    if (thresholds.square < 0 || thresholds.rectangular < 0)
+    {
+        throw std::invalid_argument("Strassen thresholds must not be negative.");
+    }
+
+    strassen_thresholds = thresholds;
+}
+
+const StrassenThresholds &MatrixOperator::get_strassen_thresholds() const
+{
+    return strassen_thresholds;
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::add(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const
 {
     if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols())
     {
@@ -12,191 +131,1131 @@ Matrix MatrixOperator::add(const Matrix &m1, const Matrix &m2) const
     int result_rows = m1.get_rows();
     int result_cols = m1.get_cols();
 
-    Matrix result(result_rows, result_cols);
-    for (int i = 0; i < result_rows; i++)
-    {
-        for (int j = 0; j < result_cols; j++)
+    BasicMatrix<T> result = BasicMatrix<T>::uninitialized(result_rows, result_cols);
+    const T *x = m1.data();
+    const T *y = m2.data();
+    T *out = result.data();
+    int x_ld = m1.get_leading_dimension();
+    int y_ld = m2.get_leading_dimension();
+    int out_ld = result.get_leading_dimension();
+
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    for_each_chunk(result_rows, rows_per_chunk(result_cols), [&](std::size_t first_row, std::size_t last_row)
+                   {
+        for (std::size_t i = first_row; i < last_row; i++)
         {
-            result(i, j) = m1(i, j) + m2(i, j);
-        }
-    }
+            kernels.add(x + i * x_ld, y + i * y_ld, out + i * out_ld, result_cols);
+        } });
 
     return result;
 }
 
-Matrix MatrixOperator::matmul(const Matrix &m1, const Matrix &m2) const
+template <typename T>
+BasicMatrix<T> MatrixOperator::matmul(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const
+{
+    StrassenWorkspace workspace;
+    return matmul(m1.view(), m2.view(), workspace);
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::matmul(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2, StrassenWorkspace &workspace) const
+{
+    return matmul(m1.view(), m2.view(), workspace);
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::matmul(const BasicMatrixView<T> &m1, const BasicMatrixView<T> &m2) const
+{
+    StrassenWorkspace workspace;
+    return matmul(m1, m2, workspace);
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::matmul(const BasicMatrixView<T> &m1, const BasicMatrixView<T> &m2, StrassenWorkspace &workspace) const
 {
     if (m1.get_cols() != m2.get_rows())
     {
         throw InvalidMatrixFormat("Invalid format for matrix multiplication. Number of columns in the first matrix must match the number of rows in the second matrix.");
     }
 
-    return strassen(m1, m2, STRASSEN_THRESHOLD);
+    BasicMatrix<T> result = BasicMatrix<T>::uninitialized(m1.get_rows(), m2.get_cols());
+    gemm(1.0, m1, m2, 0.0, result, workspace);
+
+    return result;
 }
 
-double MatrixOperator::hadamard_product(const Matrix &m1, const Matrix &m2) const
+template <typename T>
+void MatrixOperator::gemm(double alpha, const BasicMatrix<T> &a, const BasicMatrix<T> &b, double beta, BasicMatrix<T> &c) const
 {
-    if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols())
+    StrassenWorkspace workspace;
+    gemm(alpha, a.view(), b.view(), beta, c, workspace);
+}
+
+template <typename T>
+void MatrixOperator::gemm(double alpha, const BasicMatrix<T> &a, const BasicMatrix<T> &b, double beta, BasicMatrix<T> &c, StrassenWorkspace &workspace) const
+{
+    gemm(alpha, a.view(), b.view(), beta, c, workspace);
+}
+
+template <typename T>
+void MatrixOperator::gemm(double alpha, const BasicMatrixView<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c) const
+{
+    StrassenWorkspace workspace;
+    gemm(alpha, a, b, beta, c, workspace);
+}
+
+/**
+ * The blocked kernel packs its operands, so it reads transposed views in place with their strides. Strassen
+ * adds quadrants row by row, so operands without unit column stride are transposed into the workspace first,
+ * which costs O(n^2) next to the O(n^2.8) product. Padded views are always copied.
+ *
+ * Strassen overwrites its output, so unless beta is 0 the product goes to workspace behind the recursion
+ * temporaries and is added to C afterwards.
+ */
+template <typename T>
+void MatrixOperator::gemm(double alpha, const BasicMatrixView<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c, StrassenWorkspace &workspace) const
+{
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
     {
-        throw InvalidMatrixFormat("Invalid format for matrix addition. Number of rows and number of columns must match.");
+        throw InvalidMatrixFormat("Invalid format for gemm. A must be m x k, B k x n and C m x n.");
+    }
+
+    // Views of C and copies of C keep the elements C had before the call, so they may be passed as operands.
+    if (c.storage.use_count() > 1)
+    {
+        c.clone_storage(beta != 0.0);
+    }
+
+    int m = a.get_rows();
+    int k = a.get_cols();
+    int n = b.get_cols();
+    T *out = c.data();
+    int out_ld = c.get_leading_dimension();
+
+    int threshold = strassen_thresholds.threshold_for(m, k, n);
+    bool use_strassen = alpha != 0.0 && std::min({m, k, n}) > threshold;
+
+    if (beta != 1.0 && !(use_strassen && beta == 0.0))
+    {
+        scale_block(m, n, out, out_ld, beta);
+    }
+    if (alpha == 0.0 || k == 0)
+    {
+        return;
     }
 
-    double result = 0;
+    bool copy_a = a.is_padded() || (use_strassen && a.get_col_stride() != 1);
+    bool copy_b = b.is_padded() || (use_strassen && b.get_col_stride() != 1);
+
+    int parallel_depth = thread_pool != nullptr ? strassen_parallel_depth : 0;
+    std::size_t scratch_size = use_strassen ? StrassenWorkspace::required_size(m, k, n, threshold, parallel_depth) : 0;
+    std::size_t product_size = use_strassen && beta != 0.0 ? static_cast<std::size_t>(m) * n : 0;
+    std::size_t a_size = copy_a ? static_cast<std::size_t>(m) * k : 0;
+    std::size_t b_size = copy_b ? static_cast<std::size_t>(k) * n : 0;
 
-    for (int i = 0; i < m1.get_rows(); i++)
+    T *scratch = workspace.reserve_for<T>(scratch_size + product_size + a_size + b_size);
+    T *product = scratch + scratch_size;
+    T *a_copy = product + product_size;
+    T *b_copy = a_copy + a_size;
+
+    const T *a_data = copy_a ? copy_dense(a, a_copy) : a.data();
+    int a_row_stride = copy_a ? k : a.get_row_stride();
+    int a_col_stride = copy_a ? 1 : a.get_col_stride();
+    const T *b_data = copy_b ? copy_dense(b, b_copy) : b.data();
+    int b_row_stride = copy_b ? n : b.get_row_stride();
+    int b_col_stride = copy_b ? 1 : b.get_col_stride();
+
+    if (!use_strassen)
     {
-        for (int j = 0; j < m1.get_cols(); j++)
+        run_gemm_kernel(m, n, k,
+                        a_data, a_row_stride, a_col_stride,
+                        b_data, b_row_stride, b_col_stride,
+                        out, out_ld, alpha);
+        return;
+    }
+
+    if (beta == 0.0)
+    {
+        strassen(m, k, n, a_data, a_row_stride, b_data, b_row_stride, out, out_ld,
+                 threshold, parallel_depth, scratch);
+        if (alpha != 1.0)
         {
-            result += m1(i, j) * m2(i, j);
+            scale_block(m, n, out, out_ld, alpha);
         }
+        return;
     }
 
-    return result;
+    strassen(m, k, n, a_data, a_row_stride, b_data, b_row_stride, product, n,
+             threshold, parallel_depth, scratch);
+    if (alpha != 1.0)
+    {
+        scale_block(m, n, product, n, alpha);
+    }
+    combine_blocks(m, n, out, out_ld, product, n, 1, out, out_ld);
 }
 
-MatrixView MatrixOperator::merge_top_bottom(const MatrixView &m1_view, const MatrixView &m2_view) const
+template <typename T>
+void MatrixOperator::gemm_batched(double alpha, const BasicMatrixBatch<T> &a, const BasicMatrixBatch<T> &b, double beta, BasicMatrixBatch<T> &c) const
 {
-    if (m1_view.get_cols() != m2_view.get_cols())
+    if (a.get_count() != b.get_count() || c.get_count() != a.get_count())
     {
-        throw InvalidMatrixFormat("Matrices must have the same number of columns to merge top to bottom.");
+        throw InvalidMatrixFormat("Batches must hold the same number of matrices.");
+    }
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
+    {
+        throw InvalidMatrixFormat("Invalid format for gemm. A must be m x k, B k x n and C m x n.");
     }
 
-    int result_rows = m1_view.get_rows() + m2_view.get_rows();
-    int result_cols = m1_view.get_cols();
+    // a or b may be c itself. Holding on to their storage makes c's shared, so c moves to storage of its own
+    // while the operands keep reading the elements from before the call.
+    std::shared_ptr<const T[]> a_storage = a.storage;
+    std::shared_ptr<const T[]> b_storage = b.storage;
+    if (c.storage.use_count() > 1)
+    {
+        c.clone_storage(beta != 0.0);
+    }
+
+    int m = a.get_rows();
+    int k = a.get_cols();
+    int n = b.get_cols();
+    const T *a_data = a_storage.get();
+    const T *b_data = b_storage.get();
+    T *c_data = c.storage.get();
+
+    for_each_batch_chunk(a.get_count(), static_cast<long long>(m) * n * k, [&](std::size_t first, std::size_t last)
+                         {
+        for (std::size_t i = first; i < last; i++)
+        {
+            T *out = c_data + i * c.stride;
+            if (beta != 1.0)
+            {
+                scale_block(m, n, out, n, beta);
+            }
+            if (alpha != 0.0)
+            {
+                gemm_kernel.multiply(m, n, k, a_data + i * a.stride, k, 1, b_data + i * b.stride, n, 1, out, n, alpha);
+            }
+        } });
+}
+
+template <typename T>
+BasicMatrixBatch<T> MatrixOperator::matmul_batched(const BasicMatrixBatch<T> &a, const BasicMatrixBatch<T> &b) const
+{
+    if (a.get_count() != b.get_count())
+    {
+        throw InvalidMatrixFormat("Batches must hold the same number of matrices.");
+    }
+    if (a.get_cols() != b.get_rows())
+    {
+        throw InvalidMatrixFormat("Invalid format for matrix multiplication. Number of columns in the first matrix must match the number of rows in the second matrix.");
+    }
+
+    BasicMatrixBatch<T> result = BasicMatrixBatch<T>::uninitialized(a.get_count(), a.get_rows(), b.get_cols());
+    gemm_batched(1.0, a, b, 0.0, result);
+
+    return result;
+}
 
-    std::shared_ptr<double[]> result_data(new double[result_rows * result_cols]());
-    for (int i = 0; i < result_rows; i++)
+/**
+ * Every chunk keeps its own buffers for padded operands, so they are allocated at most once per chunk.
+ */
+template <typename T>
+std::vector<BasicMatrix<T>> MatrixOperator::matmul_batched(const std::vector<BasicMatrixView<T>> &a, const std::vector<BasicMatrixView<T>> &b) const
+{
+    if (a.size() != b.size())
+    {
+        throw InvalidMatrixFormat("Batches must hold the same number of matrices.");
+    }
+
+    long long work = 0;
+    std::vector<BasicMatrix<T>> results;
+    results.reserve(a.size());
+    for (std::size_t i = 0; i < a.size(); i++)
     {
-        for (int j = 0; j < result_cols; j++)
+        if (a[i].get_cols() != b[i].get_rows())
         {
-            result_data[i * result_cols + j] = i < m1_view.get_rows()
-                                                   ? m1_view.get_element(i, j)
-                                                   : m2_view.get_element(i - m1_view.get_rows(), j);
+            throw InvalidMatrixFormat("Invalid format for matrix multiplication. Number of columns in the first matrix must match the number of rows in the second matrix.");
         }
+        work += static_cast<long long>(a[i].get_rows()) * b[i].get_cols() * a[i].get_cols();
+        results.emplace_back(a[i].get_rows(), b[i].get_cols());
     }
 
-    return MatrixView(result_data, result_rows, result_cols, 0, 0);
+    long long work_per_product = a.empty() ? 0 : work / static_cast<long long>(a.size());
+    for_each_batch_chunk(a.size(), work_per_product, [&](std::size_t first, std::size_t last)
+                         {
+        std::vector<T> a_copy;
+        std::vector<T> b_copy;
+        for (std::size_t i = first; i < last; i++)
+        {
+            int m = a[i].get_rows();
+            int k = a[i].get_cols();
+            int n = b[i].get_cols();
+
+            const T *a_data = a[i].data();
+            int a_row_stride = a[i].get_row_stride();
+            int a_col_stride = a[i].get_col_stride();
+            if (a[i].is_padded())
+            {
+                a_copy.resize(static_cast<std::size_t>(m) * k);
+                a[i].copy_to(a_copy.data(), k);
+                a_data = a_copy.data();
+                a_row_stride = k;
+                a_col_stride = 1;
+            }
+
+            const T *b_data = b[i].data();
+            int b_row_stride = b[i].get_row_stride();
+            int b_col_stride = b[i].get_col_stride();
+            if (b[i].is_padded())
+            {
+                b_copy.resize(static_cast<std::size_t>(k) * n);
+                b[i].copy_to(b_copy.data(), n);
+                b_data = b_copy.data();
+                b_row_stride = n;
+                b_col_stride = 1;
+            }
+
+            BasicMatrix<T> &result = results[i];
+            gemm_kernel.multiply(m, n, k,
+                                 a_data, a_row_stride, a_col_stride,
+                                 b_data, b_row_stride, b_col_stride,
+                                 result.data(), result.get_leading_dimension());
+        } });
+
+    return results;
 }
 
-MatrixView MatrixOperator::merge_side_to_side(const MatrixView &m1_view, const MatrixView &m2_view) const
+Matrix MatrixOperator::matmul_mixed(const FloatMatrix &m1, const FloatMatrix &m2) const
 {
-    if (m1_view.get_rows() != m2_view.get_rows())
+    return matmul_mixed(m1.view(), m2.view());
+}
+
+Matrix MatrixOperator::matmul_mixed(const FloatMatrixView &m1, const FloatMatrixView &m2) const
+{
+    if (m1.get_cols() != m2.get_rows())
     {
-        throw InvalidMatrixFormat("Matrices must have the same number of rows to merge side to side.");
+        throw InvalidMatrixFormat("Invalid format for matrix multiplication. Number of columns in the first matrix must match the number of rows in the second matrix.");
     }
 
-    int result_rows = m1_view.get_rows();
-    int result_cols = m1_view.get_cols() + m2_view.get_cols();
+    Matrix result = Matrix::uninitialized(m1.get_rows(), m2.get_cols());
+    gemm_mixed(1.0, m1, m2, 0.0, result);
+
+    return result;
+}
+
+void MatrixOperator::gemm_mixed(double alpha, const FloatMatrixView &a, const FloatMatrixView &b, double beta, Matrix &c) const
+{
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
+    {
+        throw InvalidMatrixFormat("Invalid format for gemm. A must be m x k, B k x n and C m x n.");
+    }
 
-    std::shared_ptr<double[]> result_data(new double[result_rows * result_cols](), std::default_delete<double[]>());
-    for (int i = 0; i < result_rows; i++)
+    // The operands are float, so they can not view C, but copies of C must keep their elements.
+    if (c.storage.use_count() > 1)
     {
-        for (int j = 0; j < result_cols; j++)
-        {
-            result_data[i * result_cols + j] = j < m1_view.get_cols()
-                                                   ? m1_view.get_element(i, j)
-                                                   : m2_view.get_element(i, j - m1_view.get_cols());
-        }
+        c.clone_storage(beta != 0.0);
     }
 
-    return MatrixView(result_data, result_rows, result_cols, 0, 0);
+    int m = a.get_rows();
+    int k = a.get_cols();
+    int n = b.get_cols();
+    double *out = c.data();
+    int out_ld = c.get_leading_dimension();
+
+    if (beta != 1.0)
+    {
+        scale_block(m, n, out, out_ld, beta);
+    }
+    if (alpha == 0.0 || k == 0)
+    {
+        return;
+    }
+
+    std::size_t a_size = a.is_padded() ? static_cast<std::size_t>(m) * k : 0;
+    std::size_t b_size = b.is_padded() ? static_cast<std::size_t>(k) * n : 0;
+    StrassenWorkspace workspace;
+    float *a_copy = workspace.reserve_for<float>(a_size + b_size);
+    float *b_copy = a_copy + a_size;
+
+    const float *a_data = a.is_padded() ? copy_dense(a, a_copy) : a.data();
+    int a_row_stride = a.is_padded() ? k : a.get_row_stride();
+    int a_col_stride = a.is_padded() ? 1 : a.get_col_stride();
+    const float *b_data = b.is_padded() ? copy_dense(b, b_copy) : b.data();
+    int b_row_stride = b.is_padded() ? n : b.get_row_stride();
+    int b_col_stride = b.is_padded() ? 1 : b.get_col_stride();
+
+    run_gemm_kernel(m, n, k,
+                    a_data, a_row_stride, a_col_stride,
+                    b_data, b_row_stride, b_col_stride,
+                    out, out_ld, alpha);
 }
 
-Matrix MatrixOperator::strassen(const Matrix &m1, const Matrix &m2, int threshold) const
+FloatMatrix MatrixOperator::matmul_quantized(const QuantizedMatrix &m1, const QuantizedMatrix &m2) const
 {
-    if (m1.get_rows() <= threshold)
+    if (m1.get_axis() != QuantizationAxis::PerRow || m2.get_axis() != QuantizationAxis::PerColumn)
     {
-        return naive_matmul(m1, m2);
+        throw std::invalid_argument("The first matrix must be quantized per row and the second one per column.");
     }
+    if (m1.get_cols() != m2.get_rows())
+    {
+        throw InvalidMatrixFormat("Invalid format for matrix multiplication. Number of columns in the first matrix must match the number of rows in the second matrix.");
+    }
+
+    int m = m1.get_rows();
+    int k = m1.get_cols();
+    int n = m2.get_cols();
+    FloatMatrix result(m, n);
+    float *out = result.data();
+    int out_ld = result.get_leading_dimension();
+
+    if (thread_pool != nullptr && thread_pool->size() > 1 && static_cast<long long>(m) * n * k >= parallel_threshold)
+    {
+        gemm_kernel.multiply_int8(*thread_pool, m, n, k,
+                                  m1.data(), k, m1.get_scales().data(),
+                                  m2.data(), n, m2.get_scales().data(),
+                                  out, out_ld);
+    }
+    else
+    {
+        gemm_kernel.multiply_int8(m, n, k,
+                                  m1.data(), k, m1.get_scales().data(),
+                                  m2.data(), n, m2.get_scales().data(),
+                                  out, out_ld);
+    }
+
+    return result;
+}
 
-    MatrixView m1_view = m1.create_square_view();
-    MatrixView m2_view = m2.create_square_view();
+template <typename T>
+BasicVector<T> MatrixOperator::gemv(const BasicMatrix<T> &a, const BasicVector<T> &x) const
+{
+    return gemv(a.view(), x);
+}
 
-    std::array<MatrixView, 4> m1_submatrices = m1_view.split();
-    std::array<MatrixView, 4> m2_submatrices = m2_view.split();
+template <typename T>
+BasicVector<T> MatrixOperator::gemv(const BasicMatrixView<T> &a, const BasicVector<T> &x) const
+{
+    BasicVector<T> result = BasicVector<T>::uninitialized(a.get_rows());
+    gemv(1.0, a, x, 0.0, result);
+    return result;
+}
 
-    MatrixView p1_view = strassen(m1_submatrices[0] + m1_submatrices[3], m2_submatrices[0] + m2_submatrices[3], threshold);
-    MatrixView p2_view = strassen(m1_submatrices[2] + m1_submatrices[3], m2_submatrices[0], threshold);
-    MatrixView p3_view = strassen(m1_submatrices[0], m2_submatrices[1] - m2_submatrices[3], threshold);
-    MatrixView p4_view = strassen(m1_submatrices[3], m2_submatrices[2] - m2_submatrices[0], threshold);
-    MatrixView p5_view = strassen(m1_submatrices[0] + m1_submatrices[1], m2_submatrices[3], threshold);
-    MatrixView p6_view = strassen(m1_submatrices[2] - m1_submatrices[0], m2_submatrices[0] + m2_submatrices[1], threshold);
-    MatrixView p7_view = strassen(m1_submatrices[1] - m1_submatrices[3], m2_submatrices[2] + m2_submatrices[3], threshold);
+/**
+ * Only the stored extent of a padded view is multiplied: its padding rows leave their elements of y at beta * y,
+ * and its padding columns meet elements of x that would be multiplied by zero.
+ */
+template <typename T>
+void MatrixOperator::gemv(double alpha, const BasicMatrixView<T> &a, const BasicVector<T> &x, double beta, BasicVector<T> &y) const
+{
+    if (a.get_cols() != x.get_size() || a.get_rows() != y.get_size())
+    {
+        throw InvalidMatrixFormat("Invalid format for matrix-vector multiplication. The matrix must have as many columns as x has elements and as many rows as y.");
+    }
+
+    // Hold on to x before y gets storage of its own, in case y is x
+    std::shared_ptr<const T[]> x_storage = x.storage;
+    if (y.storage.use_count() > 1)
+    {
+        y.clone_storage(beta != 0.0);
+    }
 
-    MatrixView c11_12_view = merge_side_to_side(p1_view + p4_view - p5_view + p7_view, p3_view + p5_view);
-    MatrixView c21_22_view = merge_side_to_side(p2_view + p4_view, p1_view - p2_view + p3_view + p6_view);
+    T *out = y.storage.get();
+    std::size_t size = static_cast<std::size_t>(y.get_size());
+    if (beta == 0.0)
+    {
+        std::fill(out, out + size, T(0));
+    }
+    else if (beta != 1.0)
+    {
+        SimdKernels::get<T>().scale(out, static_cast<T>(beta), out, size);
+    }
 
-    MatrixView padded_result_view = merge_top_bottom(c11_12_view, c21_22_view);
+    int m = std::min(a.get_rows(), a.get_data_rows());
+    int n = std::min(a.get_cols(), a.get_data_cols());
+    if (alpha == 0.0 || m == 0 || n == 0)
+    {
+        return;
+    }
 
-    return padded_result_view.convert_to_matrix(0, m1.get_rows(), 0, m2.get_cols());
+    if (runs_in_parallel(static_cast<std::size_t>(m) * n))
+    {
+        VectorKernel::gemv(*thread_pool, m, n, static_cast<T>(alpha), a.data(), a.get_row_stride(), a.get_col_stride(), x_storage.get(), out);
+    }
+    else
+    {
+        VectorKernel::gemv(m, n, static_cast<T>(alpha), a.data(), a.get_row_stride(), a.get_col_stride(), x_storage.get(), out);
+    }
 }
 
-MatrixView MatrixOperator::strassen(const MatrixView &m1_view, const MatrixView &m2_view, int threshold) const
+template <typename T>
+void MatrixOperator::ger(double alpha, const BasicVector<T> &x, const BasicVector<T> &y, BasicMatrix<T> &a) const
 {
-    if (m1_view.get_rows() <= threshold)
+    if (a.get_rows() != x.get_size() || a.get_cols() != y.get_size())
     {
-        return naive_matmul(m1_view, m2_view);
+        throw InvalidMatrixFormat("Invalid format for rank-1 update. The matrix must have as many rows as x has elements and as many columns as y.");
     }
 
-    std::array<MatrixView, 4> m1_submatrices = m1_view.split();
-    std::array<MatrixView, 4> m2_submatrices = m2_view.split();
+    int m = a.get_rows();
+    int n = a.get_cols();
+    if (runs_in_parallel(static_cast<std::size_t>(m) * n))
+    {
+        VectorKernel::ger(*thread_pool, m, n, static_cast<T>(alpha), x.data(), y.data(), a.data(), a.get_leading_dimension());
+    }
+    else
+    {
+        VectorKernel::ger(m, n, static_cast<T>(alpha), x.data(), y.data(), a.data(), a.get_leading_dimension());
+    }
+}
 
-    MatrixView p1_view = strassen(m1_submatrices[0] + m1_submatrices[3], m2_submatrices[0] + m2_submatrices[3], threshold);
-    MatrixView p2_view = strassen(m1_submatrices[2] + m1_submatrices[3], m2_submatrices[0], threshold);
-    MatrixView p3_view = strassen(m1_submatrices[0], m2_submatrices[1] - m2_submatrices[3], threshold);
-    MatrixView p4_view = strassen(m1_submatrices[3], m2_submatrices[2] - m2_submatrices[0], threshold);
-    MatrixView p5_view = strassen(m1_submatrices[0] + m1_submatrices[1], m2_submatrices[3], threshold);
-    MatrixView p6_view = strassen(m1_submatrices[2] - m1_submatrices[0], m2_submatrices[0] + m2_submatrices[1], threshold);
-    MatrixView p7_view = strassen(m1_submatrices[1] - m1_submatrices[3], m2_submatrices[2] + m2_submatrices[3], threshold);
+template <typename T>
+T MatrixOperator::dot(const BasicVector<T> &x, const BasicVector<T> &y) const
+{
+    if (x.get_size() != y.get_size())
+    {
+        throw InvalidMatrixFormat("Vectors must have the same size for a dot product.");
+    }
 
-    MatrixView c11_12_view = merge_side_to_side(p1_view + p4_view - p5_view + p7_view, p3_view + p5_view);
-    MatrixView c21_22_view = merge_side_to_side(p2_view + p4_view, p1_view - p2_view + p3_view + p6_view);
+    std::size_t n = static_cast<std::size_t>(x.get_size());
+    if (runs_in_parallel(n))
+    {
+        return VectorKernel::dot(*thread_pool, n, x.data(), y.data());
+    }
+    return VectorKernel::dot(n, x.data(), y.data());
+}
 
-    MatrixView padded_result_view = merge_top_bottom(c11_12_view, c21_22_view);
+template <typename T>
+void MatrixOperator::axpy(double alpha, const BasicVector<T> &x, BasicVector<T> &y) const
+{
+    if (x.get_size() != y.get_size())
+    {
+        throw InvalidMatrixFormat("Vectors must have the same size for axpy.");
+    }
+
+    std::shared_ptr<const T[]> x_storage = x.storage;
+    T *out = y.data();
+    std::size_t n = static_cast<std::size_t>(y.get_size());
+    if (runs_in_parallel(n))
+    {
+        VectorKernel::axpy(*thread_pool, n, static_cast<T>(alpha), x_storage.get(), out);
+    }
+    else
+    {
+        VectorKernel::axpy(n, static_cast<T>(alpha), x_storage.get(), out);
+    }
+}
 
-    return padded_result_view;
+template <typename T>
+BasicVector<T> MatrixOperator::spmv(const BasicSparseMatrix<T> &a, const BasicVector<T> &x) const
+{
+    BasicVector<T> result = BasicVector<T>::uninitialized(a.get_rows());
+    spmv(1.0, a, x, 0.0, result);
+    return result;
 }
 
-Matrix MatrixOperator::naive_matmul(const Matrix &m1, const Matrix &m2) const
+template <typename T>
+void MatrixOperator::spmv(double alpha, const BasicSparseMatrix<T> &a, const BasicVector<T> &x, double beta, BasicVector<T> &y) const
 {
-    int result_cols = m1.get_cols();
-    int result_rows = m2.get_rows();
+    if (a.get_cols() != x.get_size() || a.get_rows() != y.get_size())
+    {
+        throw InvalidMatrixFormat("Invalid format for sparse matrix-vector multiplication. The matrix must have as many columns as x has elements and as many rows as y.");
+    }
+
+    // Hold on to x before y gets storage of its own, in case y is x
+    std::shared_ptr<const T[]> x_storage = x.storage;
+    if (y.storage.use_count() > 1)
+    {
+        y.clone_storage(beta != 0.0);
+    }
+
+    int m = a.get_rows();
+    T *out = y.storage.get();
+    if (beta != 1.0)
+    {
+        scale_block(1, m, out, m, beta);
+    }
+    if (alpha == 0.0)
+    {
+        return;
+    }
 
-    Matrix result(result_rows, result_cols);
-    for (int i = 0; i < result_rows; i++)
+    const std::size_t *offsets = a.get_offsets().data();
+    const int *indices = a.get_indices().data();
+    const T *values = a.get_values().data();
+    bool parallel = runs_in_parallel(a.get_nonzeros());
+    if (a.get_format() == SparseFormat::CSR)
     {
-        for (int j = 0; j < result_cols; j++)
+        if (parallel)
         {
-            double value = 0;
-            for (int k = 0; k < m1.get_cols(); k++)
-            {
-                value += m1(i, k) * m2(k, j);
-            }
-            result(i, j) = value;
+            SparseKernel::csr_spmv(*thread_pool, m, offsets, indices, values, static_cast<T>(alpha), x_storage.get(), out);
+        }
+        else
+        {
+            SparseKernel::csr_spmv(m, offsets, indices, values, static_cast<T>(alpha), x_storage.get(), out);
         }
     }
+    else if (parallel)
+    {
+        SparseKernel::csc_spmv(*thread_pool, m, a.get_cols(), offsets, indices, values, static_cast<T>(alpha), x_storage.get(), out);
+    }
+    else
+    {
+        SparseKernel::csc_spmv(m, a.get_cols(), offsets, indices, values, static_cast<T>(alpha), x_storage.get(), out);
+    }
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::spmm(const BasicSparseMatrix<T> &a, const BasicMatrix<T> &b) const
+{
+    return spmm(a, b.view());
+}
 
+template <typename T>
+BasicMatrix<T> MatrixOperator::spmm(const BasicSparseMatrix<T> &a, const BasicMatrixView<T> &b) const
+{
+    BasicMatrix<T> result = BasicMatrix<T>::uninitialized(a.get_rows(), b.get_cols());
+    spmm(1.0, a, b, 0.0, result);
     return result;
 }
 
-MatrixView MatrixOperator::naive_matmul(const MatrixView &m1_view, const MatrixView &m2_view) const
+template <typename T>
+void MatrixOperator::spmm(double alpha, const BasicSparseMatrix<T> &a, const BasicMatrixView<T> &b, double beta, BasicMatrix<T> &c) const
+{
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
+    {
+        throw InvalidMatrixFormat("Invalid format for sparse matrix multiplication. A must be m x k, B k x n and C m x n.");
+    }
+
+    // b keeps the storage it views alive, so c may get storage of its own first.
+    if (c.storage.use_count() > 1)
+    {
+        c.clone_storage(beta != 0.0);
+    }
+
+    int m = a.get_rows();
+    int k = a.get_cols();
+    int n = b.get_cols();
+    T *out = c.data();
+    int out_ld = c.get_leading_dimension();
+
+    if (beta != 1.0)
+    {
+        scale_block(m, n, out, out_ld, beta);
+    }
+    if (alpha == 0.0 || a.get_nonzeros() == 0 || n == 0)
+    {
+        return;
+    }
+
+    bool dense_rows = !b.is_padded() && b.get_col_stride() == 1;
+    StrassenWorkspace workspace;
+    T *b_copy = workspace.reserve_for<T>(dense_rows ? 0 : static_cast<std::size_t>(k) * n);
+    const T *b_data = dense_rows ? b.data() : copy_dense(b, b_copy);
+    int b_row_stride = dense_rows ? b.get_row_stride() : n;
+
+    const std::size_t *offsets = a.get_offsets().data();
+    const int *indices = a.get_indices().data();
+    const T *values = a.get_values().data();
+    bool parallel = runs_in_parallel(a.get_nonzeros() * static_cast<std::size_t>(n));
+    if (a.get_format() == SparseFormat::CSR)
+    {
+        if (parallel)
+        {
+            SparseKernel::csr_spmm(*thread_pool, m, n, offsets, indices, values, static_cast<T>(alpha), b_data, b_row_stride, out, out_ld);
+        }
+        else
+        {
+            SparseKernel::csr_spmm(m, n, offsets, indices, values, static_cast<T>(alpha), b_data, b_row_stride, out, out_ld);
+        }
+    }
+    else if (parallel)
+    {
+        SparseKernel::csc_spmm(*thread_pool, k, n, offsets, indices, values, static_cast<T>(alpha), b_data, b_row_stride, out, out_ld);
+    }
+    else
+    {
+        SparseKernel::csc_spmm(k, n, offsets, indices, values, static_cast<T>(alpha), b_data, b_row_stride, out, out_ld);
+    }
+}
+
+template <typename T>
+T MatrixOperator::hadamard_product(const BasicMatrix<T> &m1, const BasicMatrix<T> &m2) const
+{
+    if (m1.get_rows() != m2.get_rows() || m1.get_cols() != m2.get_cols())
+    {
+        throw InvalidMatrixFormat("Invalid format for matrix addition. Number of rows and number of columns must match.");
+    }
+
+    const T *x = m1.data();
+    const T *y = m2.data();
+    int rows = m1.get_rows();
+    int cols = m1.get_cols();
+    int x_ld = m1.get_leading_dimension();
+    int y_ld = m2.get_leading_dimension();
+
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    auto dot_rows = [&](std::size_t first_row, std::size_t last_row)
+    {
+        T sum = 0;
+        for (std::size_t i = first_row; i < last_row; i++)
+        {
+            sum += kernels.dot(x + i * x_ld, y + i * y_ld, cols);
+        }
+        return sum;
+    };
+
+    if (thread_pool == nullptr || thread_pool->size() <= 1)
+    {
+        if (x_ld == cols && y_ld == cols)
+        {
+            return kernels.dot(x, y, static_cast<std::size_t>(rows) * cols);
+        }
+        return dot_rows(0, rows);
+    }
+
+    return thread_pool->parallel_reduce(
+        0, rows, rows_per_chunk(cols), T(0), dot_rows,
+        [](T left, T right)
+        { return left + right; });
+}
+
+template <typename T>
+BasicMatrix<T> MatrixOperator::transpose(const BasicMatrix<T> &m) const
+{
+    if (!runs_in_parallel(static_cast<std::size_t>(m.get_rows()) * m.get_cols()))
+    {
+        return m.transpose();
+    }
+
+    BasicMatrix<T> transposed = BasicMatrix<T>::uninitialized(m.get_cols(), m.get_rows());
+    TransposeKernel::transpose(*thread_pool, m.get_rows(), m.get_cols(),
+                               m.data(), m.get_leading_dimension(),
+                               transposed.data(), transposed.get_leading_dimension());
+
+    return transposed;
+}
+
+template <typename T>
+void MatrixOperator::transpose_in_place(BasicMatrix<T> &m) const
 {
+    if (m.get_rows() != m.get_cols())
+    {
+        throw InvalidMatrixFormat("Matrix must be square to transpose in place.");
+    }
+
+    if (!runs_in_parallel(static_cast<std::size_t>(m.get_rows()) * m.get_cols()))
+    {
+        m.transpose_in_place();
+        return;
+    }
+
+    TransposeKernel::transpose_in_place(*thread_pool, m.get_rows(), m.data(), m.get_leading_dimension());
+}
+
+template <typename T>
+BasicMatrixView<T> MatrixOperator::merge_top_bottom(const BasicMatrixView<T> &m1_view, const BasicMatrixView<T> &m2_view) const
+{
+    if (m1_view.get_cols() != m2_view.get_cols())
+    {
+        throw InvalidMatrixFormat("Matrices must have the same number of columns to merge top to bottom.");
+    }
+
+    int result_rows = m1_view.get_rows() + m2_view.get_rows();
+    int result_cols = m1_view.get_cols();
+
+    std::shared_ptr<T[]> result_data = MatrixAllocator::get_default().allocate_shared<T>(static_cast<std::size_t>(result_rows) * result_cols);
+    for_each_chunk(result_rows, rows_per_chunk(result_cols), [&](std::size_t first_row, std::size_t last_row)
+                   {
+        int first = static_cast<int>(first_row);
+        int last = static_cast<int>(last_row);
+        int top_rows = m1_view.get_rows();
+
+        if (first < top_rows)
+        {
+            m1_view.sub_view(first, 0, std::min(last, top_rows) - first, result_cols)
+                .copy_to(result_data.get() + first * result_cols, result_cols);
+        }
+        if (last > top_rows)
+        {
+            int bottom_first = std::max(first, top_rows);
+            m2_view.sub_view(bottom_first - top_rows, 0, last - bottom_first, result_cols)
+                .copy_to(result_data.get() + bottom_first * result_cols, result_cols);
+        } });
+
+    return BasicMatrixView<T>(result_data, result_rows, result_cols, 0, 0);
+}
+
+template <typename T>
+BasicMatrixView<T> MatrixOperator::merge_side_to_side(const BasicMatrixView<T> &m1_view, const BasicMatrixView<T> &m2_view) const
+{
+    if (m1_view.get_rows() != m2_view.get_rows())
+    {
+        throw InvalidMatrixFormat("Matrices must have the same number of rows to merge side to side.");
+    }
+
     int result_rows = m1_view.get_rows();
-    int result_cols = m2_view.get_cols();
+    int result_cols = m1_view.get_cols() + m2_view.get_cols();
+
+    std::shared_ptr<T[]> result_data = MatrixAllocator::get_default().allocate_shared<T>(static_cast<std::size_t>(result_rows) * result_cols);
+    for_each_chunk(result_rows, rows_per_chunk(result_cols), [&](std::size_t first_row, std::size_t last_row)
+                   {
+        int first = static_cast<int>(first_row);
+        int count = static_cast<int>(last_row - first_row);
+        T *out = result_data.get() + first * result_cols;
+
+        m1_view.sub_view(first, 0, count, m1_view.get_cols()).copy_to(out, result_cols);
+        m2_view.sub_view(first, 0, count, m2_view.get_cols()).copy_to(out + m1_view.get_cols(), result_cols); });
+
+    return BasicMatrixView<T>(result_data, result_rows, result_cols, 0, 0);
+}
+
+/**
+ * Strassen-Winograd: 8 operand additions, 7 products and 7 additions to combine them.
+ *
+ * Odd dimensions are handled by dynamic peeling: the recursion runs on the even leading part and the last
+ * row, column or inner index is fixed up afterwards with thin GEMM calls, so no operand is ever padded.
+ *
+ * The serial schedule follows Douglas et al. (1994). Products are written straight into the quadrants of C,
+ * which double as scratch, so a level only needs two temporaries: X for sums of A quadrants and Y for sums of
+ * B quadrants. A parallel level cannot reuse X and Y between products, so it keeps all eight operand sums and
+ * three of the products in separate blocks.
+ */
+template <typename T>
+void MatrixOperator::strassen(int m, int k, int n,
+                              const T *a, int a_row_stride,
+                              const T *b, int b_row_stride,
+                              T *c, int c_row_stride,
+                              int threshold, int parallel_depth, T *workspace) const
+{
+    if (std::min({m, k, n}) <= std::max(threshold, 1))
+    {
+        fill_block(m, n, c, c_row_stride, T(0));
+        run_gemm_kernel(m, n, k, a, a_row_stride, b, b_row_stride, c, c_row_stride);
+        return;
+    }
+
+    int mh = m / 2;
+    int kh = k / 2;
+    int nh = n / 2;
+
+    int as = a_row_stride;
+    int bs = b_row_stride;
+    int cs = c_row_stride;
+
+    const T *a11 = a;
+    const T *a12 = a + kh;
+    const T *a21 = a + mh * as;
+    const T *a22 = a21 + kh;
+
+    const T *b11 = b;
+    const T *b12 = b + nh;
+    const T *b21 = b + kh * bs;
+    const T *b22 = b21 + nh;
+
+    T *c11 = c;
+    T *c12 = c + nh;
+    T *c21 = c + mh * cs;
+    T *c22 = c21 + nh;
+
+    std::size_t a_block = static_cast<std::size_t>(mh) * kh;
+    std::size_t b_block = static_cast<std::size_t>(kh) * nh;
+    std::size_t c_block = static_cast<std::size_t>(mh) * nh;
 
-    std::shared_ptr<double[]> result_data(new double[result_rows * result_cols]());
-    for (int i = 0; i < result_rows; i++)
+    if (thread_pool != nullptr && parallel_depth > 0)
     {
-        for (int j = 0; j < result_cols; j++)
+        T *s1 = workspace;
+        T *s2 = s1 + a_block;
+        T *s3 = s2 + a_block;
+        T *s4 = s3 + a_block;
+        T *t1 = s4 + a_block;
+        T *t2 = t1 + b_block;
+        T *t3 = t2 + b_block;
+        T *t4 = t3 + b_block;
+        T *p1 = t4 + b_block;
+        T *p3 = p1 + c_block;
+        T *p4 = p3 + c_block;
+        T *child_workspace = p4 + c_block;
+        std::size_t child_workspace_size = StrassenWorkspace::required_size(mh, kh, nh, threshold, parallel_depth - 1);
+
+        combine_blocks(mh, kh, a21, as, a22, as, 1, s1, kh);
+        combine_blocks(mh, kh, s1, kh, a11, as, -1, s2, kh);
+        combine_blocks(mh, kh, a11, as, a21, as, -1, s3, kh);
+        combine_blocks(mh, kh, a12, as, s2, kh, -1, s4, kh);
+        combine_blocks(kh, nh, b12, bs, b11, bs, -1, t1, nh);
+        combine_blocks(kh, nh, b22, bs, t1, nh, -1, t2, nh);
+        combine_blocks(kh, nh, b22, bs, b12, bs, -1, t3, nh);
+        combine_blocks(kh, nh, t2, nh, b21, bs, -1, t4, nh);
+
+        struct Product
+        {
+            const T *lhs;
+            int lhs_stride;
+            const T *rhs;
+            int rhs_stride;
+            T *out;
+            int out_stride;
+        };
+
+        // P2, P5, P6 and P7 go straight into the quadrants of C.
+        const std::array<Product, 7> products = {{
+            {a11, as, b11, bs, p1, nh},
+            {a12, as, b21, bs, c11, cs},
+            {s4, kh, b22, bs, p3, nh},
+            {a22, as, t4, nh, p4, nh},
+            {s1, kh, t1, nh, c22, cs},
+            {s2, kh, t2, nh, c12, cs},
+            {s3, kh, t3, nh, c21, cs},
+        }};
+
+        // The tasks reference this frame, so every queued task is waited for before an exception leaves it:
+        // a failed enqueue stops submitting, a failed product is rethrown once the others are done.
+        std::exception_ptr failure;
+        std::vector<std::future<void>> futures;
+        futures.reserve(products.size());
+        try
+        {
+            for (int i = 0; i < 7; i++)
+            {
+                futures.emplace_back(thread_pool->enqueue([&, i]()
+                                                          {
+                    const Product &product = products[i];
+                    strassen(mh, kh, nh, product.lhs, product.lhs_stride, product.rhs, product.rhs_stride, product.out, product.out_stride,
+                             threshold, parallel_depth - 1, child_workspace + i * child_workspace_size); }));
+            }
+        }
+        catch (...)
         {
-            double value = 0;
-            for (int k = 0; k < m1_view.get_cols(); k++)
+            failure = std::current_exception();
+        }
+
+        for (auto &future : futures)
+        {
+            // get() leaves the future invalid. An exception from another task run while helping does not, keep waiting then.
+            while (future.valid())
             {
-                value += m1_view.get_element(i, k) * m2_view.get_element(k, j);
+                try
+                {
+                    thread_pool->wait_and_help(future);
+                }
+                catch (...)
+                {
+                    if (!failure)
+                    {
+                        failure = std::current_exception();
+                    }
+                }
             }
-            result_data[i * result_cols + j] = value;
         }
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+
+        combine_blocks(mh, nh, p1, nh, c12, cs, 1, c12, cs);  // U2 = P1 + P6
+        combine_blocks(mh, nh, c12, cs, c21, cs, 1, c21, cs); // U3 = U2 + P7
+        combine_blocks(mh, nh, c12, cs, c22, cs, 1, c12, cs); // U4 = U2 + P5
+        combine_blocks(mh, nh, c21, cs, c22, cs, 1, c22, cs); // C22 = U3 + P5
+        combine_blocks(mh, nh, c12, cs, p3, nh, 1, c12, cs);  // C12 = U4 + P3
+        combine_blocks(mh, nh, c21, cs, p4, nh, -1, c21, cs); // C21 = U3 - P4
+        combine_blocks(mh, nh, p1, nh, c11, cs, 1, c11, cs);  // C11 = P1 + P2
     }
+    else
+    {
+        T *x = workspace;
+        T *y = x + std::max(a_block, c_block);
+        T *child_workspace = y + b_block;
+
+        auto product = [&](const T *lhs, int lhs_stride, const T *rhs, int rhs_stride, T *out, int out_stride)
+        {
+            strassen(mh, kh, nh, lhs, lhs_stride, rhs, rhs_stride, out, out_stride, threshold, 0, child_workspace);
+        };
 
-    return MatrixView(result_data, result_rows, result_cols, 0, 0);
+        combine_blocks(mh, kh, a11, as, a21, as, -1, x, kh);   // S3 = A11 - A21
+        combine_blocks(kh, nh, b22, bs, b12, bs, -1, y, nh);   // T3 = B22 - B12
+        product(x, kh, y, nh, c21, cs);                        // P7 = S3 * T3
+        combine_blocks(mh, kh, a21, as, a22, as, 1, x, kh);    // S1 = A21 + A22
+        combine_blocks(kh, nh, b12, bs, b11, bs, -1, y, nh);   // T1 = B12 - B11
+        product(x, kh, y, nh, c22, cs);                        // P5 = S1 * T1
+        combine_blocks(mh, kh, x, kh, a11, as, -1, x, kh);     // S2 = S1 - A11
+        combine_blocks(kh, nh, b22, bs, y, nh, -1, y, nh);     // T2 = B22 - T1
+        product(x, kh, y, nh, c12, cs);                        // P6 = S2 * T2
+        combine_blocks(mh, kh, a12, as, x, kh, -1, x, kh);     // S4 = A12 - S2
+        product(x, kh, b22, bs, c11, cs);                      // P3 = S4 * B22
+        product(a11, as, b11, bs, x, nh);                      // P1 = A11 * B11
+        combine_blocks(mh, nh, x, nh, c12, cs, 1, c12, cs);    // U2 = P1 + P6
+        combine_blocks(mh, nh, c12, cs, c21, cs, 1, c21, cs);  // U3 = U2 + P7
+        combine_blocks(mh, nh, c12, cs, c22, cs, 1, c12, cs);  // U4 = U2 + P5
+        combine_blocks(mh, nh, c21, cs, c22, cs, 1, c22, cs);  // C22 = U3 + P5
+        combine_blocks(mh, nh, c12, cs, c11, cs, 1, c12, cs);  // C12 = U4 + P3
+        combine_blocks(kh, nh, y, nh, b21, bs, -1, y, nh);     // T4 = T2 - B21
+        product(a22, as, y, nh, c11, cs);                      // P4 = A22 * T4
+        combine_blocks(mh, nh, c21, cs, c11, cs, -1, c21, cs); // C21 = U3 - P4
+        product(a12, as, b21, bs, c11, cs);                    // P2 = A12 * B21
+        combine_blocks(mh, nh, x, nh, c11, cs, 1, c11, cs);    // C11 = P1 + P2
+    }
+
+    int m_even = 2 * mh;
+    int k_even = 2 * kh;
+    int n_even = 2 * nh;
+
+    // Odd k: add the rank-1 contribution of the last column of A and the last row of B.
+    if (k != k_even)
+    {
+        run_gemm_kernel(m_even, n_even, 1, a + k_even, as, b + k_even * bs, bs, c, cs);
+    }
+
+    // Odd n: the last column of C is A times the last column of B.
+    if (n != n_even)
+    {
+        fill_block(m, 1, c + n_even, cs, T(0));
+        run_gemm_kernel(m, 1, k, a, as, b + n_even, bs, c + n_even, cs);
+    }
+
+    // Odd m: the last row of C, without the corner that the column fix-up already covered.
+    if (m != m_even)
+    {
+        fill_block(1, n_even, c + m_even * cs, cs, T(0));
+        run_gemm_kernel(1, n_even, k, a + m_even * as, as, b, bs, c + m_even * cs, cs);
+    }
+}
+
+void MatrixOperator::for_each_chunk(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &fn) const
+{
+    if (thread_pool == nullptr || thread_pool->size() <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+
+    thread_pool->parallel_for(0, count, grain, fn);
+}
+
+void MatrixOperator::for_each_batch_chunk(std::size_t count, long long work_per_product, const std::function<void(std::size_t, std::size_t)> &fn) const
+{
+    long long work = std::max(work_per_product, 1LL);
+    if (static_cast<long long>(count) * work < parallel_threshold)
+    {
+        fn(0, count);
+        return;
+    }
+
+    for_each_chunk(count, static_cast<std::size_t>(std::max(BATCH_GRAIN / work, 1LL)), fn);
+}
+
+std::size_t MatrixOperator::rows_per_chunk(int cols)
+{
+    return std::max<std::size_t>(1, ELEMENTWISE_GRAIN / std::max(cols, 1));
 }
+
+bool MatrixOperator::runs_in_parallel(std::size_t elements) const
+{
+    return thread_pool != nullptr && thread_pool->size() > 1 && elements > ELEMENTWISE_GRAIN;
+}
+
+template <typename T>
+void MatrixOperator::run_gemm_kernel(int m, int n, int k,
+                                     const T *a, int a_row_stride,
+                                     const T *b, int b_row_stride,
+                                     T *c, int c_row_stride) const
+{
+    run_gemm_kernel(m, n, k, a, a_row_stride, 1, b, b_row_stride, 1, c, c_row_stride, 1.0);
+}
+
+template <typename S, typename T>
+void MatrixOperator::run_gemm_kernel(int m, int n, int k,
+                                     const S *a, int a_row_stride, int a_col_stride,
+                                     const S *b, int b_row_stride, int b_col_stride,
+                                     T *c, int c_row_stride, double alpha) const
+{
+    if (thread_pool != nullptr && thread_pool->size() > 1 && static_cast<long long>(m) * n * k >= parallel_threshold)
+    {
+        gemm_kernel.multiply(*thread_pool, m, n, k, a, a_row_stride, a_col_stride, b, b_row_stride, b_col_stride, c, c_row_stride, alpha);
+    }
+    else
+    {
+        gemm_kernel.multiply(m, n, k, a, a_row_stride, a_col_stride, b, b_row_stride, b_col_stride, c, c_row_stride, alpha);
+    }
+}
+
+/**
+ * Views stored column by column, e.g. transposes, go through the transpose kernel, anything else through copy_to.
+ */
+template <typename T>
+const T *MatrixOperator::copy_dense(const BasicMatrixView<T> &view, T *out) const
+{
+    int rows = view.get_rows();
+    int cols = view.get_cols();
+    if (view.is_padded() || view.get_row_stride() != 1)
+    {
+        view.copy_to(out, cols);
+        return out;
+    }
+
+    if (runs_in_parallel(static_cast<std::size_t>(rows) * cols))
+    {
+        TransposeKernel::transpose(*thread_pool, cols, rows, view.data(), view.get_col_stride(), out, cols);
+    }
+    else
+    {
+        TransposeKernel::transpose(cols, rows, view.data(), view.get_col_stride(), out, cols);
+    }
+    return out;
+}
+
+template BasicMatrix<float> MatrixOperator::add(const BasicMatrix<float> &, const BasicMatrix<float> &) const;
+template BasicMatrix<float> MatrixOperator::matmul(const BasicMatrix<float> &, const BasicMatrix<float> &) const;
+template BasicMatrix<float> MatrixOperator::matmul(const BasicMatrix<float> &, const BasicMatrix<float> &, StrassenWorkspace &) const;
+template BasicMatrix<float> MatrixOperator::matmul(const BasicMatrixView<float> &, const BasicMatrixView<float> &) const;
+template BasicMatrix<float> MatrixOperator::matmul(const BasicMatrixView<float> &, const BasicMatrixView<float> &, StrassenWorkspace &) const;
+template void MatrixOperator::gemm(double, const BasicMatrix<float> &, const BasicMatrix<float> &, double, BasicMatrix<float> &) const;
+template void MatrixOperator::gemm(double, const BasicMatrix<float> &, const BasicMatrix<float> &, double, BasicMatrix<float> &, StrassenWorkspace &) const;
+template void MatrixOperator::gemm(double, const BasicMatrixView<float> &, const BasicMatrixView<float> &, double, BasicMatrix<float> &) const;
+template void MatrixOperator::gemm(double, const BasicMatrixView<float> &, const BasicMatrixView<float> &, double, BasicMatrix<float> &, StrassenWorkspace &) const;
+template float MatrixOperator::hadamard_product(const BasicMatrix<float> &, const BasicMatrix<float> &) const;
+template BasicMatrix<float> MatrixOperator::transpose(const BasicMatrix<float> &) const;
+template void MatrixOperator::transpose_in_place(BasicMatrix<float> &) const;
+template BasicMatrixView<float> MatrixOperator::merge_top_bottom(const BasicMatrixView<float> &, const BasicMatrixView<float> &) const;
+template BasicMatrixView<float> MatrixOperator::merge_side_to_side(const BasicMatrixView<float> &, const BasicMatrixView<float> &) const;
+template void MatrixOperator::gemm_batched(double, const BasicMatrixBatch<float> &, const BasicMatrixBatch<float> &, double, BasicMatrixBatch<float> &) const;
+template BasicMatrixBatch<float> MatrixOperator::matmul_batched(const BasicMatrixBatch<float> &, const BasicMatrixBatch<float> &) const;
+template std::vector<BasicMatrix<float>> MatrixOperator::matmul_batched(const std::vector<BasicMatrixView<float>> &, const std::vector<BasicMatrixView<float>> &) const;
+template BasicVector<float> MatrixOperator::gemv(const BasicMatrix<float> &, const BasicVector<float> &) const;
+template BasicVector<float> MatrixOperator::gemv(const BasicMatrixView<float> &, const BasicVector<float> &) const;
+template void MatrixOperator::gemv(double, const BasicMatrixView<float> &, const BasicVector<float> &, double, BasicVector<float> &) const;
+template void MatrixOperator::ger(double, const BasicVector<float> &, const BasicVector<float> &, BasicMatrix<float> &) const;
+template float MatrixOperator::dot(const BasicVector<float> &, const BasicVector<float> &) const;
+template void MatrixOperator::axpy(double, const BasicVector<float> &, BasicVector<float> &) const;
+template BasicVector<float> MatrixOperator::spmv(const BasicSparseMatrix<float> &, const BasicVector<float> &) const;
+template void MatrixOperator::spmv(double, const BasicSparseMatrix<float> &, const BasicVector<float> &, double, BasicVector<float> &) const;
+template BasicMatrix<float> MatrixOperator::spmm(const BasicSparseMatrix<float> &, const BasicMatrix<float> &) const;
+template BasicMatrix<float> MatrixOperator::spmm(const BasicSparseMatrix<float> &, const BasicMatrixView<float> &) const;
+template void MatrixOperator::spmm(double, const BasicSparseMatrix<float> &, const BasicMatrixView<float> &, double, BasicMatrix<float> &) const;
+
+template BasicMatrix<double> MatrixOperator::add(const BasicMatrix<double> &, const BasicMatrix<double> &) const;
+template BasicMatrix<double> MatrixOperator::matmul(const BasicMatrix<double> &, const BasicMatrix<double> &) const;
+template BasicMatrix<double> MatrixOperator::matmul(const BasicMatrix<double> &, const BasicMatrix<double> &, StrassenWorkspace &) const;
+template BasicMatrix<double> MatrixOperator::matmul(const BasicMatrixView<double> &, const BasicMatrixView<double> &) const;
+template BasicMatrix<double> MatrixOperator::matmul(const BasicMatrixView<double> &, const BasicMatrixView<double> &, StrassenWorkspace &) const;
+template void MatrixOperator::gemm(double, const BasicMatrix<double> &, const BasicMatrix<double> &, double, BasicMatrix<double> &) const;
+template void MatrixOperator::gemm(double, const BasicMatrix<double> &, const BasicMatrix<double> &, double, BasicMatrix<double> &, StrassenWorkspace &) const;
+template void MatrixOperator::gemm(double, const BasicMatrixView<double> &, const BasicMatrixView<double> &, double, BasicMatrix<double> &) const;
+template void MatrixOperator::gemm(double, const BasicMatrixView<double> &, const BasicMatrixView<double> &, double, BasicMatrix<double> &, StrassenWorkspace &) const;
+template double MatrixOperator::hadamard_product(const BasicMatrix<double> &, const BasicMatrix<double> &) const;
+template BasicMatrix<double> MatrixOperator::transpose(const BasicMatrix<double> &) const;
+template void MatrixOperator::transpose_in_place(BasicMatrix<double> &) const;
+template BasicMatrixView<double> MatrixOperator::merge_top_bottom(const BasicMatrixView<double> &, const BasicMatrixView<double> &) const;
+template BasicMatrixView<double> MatrixOperator::merge_side_to_side(const BasicMatrixView<double> &, const BasicMatrixView<double> &) const;
+template void MatrixOperator::gemm_batched(double, const BasicMatrixBatch<double> &, const BasicMatrixBatch<double> &, double, BasicMatrixBatch<double> &) const;
+template BasicMatrixBatch<double> MatrixOperator::matmul_batched(const BasicMatrixBatch<double> &, const BasicMatrixBatch<double> &) const;
+template std::vector<BasicMatrix<double>> MatrixOperator::matmul_batched(const std::vector<BasicMatrixView<double>> &, const std::vector<BasicMatrixView<double>> &) const;
+template BasicVector<double> MatrixOperator::gemv(const BasicMatrix<double> &, const BasicVector<double> &) const;
+template BasicVector<double> MatrixOperator::gemv(const BasicMatrixView<double> &, const BasicVector<double> &) const;
+template void MatrixOperator::gemv(double, const BasicMatrixView<double> &, const BasicVector<double> &, double, BasicVector<double> &) const;
+template void MatrixOperator::ger(double, const BasicVector<double> &, const BasicVector<double> &, BasicMatrix<double> &) const;
+template double MatrixOperator::dot(const BasicVector<double> &, const BasicVector<double> &) const;
+template void MatrixOperator::axpy(double, const BasicVector<double> &, BasicVector<double> &) const;
+template BasicVector<double> MatrixOperator::spmv(const BasicSparseMatrix<double> &, const BasicVector<double> &) const;
+template void MatrixOperator::spmv(double, const BasicSparseMatrix<double> &, const BasicVector<double> &, double, BasicVector<double> &) const;
+template BasicMatrix<double> MatrixOperator::spmm(const BasicSparseMatrix<double> &, const BasicMatrix<double> &) const;
+template BasicMatrix<double> MatrixOperator::spmm(const BasicSparseMatrix<double> &, const BasicMatrixView<double> &) const;
+template void MatrixOperator::spmm(double, const BasicSparseMatrix<double> &, const BasicMatrixView<double> &, double, BasicMatrix<double> &) const;
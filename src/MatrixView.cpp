@@ -2,47 +2,101 @@
 #include "../include/InvalidMatrixFormat.hpp"
 #include "../include/Matrix.hpp"
 
+#include <algorithm>
 #include <array>
 #include <optional>
 #include <iostream>
+#include <stdexcept>
 
-MatrixView::MatrixView(
-    std::shared_ptr<const double[]> data,
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView(
+    std::shared_ptr<const T[]> data,
     int r,
     int c,
     int row_off,
-    int col_off) : parent_data(std::move(data)),
-                   rows(r),
-                   cols(c),
-                   row_offset(row_off),
-                   col_offset(col_off) {}
+    int col_off) : BasicMatrixView(std::move(data), r, c, row_off, col_off, c) {}
 
-double MatrixView::get_element(int row, int col) const
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView(
+    std::shared_ptr<const T[]> data,
+    int r,
+    int c,
+    int row_off,
+    int col_off,
+    int row_stride) : parent_data(std::move(data)),
+                      origin(nullptr),
+                      rows(r),
+                      cols(c),
+                      row_stride(row_stride),
+                      col_stride(1),
+                      data_rows(r),
+                      data_cols(c)
+{
+    origin = parent_data.get() + static_cast<std::ptrdiff_t>(row_off) * row_stride + col_off;
+}
+
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView(std::shared_ptr<const T[]> owner, const T *origin, int r, int c,
+                                    int row_stride, int col_stride, int data_rows, int data_cols)
+    : parent_data(std::move(owner)),
+      origin(origin),
+      rows(r),
+      cols(c),
+      row_stride(row_stride),
+      col_stride(col_stride),
+      data_rows(data_rows),
+      data_cols(data_cols) {}
+
+template <typename T>
+T BasicMatrixView<T>::get_element(int row, int col) const
 {
     if (row < 0 || row >= rows || col < 0 || col >= cols)
     {
         throw std::out_of_range("Row or column index out of range.");
     }
 
-    return parent_data[(row + row_offset) * cols + col + col_offset];
+    return element(row, col);
+}
+
+template <typename T>
+BasicMatrixView<T> BasicMatrixView<T>::transpose() const
+{
+    return BasicMatrixView(parent_data, origin, cols, rows, col_stride, row_stride, data_cols, data_rows);
 }
 
 /**
- * Overloads get_element to take in an additional parameter to modify the stride.
- * Note that the returned value will be different:
- * return parent_data[(row + row_offset) * stride + col + col_offset];
+ * A block that starts in the padding has no stored data, its origin is never dereferenced.
  */
-double MatrixView::get_element(int row, int col, int stride) const
+template <typename T>
+BasicMatrixView<T> BasicMatrixView<T>::sub_view(int row, int col, int r, int c) const
 {
-    if (row < 0 || row >= rows || col < 0 || col >= cols)
+    if (row < 0 || col < 0 || r < 0 || c < 0 || row + r > rows || col + c > cols)
     {
-        throw std::out_of_range("Row or column index out of range.");
+        throw std::out_of_range("Sub view does not fit into the view.");
     }
 
-    return parent_data[(row + row_offset) * stride + col + col_offset];
+    int block_data_rows = std::clamp(data_rows - row, 0, r);
+    int block_data_cols = std::clamp(data_cols - col, 0, c);
+    const T *block_origin = block_data_rows > 0 && block_data_cols > 0
+                                     ? origin + static_cast<std::ptrdiff_t>(row) * row_stride + static_cast<std::ptrdiff_t>(col) * col_stride
+                                     : origin;
+
+    return BasicMatrixView(parent_data, block_origin, r, c, row_stride, col_stride, block_data_rows, block_data_cols);
 }
 
-std::array<MatrixView, 4> MatrixView::split() const
+template <typename T>
+BasicMatrixView<T> BasicMatrixView<T>::padded(int r, int c) const
+{
+    if (r < rows || c < cols)
+    {
+        throw std::invalid_argument("A padded view can not be smaller than the view.");
+    }
+
+    return BasicMatrixView(parent_data, origin, r, c, row_stride, col_stride, data_rows, data_cols);
+}
+
+template <typename T>
+std::array<BasicMatrixView<T>, 4> BasicMatrixView<T>::split() const
 {
     if (rows != cols)
     {
@@ -50,10 +104,10 @@ std::array<MatrixView, 4> MatrixView::split() const
     }
 
     int size = rows / 2;
-    MatrixView upper_left(parent_data, size, size, row_offset, col_offset);
-    MatrixView upper_right(parent_data, size, size, row_offset, col_offset + size);
-    MatrixView lower_left(parent_data, size, size, row_offset + size, col_offset);
-    MatrixView lower_right(parent_data, size, size, row_offset + size, col_offset + size);
+    BasicMatrixView upper_left = sub_view(0, 0, size, size);
+    BasicMatrixView upper_right = sub_view(0, size, size, size);
+    BasicMatrixView lower_left = sub_view(size, 0, size, size);
+    BasicMatrixView lower_right = sub_view(size, size, size, size);
 
     return {upper_left, upper_right, lower_left, lower_right};
 }
@@ -61,12 +115,9 @@ std::array<MatrixView, 4> MatrixView::split() const
 /**
  * row_start, col_start are inclusive, row_end, col_end are exclusive.
  */
-Matrix MatrixView::convert_to_matrix(int row_start, int row_end, int col_start, int col_end) const
+template <typename T>
+BasicMatrix<T> BasicMatrixView<T>::convert_to_matrix(int row_start, int row_end, int col_start, int col_end) const
 {
-    std::cout << "Row start: " << row_start << " Row end: " << row_end << std::endl;
-    std::cout << "Col start: " << col_start << " Col end: " << col_end << std::endl;
-    std::cout << "Rows: " << rows << std::endl;
-
     if (row_start < 0 || row_end > rows || row_end <= row_start)
     {
         throw std::out_of_range("Row index out of range.");
@@ -79,57 +130,46 @@ Matrix MatrixView::convert_to_matrix(int row_start, int row_end, int col_start,
     int result_rows = row_end - row_start;
     int result_cols = col_end - col_start;
 
-    Matrix result(result_rows, result_cols);
-    for (int i = 0; i < row_end - row_start; i++)
-    {
-        for (int j = 0; j < col_end - col_start; j++)
-        {
-            result(i, j) = get_element(i + row_start, j + col_start);
-        }
-    }
+    BasicMatrix<T> result = BasicMatrix<T>::uninitialized(result_rows, result_cols);
+    sub_view(row_start, col_start, result_rows, result_cols).copy_to(result.data(), result.get_leading_dimension());
 
     return result;
 }
 
-MatrixView MatrixView::operator+(const MatrixView &other) const
+/**
+ * Rows with unit column stride are copied with std::copy, other layouts are gathered element by element.
+ */
+template <typename T>
+void BasicMatrixView<T>::copy_to(T *out, int out_row_stride) const
 {
-    if (rows != other.rows || cols != other.cols)
-    {
-        throw InvalidMatrixFormat("Matrices must have the same dimensions for addition.");
-    }
-
-    std::shared_ptr<double[]> result_data(new double[rows * cols]());
+    int stored_cols = std::min(data_cols, cols);
     for (int i = 0; i < rows; i++)
     {
-        for (int j = 0; j < cols; j++)
+        T *out_row = out + static_cast<std::ptrdiff_t>(i) * out_row_stride;
+        if (i >= data_rows)
         {
-            result_data[i * cols + j] = get_element(i, j) + other.get_element(i, j);
+            std::fill(out_row, out_row + cols, T(0));
+            continue;
         }
-    }
-
-    return MatrixView(result_data, rows, cols, 0, 0);
-}
-
-MatrixView MatrixView::operator-(const MatrixView &other) const
-{
-    if (rows != other.rows || cols != other.cols)
-    {
-        throw InvalidMatrixFormat("Matrices must have the same dimensions for subtraction.");
-    }
 
-    std::shared_ptr<double[]> result_data(new double[rows * cols]());
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < cols; j++)
+        const T *row = origin + static_cast<std::ptrdiff_t>(i) * row_stride;
+        if (col_stride == 1)
         {
-            result_data[i * cols + j] = get_element(i, j) - other.get_element(i, j);
+            std::copy(row, row + stored_cols, out_row);
         }
+        else
+        {
+            for (int j = 0; j < stored_cols; j++)
+            {
+                out_row[j] = row[static_cast<std::ptrdiff_t>(j) * col_stride];
+            }
+        }
+        std::fill(out_row + stored_cols, out_row + cols, T(0));
     }
-
-    return MatrixView(result_data, rows, cols, 0, 0);
 }
 
-void MatrixView::display() const
+template <typename T>
+void BasicMatrixView<T>::display() const
 {
     for (int i = 0; i < rows; i++)
     {
@@ -140,12 +180,53 @@ void MatrixView::display() const
         std::cout << std::endl;
     }
 }
-int MatrixView::get_rows() const
+template <typename T>
+int BasicMatrixView<T>::get_rows() const
 {
     return rows;
 }
 
-int MatrixView::get_cols() const
+template <typename T>
+int BasicMatrixView<T>::get_cols() const
 {
     return cols;
-}
\ No newline at end of file
+}
+
+template <typename T>
+const T *BasicMatrixView<T>::data() const
+{
+    return origin;
+}
+
+template <typename T>
+int BasicMatrixView<T>::get_row_stride() const
+{
+    return row_stride;
+}
+
+template <typename T>
+int BasicMatrixView<T>::get_col_stride() const
+{
+    return col_stride;
+}
+
+template <typename T>
+int BasicMatrixView<T>::get_data_rows() const
+{
+    return data_rows;
+}
+
+template <typename T>
+int BasicMatrixView<T>::get_data_cols() const
+{
+    return data_cols;
+}
+
+template <typename T>
+bool BasicMatrixView<T>::is_padded() const
+{
+    return data_rows < rows || data_cols < cols;
+}
+
+template class BasicMatrixView<float>;
+template class BasicMatrixView<double>;
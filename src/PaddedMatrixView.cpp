@@ -1,20 +1,15 @@
 #include "../include/PaddedMatrixView.hpp"
 
-PaddedMatrixView::PaddedMatrixView(std::shared_ptr<const double[]> data, int r, int c, int p_rows, int p_cols)
-    : MatrixView(std::move(data), r, c, 0, 0),
-      parent_rows(p_rows),
-      parent_cols(p_cols),
-      rows(r),
-      cols(c) {}
+#include <algorithm>
+#include <utility>
 
-double PaddedMatrixView::get_element(int row, int col) const
-{
-    if (row < 0 || row >= rows || col < 0 || col >= cols)
-    {
-        throw std::out_of_range("Matrix Index out of range.");
-    }
+template <typename T>
+BasicPaddedMatrixView<T>::BasicPaddedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int p_rows, int p_cols)
+    : BasicPaddedMatrixView(std::move(data), r, c, p_rows, p_cols, p_cols) {}
 
-    return (row < parent_rows && col < parent_cols)
-               ? MatrixView::get_element(row, col, parent_cols)
-               : 0.0;
-}
\ No newline at end of file
+template <typename T>
+BasicPaddedMatrixView<T>::BasicPaddedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int p_rows, int p_cols, int data_row_stride)
+    : BasicMatrixView<T>(data, data.get(), r, c, data_row_stride, 1, std::min(p_rows, r), std::min(p_cols, c)) {}
+
+template class BasicPaddedMatrixView<float>;
+template class BasicPaddedMatrixView<double>;
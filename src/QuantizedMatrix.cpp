@@ -0,0 +1,128 @@
+#include "../include/QuantizedMatrix.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+QuantizedMatrix::QuantizedMatrix(int rows, int cols, std::vector<std::int8_t> values, std::vector<float> scales, QuantizationAxis axis)
+    : rows(rows), cols(cols), axis(axis), values(std::move(values)), scales(std::move(scales))
+{
+    if (rows < 0 || cols < 0)
+    {
+        throw std::invalid_argument("Matrix dimensions must not be negative.");
+    }
+    if (this->values.size() != static_cast<std::size_t>(rows) * cols)
+    {
+        throw InvalidMatrixFormat("Number of values does not match the shape of the quantized matrix.");
+    }
+    if (this->scales.size() != static_cast<std::size_t>(axis == QuantizationAxis::PerRow ? rows : cols))
+    {
+        throw InvalidMatrixFormat("Number of scales does not match the quantization axis.");
+    }
+}
+
+/**
+ * The view is copied to a dense buffer first, so transposed and padded views are read like any other.
+ */
+template <typename T>
+QuantizedMatrix QuantizedMatrix::quantize(const BasicMatrixView<T> &view, QuantizationAxis axis)
+{
+    int rows = view.get_rows();
+    int cols = view.get_cols();
+    std::vector<T> dense(static_cast<std::size_t>(rows) * cols);
+    view.copy_to(dense.data(), cols);
+
+    bool per_row = axis == QuantizationAxis::PerRow;
+    std::vector<T> largest(per_row ? rows : cols, T(0));
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            T &bound = largest[per_row ? i : j];
+            bound = std::max(bound, std::abs(dense[i * cols + j]));
+        }
+    }
+
+    // The scale is stored as a float, so it is rounded to float before anything is divided by it. Magnitudes below
+    // the float range give 0 and are quantized with scale 1, i.e. to zeros, like a row or column of zeros.
+    std::vector<float> scales(largest.size());
+    for (std::size_t s = 0; s < largest.size(); s++)
+    {
+        float scale = static_cast<float>(largest[s] / T(127));
+        if (!std::isfinite(scale))
+        {
+            throw std::invalid_argument("Values are too large to be quantized with a float scale.");
+        }
+        scales[s] = scale > 0.0f ? scale : 1.0f;
+    }
+
+    std::vector<std::int8_t> values(dense.size());
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            if (std::isnan(dense[i * cols + j]))
+            {
+                throw std::invalid_argument("NaN values can not be quantized.");
+            }
+            double scaled = std::round(dense[i * cols + j] / static_cast<double>(scales[per_row ? i : j]));
+            values[i * cols + j] = static_cast<std::int8_t>(std::clamp(scaled, -127.0, 127.0));
+        }
+    }
+
+    return QuantizedMatrix(rows, cols, std::move(values), std::move(scales), axis);
+}
+
+int QuantizedMatrix::get_rows() const
+{
+    return rows;
+}
+
+int QuantizedMatrix::get_cols() const
+{
+    return cols;
+}
+
+QuantizationAxis QuantizedMatrix::get_axis() const
+{
+    return axis;
+}
+
+const std::int8_t *QuantizedMatrix::data() const
+{
+    return values.data();
+}
+
+const std::vector<float> &QuantizedMatrix::get_scales() const
+{
+    return scales;
+}
+
+std::int8_t QuantizedMatrix::get_value(int row, int col) const
+{
+    if (row < 0 || row >= rows || col < 0 || col >= cols)
+    {
+        throw std::out_of_range("Matrix index out of bounds.");
+    }
+
+    return values[row * cols + col];
+}
+
+FloatMatrix QuantizedMatrix::dequantize() const
+{
+    FloatMatrix result = FloatMatrix::uninitialized(rows, cols);
+    for (int i = 0; i < rows; i++)
+    {
+        Span<float> row = result.row(i);
+        for (int j = 0; j < cols; j++)
+        {
+            row[j] = scales[axis == QuantizationAxis::PerRow ? i : j] * values[i * cols + j];
+        }
+    }
+    return result;
+}
+
+template QuantizedMatrix QuantizedMatrix::quantize(const BasicMatrixView<float> &, QuantizationAxis);
+template QuantizedMatrix QuantizedMatrix::quantize(const BasicMatrixView<double> &, QuantizationAxis);
@@ -0,0 +1,355 @@
+#include "../include/SimdKernels.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+#ifdef LINALG_SIMD_X86
+#include <cpuid.h>
+
+// Specialized for float and double in the per instruction set translation units, which are compiled with
+// matching target flags.
+template <typename T>
+const SimdKernelTable<T> &sse2_kernel_table();
+template <typename T>
+const SimdKernelTable<T> &avx2_kernel_table();
+template <typename T>
+const SimdKernelTable<T> &avx512_kernel_table();
+
+const Int8KernelTable &sse2_int8_kernel_table();
+const Int8KernelTable &avx2_int8_kernel_table();
+#endif
+
+namespace
+{
+    constexpr int SCALAR_MR = 4;
+    constexpr int SCALAR_NR = 8;
+
+    template <typename T>
+    void scalar_gemm_micro_kernel(int kc, const T *a, const T *b,
+                                  T *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        T ab[SCALAR_MR][SCALAR_NR] = {};
+
+        for (int p = 0; p < kc; p++)
+        {
+            for (int i = 0; i < SCALAR_MR; i++)
+            {
+                T a_value = a[i];
+                for (int j = 0; j < SCALAR_NR; j++)
+                {
+                    ab[i][j] += a_value * b[j];
+                }
+            }
+            a += SCALAR_MR;
+            b += SCALAR_NR;
+        }
+
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += ab[i][j];
+            }
+        }
+    }
+
+    template <typename T>
+    void scalar_add(const T *x, const T *y, T *out, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            out[i] = x[i] + y[i];
+        }
+    }
+
+    template <typename T>
+    void scalar_subtract(const T *x, const T *y, T *out, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    template <typename T>
+    void scalar_scale(const T *x, T scalar, T *out, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            out[i] = x[i] * scalar;
+        }
+    }
+
+    template <typename T>
+    T scalar_dot(const T *x, const T *y, std::size_t n)
+    {
+        T result = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            result += x[i] * y[i];
+        }
+        return result;
+    }
+
+    template <typename T>
+    void scalar_axpy(T alpha, const T *x, T *y, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    constexpr int SCALAR_TRANSPOSE_TILE = 4;
+
+    template <typename T>
+    void scalar_transpose_micro_kernel(const T *in, int in_row_stride, T *out, int out_row_stride)
+    {
+        for (int i = 0; i < SCALAR_TRANSPOSE_TILE; i++)
+        {
+            for (int j = 0; j < SCALAR_TRANSPOSE_TILE; j++)
+            {
+                out[j * out_row_stride + i] = in[i * in_row_stride + j];
+            }
+        }
+    }
+
+    template <typename T>
+    const SimdKernelTable<T> SCALAR_TABLE = {
+        SimdLevel::Scalar,
+        SCALAR_MR,
+        SCALAR_NR,
+        scalar_gemm_micro_kernel<T>,
+        scalar_add<T>,
+        scalar_subtract<T>,
+        scalar_scale<T>,
+        scalar_dot<T>,
+        scalar_axpy<T>,
+        SCALAR_TRANSPOSE_TILE,
+        scalar_transpose_micro_kernel<T>,
+    };
+
+    void scalar_int8_gemm_micro_kernel(int k_pairs, const std::int16_t *a, const std::int16_t *b,
+                                       const float *row_scales, const float *col_scales,
+                                       float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        std::int32_t ab[SCALAR_MR][SCALAR_NR] = {};
+
+        for (int q = 0; q < k_pairs; q++)
+        {
+            for (int i = 0; i < SCALAR_MR; i++)
+            {
+                std::int32_t a0 = a[2 * i];
+                std::int32_t a1 = a[2 * i + 1];
+                for (int j = 0; j < SCALAR_NR; j++)
+                {
+                    ab[i][j] += a0 * b[2 * j] + a1 * b[2 * j + 1];
+                }
+            }
+            a += 2 * SCALAR_MR;
+            b += 2 * SCALAR_NR;
+        }
+
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += row_scales[i] * col_scales[j] * static_cast<float>(ab[i][j]);
+            }
+        }
+    }
+
+    const Int8KernelTable SCALAR_INT8_TABLE = {
+        SimdLevel::Scalar,
+        SCALAR_MR,
+        SCALAR_NR,
+        scalar_int8_gemm_micro_kernel,
+    };
+
+    struct CpuFeatures
+    {
+        bool sse2 = false;
+        bool avx2 = false;
+        bool avx512 = false;
+    };
+
+    /**
+     * Reads the CPUID feature bits and checks with XGETBV that the operating system saves the
+     * YMM and ZMM register state, without which the AVX instructions would fault.
+     */
+    CpuFeatures query_cpu_features()
+    {
+        CpuFeatures features;
+
+#ifdef LINALG_SIMD_X86
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        {
+            return features;
+        }
+
+        features.sse2 = (edx & bit_SSE2) != 0;
+
+        bool has_avx = (ecx & bit_AVX) != 0;
+        bool has_fma = (ecx & bit_FMA) != 0;
+
+        unsigned long long xcr0 = 0;
+        if ((ecx & bit_OSXSAVE) != 0)
+        {
+            unsigned int xcr0_low, xcr0_high;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+            xcr0 = (static_cast<unsigned long long>(xcr0_high) << 32) | xcr0_low;
+        }
+
+        bool ymm_enabled = (xcr0 & 0x06) == 0x06;
+        bool zmm_enabled = (xcr0 & 0xe6) == 0xe6;
+
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        {
+            features.avx2 = has_avx && has_fma && ymm_enabled && (ebx & bit_AVX2) != 0;
+            features.avx512 = zmm_enabled && (ebx & bit_AVX512F) != 0;
+        }
+#endif
+
+        return features;
+    }
+
+    const CpuFeatures &cpu_features()
+    {
+        static const CpuFeatures features = query_cpu_features();
+        return features;
+    }
+
+    template <typename T>
+    const SimdKernelTable<T> &table_for(SimdLevel level)
+    {
+#ifdef LINALG_SIMD_X86
+        switch (level)
+        {
+        case SimdLevel::SSE2:
+            return sse2_kernel_table<T>();
+        case SimdLevel::AVX2:
+            return avx2_kernel_table<T>();
+        case SimdLevel::AVX512:
+            return avx512_kernel_table<T>();
+        default:
+            break;
+        }
+#endif
+        return SCALAR_TABLE<T>;
+    }
+
+    const Int8KernelTable &int8_table_for(SimdLevel level)
+    {
+#ifdef LINALG_SIMD_X86
+        switch (level)
+        {
+        case SimdLevel::SSE2:
+            return sse2_int8_kernel_table();
+        case SimdLevel::AVX2:
+        case SimdLevel::AVX512:
+            return avx2_int8_kernel_table();
+        default:
+            break;
+        }
+#endif
+        return SCALAR_INT8_TABLE;
+    }
+
+    template <typename T>
+    std::atomic<const SimdKernelTable<T> *> active_table{nullptr};
+
+    template <typename T>
+    const SimdKernelTable<T> &active_table_for()
+    {
+        const SimdKernelTable<T> *table = active_table<T>.load(std::memory_order_acquire);
+        if (table == nullptr)
+        {
+            table = &table_for<T>(SimdKernels::detect_level());
+            active_table<T>.store(table, std::memory_order_release);
+        }
+
+        return *table;
+    }
+
+    void store_tables(SimdLevel level)
+    {
+        active_table<double>.store(&table_for<double>(level), std::memory_order_release);
+        active_table<float>.store(&table_for<float>(level), std::memory_order_release);
+    }
+}
+
+template <>
+const SimdKernelTable<double> &SimdKernels::get<double>()
+{
+    return active_table_for<double>();
+}
+
+template <>
+const SimdKernelTable<float> &SimdKernels::get<float>()
+{
+    return active_table_for<float>();
+}
+
+/**
+ * Follows the level of the double table, so force_level() and reset_level() switch it as well.
+ */
+const Int8KernelTable &SimdKernels::get_int8()
+{
+    return int8_table_for(active_level());
+}
+
+SimdLevel SimdKernels::detect_level()
+{
+    if (is_supported(SimdLevel::AVX512))
+    {
+        return SimdLevel::AVX512;
+    }
+    if (is_supported(SimdLevel::AVX2))
+    {
+        return SimdLevel::AVX2;
+    }
+    if (is_supported(SimdLevel::SSE2))
+    {
+        return SimdLevel::SSE2;
+    }
+    return SimdLevel::Scalar;
+}
+
+SimdLevel SimdKernels::active_level()
+{
+    return get().level;
+}
+
+void SimdKernels::force_level(SimdLevel level)
+{
+    if (!is_supported(level))
+    {
+        throw std::invalid_argument("Requested SIMD level is not supported on this machine.");
+    }
+
+    store_tables(level);
+}
+
+void SimdKernels::reset_level()
+{
+    store_tables(detect_level());
+}
+
+bool SimdKernels::is_supported(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return true;
+    case SimdLevel::SSE2:
+        return cpu_features().sse2;
+    case SimdLevel::AVX2:
+        return cpu_features().avx2;
+    case SimdLevel::AVX512:
+        // The AVX-512 level runs the AVX2 int8 kernel, see int8_table_for().
+        return cpu_features().avx512 && cpu_features().avx2;
+    }
+
+    return false;
+}
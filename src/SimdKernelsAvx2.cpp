@@ -0,0 +1,455 @@
+#include "../include/SimdKernels.hpp"
+
+#ifdef LINALG_SIMD_X86
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace
+{
+    constexpr int MR = 6;
+    constexpr int NR = 8;
+
+    /**
+     * 6 x 8 tile held in twelve YMM accumulators, leaving registers for the two B loads and the A broadcast.
+     */
+    void gemm_micro_kernel(int kc, const double *a, const double *b,
+                           double *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m256d ab[MR][2];
+        for (int i = 0; i < MR; i++)
+        {
+            ab[i][0] = _mm256_setzero_pd();
+            ab[i][1] = _mm256_setzero_pd();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m256d b0 = _mm256_loadu_pd(b);
+            __m256d b1 = _mm256_loadu_pd(b + 4);
+            for (int i = 0; i < MR; i++)
+            {
+                __m256d a_value = _mm256_broadcast_sd(a + i);
+                ab[i][0] = _mm256_fmadd_pd(a_value, b0, ab[i][0]);
+                ab[i][1] = _mm256_fmadd_pd(a_value, b1, ab[i][1]);
+            }
+            a += MR;
+            b += NR;
+        }
+
+        if (tile_rows == MR && tile_cols == NR)
+        {
+            for (int i = 0; i < MR; i++)
+            {
+                double *c_row = c + i * c_row_stride;
+                _mm256_storeu_pd(c_row, _mm256_add_pd(_mm256_loadu_pd(c_row), ab[i][0]));
+                _mm256_storeu_pd(c_row + 4, _mm256_add_pd(_mm256_loadu_pd(c_row + 4), ab[i][1]));
+            }
+            return;
+        }
+
+        double tile[MR][NR];
+        for (int i = 0; i < MR; i++)
+        {
+            _mm256_storeu_pd(tile[i], ab[i][0]);
+            _mm256_storeu_pd(tile[i] + 4, ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += tile[i][j];
+            }
+        }
+    }
+
+    void add(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] + y[i];
+        }
+    }
+
+    void subtract(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    void scale(const double *x, double scalar, double *out, std::size_t n)
+    {
+        __m256d s = _mm256_set1_pd(scalar);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), s));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] * scalar;
+        }
+    }
+
+    double dot(const double *x, const double *y, std::size_t n)
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+            sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+        }
+
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+        double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < n; i++)
+        {
+            result += x[i] * y[i];
+        }
+        return result;
+    }
+
+    void axpy(double alpha, const double *x, double *y, std::size_t n)
+    {
+        __m256d a = _mm256_set1_pd(alpha);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    constexpr int TRANSPOSE_TILE = 4;
+
+    /**
+     * Interleaves pairs of rows within each 128-bit lane, then swaps lanes to complete the 4 x 4 transpose.
+     */
+    void transpose_micro_kernel(const double *in, int in_row_stride, double *out, int out_row_stride)
+    {
+        __m256d row0 = _mm256_loadu_pd(in);
+        __m256d row1 = _mm256_loadu_pd(in + in_row_stride);
+        __m256d row2 = _mm256_loadu_pd(in + 2 * in_row_stride);
+        __m256d row3 = _mm256_loadu_pd(in + 3 * in_row_stride);
+
+        __m256d even01 = _mm256_unpacklo_pd(row0, row1);
+        __m256d odd01 = _mm256_unpackhi_pd(row0, row1);
+        __m256d even23 = _mm256_unpacklo_pd(row2, row3);
+        __m256d odd23 = _mm256_unpackhi_pd(row2, row3);
+
+        _mm256_storeu_pd(out, _mm256_permute2f128_pd(even01, even23, 0x20));
+        _mm256_storeu_pd(out + out_row_stride, _mm256_permute2f128_pd(odd01, odd23, 0x20));
+        _mm256_storeu_pd(out + 2 * out_row_stride, _mm256_permute2f128_pd(even01, even23, 0x31));
+        _mm256_storeu_pd(out + 3 * out_row_stride, _mm256_permute2f128_pd(odd01, odd23, 0x31));
+    }
+
+    constexpr int FLOAT_MR = 6;
+    constexpr int FLOAT_NR = 16;
+
+    /**
+     * 6 x 16 tile, the same register budget as the double kernel with eight floats per YMM register.
+     */
+    void gemm_micro_kernel(int kc, const float *a, const float *b,
+                           float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m256 ab[FLOAT_MR][2];
+        for (int i = 0; i < FLOAT_MR; i++)
+        {
+            ab[i][0] = _mm256_setzero_ps();
+            ab[i][1] = _mm256_setzero_ps();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m256 b0 = _mm256_loadu_ps(b);
+            __m256 b1 = _mm256_loadu_ps(b + 8);
+            for (int i = 0; i < FLOAT_MR; i++)
+            {
+                __m256 a_value = _mm256_broadcast_ss(a + i);
+                ab[i][0] = _mm256_fmadd_ps(a_value, b0, ab[i][0]);
+                ab[i][1] = _mm256_fmadd_ps(a_value, b1, ab[i][1]);
+            }
+            a += FLOAT_MR;
+            b += FLOAT_NR;
+        }
+
+        if (tile_rows == FLOAT_MR && tile_cols == FLOAT_NR)
+        {
+            for (int i = 0; i < FLOAT_MR; i++)
+            {
+                float *c_row = c + i * c_row_stride;
+                _mm256_storeu_ps(c_row, _mm256_add_ps(_mm256_loadu_ps(c_row), ab[i][0]));
+                _mm256_storeu_ps(c_row + 8, _mm256_add_ps(_mm256_loadu_ps(c_row + 8), ab[i][1]));
+            }
+            return;
+        }
+
+        float tile[FLOAT_MR][FLOAT_NR];
+        for (int i = 0; i < FLOAT_MR; i++)
+        {
+            _mm256_storeu_ps(tile[i], ab[i][0]);
+            _mm256_storeu_ps(tile[i] + 8, ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += tile[i][j];
+            }
+        }
+    }
+
+    void add(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] + y[i];
+        }
+    }
+
+    void subtract(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    void scale(const float *x, float scalar, float *out, std::size_t n)
+    {
+        __m256 s = _mm256_set1_ps(scalar);
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), s));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] * scalar;
+        }
+    }
+
+    float dot(const float *x, const float *y, std::size_t n)
+    {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+            sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+        }
+
+        float lanes[8];
+        _mm256_storeu_ps(lanes, _mm256_add_ps(sum0, sum1));
+        float result = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        for (; i < n; i++)
+        {
+            result += x[i] * y[i];
+        }
+        return result;
+    }
+
+    void axpy(float alpha, const float *x, float *y, std::size_t n)
+    {
+        __m256 a = _mm256_set1_ps(alpha);
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    constexpr int FLOAT_TRANSPOSE_TILE = 8;
+
+    /**
+     * Interleaves pairs of rows, gathers columns of four rows within each 128-bit lane, then swaps lanes between
+     * the upper and lower four rows.
+     */
+    void transpose_micro_kernel(const float *in, int in_row_stride, float *out, int out_row_stride)
+    {
+        __m256 rows[FLOAT_TRANSPOSE_TILE];
+        for (int i = 0; i < FLOAT_TRANSPOSE_TILE; i++)
+        {
+            rows[i] = _mm256_loadu_ps(in + i * in_row_stride);
+        }
+
+        __m256 pairs[FLOAT_TRANSPOSE_TILE];
+        for (int p = 0; p < FLOAT_TRANSPOSE_TILE / 2; p++)
+        {
+            pairs[2 * p] = _mm256_unpacklo_ps(rows[2 * p], rows[2 * p + 1]);
+            pairs[2 * p + 1] = _mm256_unpackhi_ps(rows[2 * p], rows[2 * p + 1]);
+        }
+
+        // quads[4 * h + c] holds column c of each lane for rows 4h to 4h + 3.
+        __m256 quads[FLOAT_TRANSPOSE_TILE];
+        for (int h = 0; h < 2; h++)
+        {
+            quads[4 * h] = _mm256_shuffle_ps(pairs[4 * h], pairs[4 * h + 2], 0x44);
+            quads[4 * h + 1] = _mm256_shuffle_ps(pairs[4 * h], pairs[4 * h + 2], 0xEE);
+            quads[4 * h + 2] = _mm256_shuffle_ps(pairs[4 * h + 1], pairs[4 * h + 3], 0x44);
+            quads[4 * h + 3] = _mm256_shuffle_ps(pairs[4 * h + 1], pairs[4 * h + 3], 0xEE);
+        }
+
+        for (int c = 0; c < 4; c++)
+        {
+            _mm256_storeu_ps(out + c * out_row_stride, _mm256_permute2f128_ps(quads[c], quads[c + 4], 0x20));
+            _mm256_storeu_ps(out + (c + 4) * out_row_stride, _mm256_permute2f128_ps(quads[c], quads[c + 4], 0x31));
+        }
+    }
+
+    constexpr int INT8_MR = 6;
+    constexpr int INT8_NR = 16;
+
+    /**
+     * 6 x 16 tile of int32 sums held in twelve YMM accumulators, like the float kernel.
+     * Every 32-bit lane of a B load holds the pair (b(2q, j), b(2q + 1, j)) and is multiplied with the broadcast pair of A.
+     */
+    void int8_gemm_micro_kernel(int k_pairs, const std::int16_t *a, const std::int16_t *b,
+                                const float *row_scales, const float *col_scales,
+                                float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m256i ab[INT8_MR][2];
+        for (int i = 0; i < INT8_MR; i++)
+        {
+            ab[i][0] = _mm256_setzero_si256();
+            ab[i][1] = _mm256_setzero_si256();
+        }
+
+        for (int q = 0; q < k_pairs; q++)
+        {
+            __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+            __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 16));
+            for (int i = 0; i < INT8_MR; i++)
+            {
+                std::int32_t pair;
+                std::memcpy(&pair, a + 2 * i, sizeof(pair));
+                __m256i a_pair = _mm256_set1_epi32(pair);
+                ab[i][0] = _mm256_add_epi32(ab[i][0], _mm256_madd_epi16(a_pair, b0));
+                ab[i][1] = _mm256_add_epi32(ab[i][1], _mm256_madd_epi16(a_pair, b1));
+            }
+            a += 2 * INT8_MR;
+            b += 2 * INT8_NR;
+        }
+
+        if (tile_rows == INT8_MR && tile_cols == INT8_NR)
+        {
+            __m256 col0 = _mm256_loadu_ps(col_scales);
+            __m256 col1 = _mm256_loadu_ps(col_scales + 8);
+            for (int i = 0; i < INT8_MR; i++)
+            {
+                __m256 row_scale = _mm256_set1_ps(row_scales[i]);
+                float *c_row = c + i * c_row_stride;
+                __m256 sum0 = _mm256_mul_ps(_mm256_mul_ps(row_scale, col0), _mm256_cvtepi32_ps(ab[i][0]));
+                __m256 sum1 = _mm256_mul_ps(_mm256_mul_ps(row_scale, col1), _mm256_cvtepi32_ps(ab[i][1]));
+                _mm256_storeu_ps(c_row, _mm256_add_ps(_mm256_loadu_ps(c_row), sum0));
+                _mm256_storeu_ps(c_row + 8, _mm256_add_ps(_mm256_loadu_ps(c_row + 8), sum1));
+            }
+            return;
+        }
+
+        std::int32_t tile[INT8_MR][INT8_NR];
+        for (int i = 0; i < INT8_MR; i++)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(tile[i]), ab[i][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(tile[i] + 8), ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += row_scales[i] * col_scales[j] * static_cast<float>(tile[i][j]);
+            }
+        }
+    }
+
+    const SimdKernelTable<double> DOUBLE_TABLE = {
+        SimdLevel::AVX2,
+        MR,
+        NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+
+    const SimdKernelTable<float> FLOAT_TABLE = {
+        SimdLevel::AVX2,
+        FLOAT_MR,
+        FLOAT_NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        FLOAT_TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+
+    const Int8KernelTable INT8_TABLE = {
+        SimdLevel::AVX2,
+        INT8_MR,
+        INT8_NR,
+        int8_gemm_micro_kernel,
+    };
+}
+
+template <typename T>
+const SimdKernelTable<T> &avx2_kernel_table();
+
+template <>
+const SimdKernelTable<double> &avx2_kernel_table<double>()
+{
+    return DOUBLE_TABLE;
+}
+
+template <>
+const SimdKernelTable<float> &avx2_kernel_table<float>()
+{
+    return FLOAT_TABLE;
+}
+
+const Int8KernelTable &avx2_int8_kernel_table()
+{
+    return INT8_TABLE;
+}
+
+#endif
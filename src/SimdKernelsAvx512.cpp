@@ -0,0 +1,394 @@
+#include "../include/SimdKernels.hpp"
+
+#ifdef LINALG_SIMD_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    constexpr int MR = 8;
+    constexpr int NR = 16;
+
+    __mmask8 tail_mask(std::size_t remaining)
+    {
+        return static_cast<__mmask8>((1u << remaining) - 1);
+    }
+
+    /**
+     * 8 x 16 tile held in sixteen ZMM accumulators. Partial tiles are written back with masked stores.
+     */
+    void gemm_micro_kernel(int kc, const double *a, const double *b,
+                           double *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m512d ab[MR][2];
+        for (int i = 0; i < MR; i++)
+        {
+            ab[i][0] = _mm512_setzero_pd();
+            ab[i][1] = _mm512_setzero_pd();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m512d b0 = _mm512_loadu_pd(b);
+            __m512d b1 = _mm512_loadu_pd(b + 8);
+            for (int i = 0; i < MR; i++)
+            {
+                __m512d a_value = _mm512_set1_pd(a[i]);
+                ab[i][0] = _mm512_fmadd_pd(a_value, b0, ab[i][0]);
+                ab[i][1] = _mm512_fmadd_pd(a_value, b1, ab[i][1]);
+            }
+            a += MR;
+            b += NR;
+        }
+
+        __mmask8 mask0 = tile_cols >= 8 ? static_cast<__mmask8>(0xff) : tail_mask(tile_cols);
+        __mmask8 mask1 = tile_cols >= 16 ? static_cast<__mmask8>(0xff) : (tile_cols > 8 ? tail_mask(tile_cols - 8) : 0);
+
+        for (int i = 0; i < tile_rows; i++)
+        {
+            double *c_row = c + i * c_row_stride;
+            _mm512_mask_storeu_pd(c_row, mask0, _mm512_add_pd(_mm512_maskz_loadu_pd(mask0, c_row), ab[i][0]));
+            _mm512_mask_storeu_pd(c_row + 8, mask1, _mm512_add_pd(_mm512_maskz_loadu_pd(mask1, c_row + 8), ab[i][1]));
+        }
+    }
+
+    void add(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask8 mask = tail_mask(n - i);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+        }
+    }
+
+    void subtract(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask8 mask = tail_mask(n - i);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+        }
+    }
+
+    void scale(const double *x, double scalar, double *out, std::size_t n)
+    {
+        __m512d s = _mm512_set1_pd(scalar);
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), s));
+        }
+        if (i < n)
+        {
+            __mmask8 mask = tail_mask(n - i);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, x + i), s));
+        }
+    }
+
+    double dot(const double *x, const double *y, std::size_t n)
+    {
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+            sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), sum1);
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+        }
+        if (i < n)
+        {
+            __mmask8 mask = tail_mask(n - i);
+            sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), sum1);
+        }
+
+        return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+    }
+
+    void axpy(double alpha, const double *x, double *y, std::size_t n)
+    {
+        __m512d a = _mm512_set1_pd(alpha);
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask8 mask = tail_mask(n - i);
+            __m512d sum = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+            _mm512_mask_storeu_pd(y + i, mask, sum);
+        }
+    }
+
+    constexpr int TRANSPOSE_TILE = 8;
+
+    /**
+     * Three rounds of shuffles: interleave pairs of rows, then gather 128-bit lanes of four rows, then of all eight.
+     */
+    void transpose_micro_kernel(const double *in, int in_row_stride, double *out, int out_row_stride)
+    {
+        __m512d rows[TRANSPOSE_TILE];
+        for (int i = 0; i < TRANSPOSE_TILE; i++)
+        {
+            rows[i] = _mm512_loadu_pd(in + i * in_row_stride);
+        }
+
+        // pairs[2 * p] holds the even columns of rows 2p and 2p + 1, pairs[2 * p + 1] the odd ones.
+        __m512d pairs[TRANSPOSE_TILE];
+        for (int p = 0; p < TRANSPOSE_TILE / 2; p++)
+        {
+            pairs[2 * p] = _mm512_unpacklo_pd(rows[2 * p], rows[2 * p + 1]);
+            pairs[2 * p + 1] = _mm512_unpackhi_pd(rows[2 * p], rows[2 * p + 1]);
+        }
+
+        // Columns {0, 4}, {2, 6}, {1, 5} and {3, 7} of rows 0-3, then the same of rows 4-7.
+        __m512d quads[TRANSPOSE_TILE];
+        for (int h = 0; h < 2; h++)
+        {
+            quads[4 * h] = _mm512_shuffle_f64x2(pairs[4 * h], pairs[4 * h + 2], 0x88);
+            quads[4 * h + 1] = _mm512_shuffle_f64x2(pairs[4 * h], pairs[4 * h + 2], 0xDD);
+            quads[4 * h + 2] = _mm512_shuffle_f64x2(pairs[4 * h + 1], pairs[4 * h + 3], 0x88);
+            quads[4 * h + 3] = _mm512_shuffle_f64x2(pairs[4 * h + 1], pairs[4 * h + 3], 0xDD);
+        }
+
+        const int first_column[4] = {0, 2, 1, 3};
+        for (int q = 0; q < 4; q++)
+        {
+            _mm512_storeu_pd(out + first_column[q] * out_row_stride, _mm512_shuffle_f64x2(quads[q], quads[q + 4], 0x88));
+            _mm512_storeu_pd(out + (first_column[q] + 4) * out_row_stride, _mm512_shuffle_f64x2(quads[q], quads[q + 4], 0xDD));
+        }
+    }
+
+    constexpr int FLOAT_MR = 8;
+    constexpr int FLOAT_NR = 32;
+
+    __mmask16 float_tail_mask(std::size_t remaining)
+    {
+        return static_cast<__mmask16>((1u << remaining) - 1);
+    }
+
+    /**
+     * 8 x 32 tile, the same register budget as the double kernel with sixteen floats per ZMM register.
+     */
+    void gemm_micro_kernel(int kc, const float *a, const float *b,
+                           float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m512 ab[FLOAT_MR][2];
+        for (int i = 0; i < FLOAT_MR; i++)
+        {
+            ab[i][0] = _mm512_setzero_ps();
+            ab[i][1] = _mm512_setzero_ps();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m512 b0 = _mm512_loadu_ps(b);
+            __m512 b1 = _mm512_loadu_ps(b + 16);
+            for (int i = 0; i < FLOAT_MR; i++)
+            {
+                __m512 a_value = _mm512_set1_ps(a[i]);
+                ab[i][0] = _mm512_fmadd_ps(a_value, b0, ab[i][0]);
+                ab[i][1] = _mm512_fmadd_ps(a_value, b1, ab[i][1]);
+            }
+            a += FLOAT_MR;
+            b += FLOAT_NR;
+        }
+
+        __mmask16 mask0 = tile_cols >= 16 ? static_cast<__mmask16>(0xffff) : float_tail_mask(tile_cols);
+        __mmask16 mask1 = tile_cols >= 32 ? static_cast<__mmask16>(0xffff) : (tile_cols > 16 ? float_tail_mask(tile_cols - 16) : 0);
+
+        for (int i = 0; i < tile_rows; i++)
+        {
+            float *c_row = c + i * c_row_stride;
+            _mm512_mask_storeu_ps(c_row, mask0, _mm512_add_ps(_mm512_maskz_loadu_ps(mask0, c_row), ab[i][0]));
+            _mm512_mask_storeu_ps(c_row + 16, mask1, _mm512_add_ps(_mm512_maskz_loadu_ps(mask1, c_row + 16), ab[i][1]));
+        }
+    }
+
+    void add(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask16 mask = float_tail_mask(n - i);
+            _mm512_mask_storeu_ps(out + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i)));
+        }
+    }
+
+    void subtract(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask16 mask = float_tail_mask(n - i);
+            _mm512_mask_storeu_ps(out + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i)));
+        }
+    }
+
+    void scale(const float *x, float scalar, float *out, std::size_t n)
+    {
+        __m512 s = _mm512_set1_ps(scalar);
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), s));
+        }
+        if (i < n)
+        {
+            __mmask16 mask = float_tail_mask(n - i);
+            _mm512_mask_storeu_ps(out + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, x + i), s));
+        }
+    }
+
+    float dot(const float *x, const float *y, std::size_t n)
+    {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+            sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), sum1);
+        }
+        for (; i + 16 <= n; i += 16)
+        {
+            sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+        }
+        if (i < n)
+        {
+            __mmask16 mask = float_tail_mask(n - i);
+            sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), sum1);
+        }
+
+        return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+    }
+
+    void axpy(float alpha, const float *x, float *y, std::size_t n)
+    {
+        __m512 a = _mm512_set1_ps(alpha);
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm512_storeu_ps(y + i, _mm512_fmadd_ps(a, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+        }
+        if (i < n)
+        {
+            __mmask16 mask = float_tail_mask(n - i);
+            __m512 sum = _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+            _mm512_mask_storeu_ps(y + i, mask, sum);
+        }
+    }
+
+    constexpr int FLOAT_TRANSPOSE_TILE = 16;
+
+    /**
+     * Four rounds of shuffles: interleave pairs of rows, gather columns of four rows within each 128-bit lane,
+     * then gather lanes of eight rows and of all sixteen.
+     */
+    void transpose_micro_kernel(const float *in, int in_row_stride, float *out, int out_row_stride)
+    {
+        __m512 rows[FLOAT_TRANSPOSE_TILE];
+        for (int i = 0; i < FLOAT_TRANSPOSE_TILE; i++)
+        {
+            rows[i] = _mm512_loadu_ps(in + i * in_row_stride);
+        }
+
+        __m512 pairs[FLOAT_TRANSPOSE_TILE];
+        for (int p = 0; p < FLOAT_TRANSPOSE_TILE / 2; p++)
+        {
+            pairs[2 * p] = _mm512_unpacklo_ps(rows[2 * p], rows[2 * p + 1]);
+            pairs[2 * p + 1] = _mm512_unpackhi_ps(rows[2 * p], rows[2 * p + 1]);
+        }
+
+        // quads[4 * q + c] holds column c of each lane for rows 4q to 4q + 3.
+        __m512 quads[FLOAT_TRANSPOSE_TILE];
+        for (int q = 0; q < 4; q++)
+        {
+            quads[4 * q] = _mm512_shuffle_ps(pairs[4 * q], pairs[4 * q + 2], 0x44);
+            quads[4 * q + 1] = _mm512_shuffle_ps(pairs[4 * q], pairs[4 * q + 2], 0xEE);
+            quads[4 * q + 2] = _mm512_shuffle_ps(pairs[4 * q + 1], pairs[4 * q + 3], 0x44);
+            quads[4 * q + 3] = _mm512_shuffle_ps(pairs[4 * q + 1], pairs[4 * q + 3], 0xEE);
+        }
+
+        for (int c = 0; c < 4; c++)
+        {
+            // Lanes 0 and 1, then lanes 2 and 3, of rows 0-7 and of rows 8-15.
+            __m512 low_upper = _mm512_shuffle_f32x4(quads[c], quads[c + 4], 0x44);
+            __m512 high_upper = _mm512_shuffle_f32x4(quads[c], quads[c + 4], 0xEE);
+            __m512 low_lower = _mm512_shuffle_f32x4(quads[c + 8], quads[c + 12], 0x44);
+            __m512 high_lower = _mm512_shuffle_f32x4(quads[c + 8], quads[c + 12], 0xEE);
+
+            _mm512_storeu_ps(out + c * out_row_stride, _mm512_shuffle_f32x4(low_upper, low_lower, 0x88));
+            _mm512_storeu_ps(out + (c + 4) * out_row_stride, _mm512_shuffle_f32x4(low_upper, low_lower, 0xDD));
+            _mm512_storeu_ps(out + (c + 8) * out_row_stride, _mm512_shuffle_f32x4(high_upper, high_lower, 0x88));
+            _mm512_storeu_ps(out + (c + 12) * out_row_stride, _mm512_shuffle_f32x4(high_upper, high_lower, 0xDD));
+        }
+    }
+
+    const SimdKernelTable<double> DOUBLE_TABLE = {
+        SimdLevel::AVX512,
+        MR,
+        NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+
+    const SimdKernelTable<float> FLOAT_TABLE = {
+        SimdLevel::AVX512,
+        FLOAT_MR,
+        FLOAT_NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        FLOAT_TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+}
+
+template <typename T>
+const SimdKernelTable<T> &avx512_kernel_table();
+
+template <>
+const SimdKernelTable<double> &avx512_kernel_table<double>()
+{
+    return DOUBLE_TABLE;
+}
+
+template <>
+const SimdKernelTable<float> &avx512_kernel_table<float>()
+{
+    return FLOAT_TABLE;
+}
+
+#endif
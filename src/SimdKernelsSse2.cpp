@@ -0,0 +1,414 @@
+#include "../include/SimdKernels.hpp"
+
+#ifdef LINALG_SIMD_X86
+
+#include <emmintrin.h>
+#include <xmmintrin.h>
+
+#include <cstring>
+
+namespace
+{
+    constexpr int MR = 4;
+    constexpr int NR = 4;
+
+    void gemm_micro_kernel(int kc, const double *a, const double *b,
+                           double *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m128d ab[MR][2];
+        for (int i = 0; i < MR; i++)
+        {
+            ab[i][0] = _mm_setzero_pd();
+            ab[i][1] = _mm_setzero_pd();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m128d b0 = _mm_loadu_pd(b);
+            __m128d b1 = _mm_loadu_pd(b + 2);
+            for (int i = 0; i < MR; i++)
+            {
+                __m128d a_value = _mm_set1_pd(a[i]);
+                ab[i][0] = _mm_add_pd(ab[i][0], _mm_mul_pd(a_value, b0));
+                ab[i][1] = _mm_add_pd(ab[i][1], _mm_mul_pd(a_value, b1));
+            }
+            a += MR;
+            b += NR;
+        }
+
+        if (tile_rows == MR && tile_cols == NR)
+        {
+            for (int i = 0; i < MR; i++)
+            {
+                double *c_row = c + i * c_row_stride;
+                _mm_storeu_pd(c_row, _mm_add_pd(_mm_loadu_pd(c_row), ab[i][0]));
+                _mm_storeu_pd(c_row + 2, _mm_add_pd(_mm_loadu_pd(c_row + 2), ab[i][1]));
+            }
+            return;
+        }
+
+        double tile[MR][NR];
+        for (int i = 0; i < MR; i++)
+        {
+            _mm_storeu_pd(tile[i], ab[i][0]);
+            _mm_storeu_pd(tile[i] + 2, ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += tile[i][j];
+            }
+        }
+    }
+
+    void add(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] + y[i];
+        }
+    }
+
+    void subtract(const double *x, const double *y, double *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    void scale(const double *x, double scalar, double *out, std::size_t n)
+    {
+        __m128d s = _mm_set1_pd(scalar);
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(x + i), s));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] * scalar;
+        }
+    }
+
+    double dot(const double *x, const double *y, std::size_t n)
+    {
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+        }
+
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        double result = lanes[0] + lanes[1];
+        for (; i < n; i++)
+        {
+            result += x[i] * y[i];
+        }
+        return result;
+    }
+
+    void axpy(double alpha, const double *x, double *y, std::size_t n)
+    {
+        __m128d a = _mm_set1_pd(alpha);
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+        }
+        for (; i < n; i++)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    constexpr int TRANSPOSE_TILE = 2;
+
+    void transpose_micro_kernel(const double *in, int in_row_stride, double *out, int out_row_stride)
+    {
+        __m128d row0 = _mm_loadu_pd(in);
+        __m128d row1 = _mm_loadu_pd(in + in_row_stride);
+        _mm_storeu_pd(out, _mm_unpacklo_pd(row0, row1));
+        _mm_storeu_pd(out + out_row_stride, _mm_unpackhi_pd(row0, row1));
+    }
+
+    constexpr int FLOAT_MR = 4;
+    constexpr int FLOAT_NR = 8;
+
+    void gemm_micro_kernel(int kc, const float *a, const float *b,
+                           float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m128 ab[FLOAT_MR][2];
+        for (int i = 0; i < FLOAT_MR; i++)
+        {
+            ab[i][0] = _mm_setzero_ps();
+            ab[i][1] = _mm_setzero_ps();
+        }
+
+        for (int p = 0; p < kc; p++)
+        {
+            __m128 b0 = _mm_loadu_ps(b);
+            __m128 b1 = _mm_loadu_ps(b + 4);
+            for (int i = 0; i < FLOAT_MR; i++)
+            {
+                __m128 a_value = _mm_set1_ps(a[i]);
+                ab[i][0] = _mm_add_ps(ab[i][0], _mm_mul_ps(a_value, b0));
+                ab[i][1] = _mm_add_ps(ab[i][1], _mm_mul_ps(a_value, b1));
+            }
+            a += FLOAT_MR;
+            b += FLOAT_NR;
+        }
+
+        if (tile_rows == FLOAT_MR && tile_cols == FLOAT_NR)
+        {
+            for (int i = 0; i < FLOAT_MR; i++)
+            {
+                float *c_row = c + i * c_row_stride;
+                _mm_storeu_ps(c_row, _mm_add_ps(_mm_loadu_ps(c_row), ab[i][0]));
+                _mm_storeu_ps(c_row + 4, _mm_add_ps(_mm_loadu_ps(c_row + 4), ab[i][1]));
+            }
+            return;
+        }
+
+        float tile[FLOAT_MR][FLOAT_NR];
+        for (int i = 0; i < FLOAT_MR; i++)
+        {
+            _mm_storeu_ps(tile[i], ab[i][0]);
+            _mm_storeu_ps(tile[i] + 4, ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += tile[i][j];
+            }
+        }
+    }
+
+    void add(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] + y[i];
+        }
+    }
+
+    void subtract(const float *x, const float *y, float *out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    void scale(const float *x, float scalar, float *out, std::size_t n)
+    {
+        __m128 s = _mm_set1_ps(scalar);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(x + i), s));
+        }
+        for (; i < n; i++)
+        {
+            out[i] = x[i] * scalar;
+        }
+    }
+
+    float dot(const float *x, const float *y, std::size_t n)
+    {
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+        float result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < n; i++)
+        {
+            result += x[i] * y[i];
+        }
+        return result;
+    }
+
+    void axpy(float alpha, const float *x, float *y, std::size_t n)
+    {
+        __m128 a = _mm_set1_ps(alpha);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(a, _mm_loadu_ps(x + i))));
+        }
+        for (; i < n; i++)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    constexpr int FLOAT_TRANSPOSE_TILE = 4;
+
+    void transpose_micro_kernel(const float *in, int in_row_stride, float *out, int out_row_stride)
+    {
+        __m128 row0 = _mm_loadu_ps(in);
+        __m128 row1 = _mm_loadu_ps(in + in_row_stride);
+        __m128 row2 = _mm_loadu_ps(in + 2 * in_row_stride);
+        __m128 row3 = _mm_loadu_ps(in + 3 * in_row_stride);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        _mm_storeu_ps(out, row0);
+        _mm_storeu_ps(out + out_row_stride, row1);
+        _mm_storeu_ps(out + 2 * out_row_stride, row2);
+        _mm_storeu_ps(out + 3 * out_row_stride, row3);
+    }
+
+    constexpr int INT8_MR = 4;
+    constexpr int INT8_NR = 8;
+
+    /**
+     * 4 x 8 tile of int32 sums held in eight XMM accumulators.
+     * Every 32-bit lane of a B load holds the pair (b(2q, j), b(2q + 1, j)) and is multiplied with the broadcast pair of A.
+     */
+    void int8_gemm_micro_kernel(int k_pairs, const std::int16_t *a, const std::int16_t *b,
+                                const float *row_scales, const float *col_scales,
+                                float *c, int c_row_stride, int tile_rows, int tile_cols)
+    {
+        __m128i ab[INT8_MR][2];
+        for (int i = 0; i < INT8_MR; i++)
+        {
+            ab[i][0] = _mm_setzero_si128();
+            ab[i][1] = _mm_setzero_si128();
+        }
+
+        for (int q = 0; q < k_pairs; q++)
+        {
+            __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+            __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 8));
+            for (int i = 0; i < INT8_MR; i++)
+            {
+                std::int32_t pair;
+                std::memcpy(&pair, a + 2 * i, sizeof(pair));
+                __m128i a_pair = _mm_set1_epi32(pair);
+                ab[i][0] = _mm_add_epi32(ab[i][0], _mm_madd_epi16(a_pair, b0));
+                ab[i][1] = _mm_add_epi32(ab[i][1], _mm_madd_epi16(a_pair, b1));
+            }
+            a += 2 * INT8_MR;
+            b += 2 * INT8_NR;
+        }
+
+        if (tile_rows == INT8_MR && tile_cols == INT8_NR)
+        {
+            __m128 col0 = _mm_loadu_ps(col_scales);
+            __m128 col1 = _mm_loadu_ps(col_scales + 4);
+            for (int i = 0; i < INT8_MR; i++)
+            {
+                __m128 row_scale = _mm_set1_ps(row_scales[i]);
+                float *c_row = c + i * c_row_stride;
+                __m128 sum0 = _mm_mul_ps(_mm_mul_ps(row_scale, col0), _mm_cvtepi32_ps(ab[i][0]));
+                __m128 sum1 = _mm_mul_ps(_mm_mul_ps(row_scale, col1), _mm_cvtepi32_ps(ab[i][1]));
+                _mm_storeu_ps(c_row, _mm_add_ps(_mm_loadu_ps(c_row), sum0));
+                _mm_storeu_ps(c_row + 4, _mm_add_ps(_mm_loadu_ps(c_row + 4), sum1));
+            }
+            return;
+        }
+
+        std::int32_t tile[INT8_MR][INT8_NR];
+        for (int i = 0; i < INT8_MR; i++)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(tile[i]), ab[i][0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(tile[i] + 4), ab[i][1]);
+        }
+        for (int i = 0; i < tile_rows; i++)
+        {
+            for (int j = 0; j < tile_cols; j++)
+            {
+                c[i * c_row_stride + j] += row_scales[i] * col_scales[j] * static_cast<float>(tile[i][j]);
+            }
+        }
+    }
+
+    const SimdKernelTable<double> DOUBLE_TABLE = {
+        SimdLevel::SSE2,
+        MR,
+        NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+
+    const SimdKernelTable<float> FLOAT_TABLE = {
+        SimdLevel::SSE2,
+        FLOAT_MR,
+        FLOAT_NR,
+        gemm_micro_kernel,
+        add,
+        subtract,
+        scale,
+        dot,
+        axpy,
+        FLOAT_TRANSPOSE_TILE,
+        transpose_micro_kernel,
+    };
+
+    const Int8KernelTable INT8_TABLE = {
+        SimdLevel::SSE2,
+        INT8_MR,
+        INT8_NR,
+        int8_gemm_micro_kernel,
+    };
+}
+
+template <typename T>
+const SimdKernelTable<T> &sse2_kernel_table();
+
+template <>
+const SimdKernelTable<double> &sse2_kernel_table<double>()
+{
+    return DOUBLE_TABLE;
+}
+
+template <>
+const SimdKernelTable<float> &sse2_kernel_table<float>()
+{
+    return FLOAT_TABLE;
+}
+
+const Int8KernelTable &sse2_int8_kernel_table()
+{
+    return INT8_TABLE;
+}
+
+#endif
@@ -0,0 +1,234 @@
+#include "../include/SparseKernel.hpp"
+#include "../include/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+    /**
+     * Work is handed to the pool in pieces of at least this many multiply-adds.
+     */
+    constexpr std::size_t PARALLEL_GRAIN = 1 << 15;
+
+    /**
+     * Parts per worker, so that parts which turn out slower than others still balance.
+     */
+    constexpr std::size_t PARTS_PER_WORKER = 4;
+
+    /**
+     * Column slices of C are at least this wide, so that workers never write into the same cache line.
+     */
+    constexpr std::size_t MIN_SLICE = 16;
+
+    /**
+     * Returns how many parts work multiply-adds are split into on the pool, at most max_parts.
+     */
+    int part_count(std::size_t work, std::size_t max_parts)
+    {
+        return static_cast<int>(std::max<std::size_t>(1, std::min(max_parts, work / PARALLEL_GRAIN)));
+    }
+
+    /**
+     * Calls fn(first, last) for the line range of every part, spread over the pool.
+     */
+    template <typename F>
+    void for_each_part(ThreadPool &pool, const std::vector<int> &bounds, F &&fn)
+    {
+        pool.parallel_for(0, bounds.size() - 1, 1, [&](std::size_t first_part, std::size_t last_part)
+                          {
+            for (std::size_t part = first_part; part < last_part; part++)
+            {
+                fn(bounds[part], bounds[part + 1]);
+            } });
+    }
+
+    template <typename T>
+    void csr_spmv_rows(int first, int last, const std::size_t *offsets, const int *indices, const T *values,
+                       T alpha, const T *x, T *y)
+    {
+        for (int i = first; i < last; i++)
+        {
+            T sum = 0;
+            for (std::size_t p = offsets[i]; p < offsets[i + 1]; p++)
+            {
+                sum += values[p] * x[indices[p]];
+            }
+            y[i] += alpha * sum;
+        }
+    }
+
+    template <typename T>
+    void csc_spmv_cols(int first, int last, const std::size_t *offsets, const int *indices, const T *values,
+                       T alpha, const T *x, T *y)
+    {
+        for (int j = first; j < last; j++)
+        {
+            T scaled = alpha * x[j];
+            for (std::size_t p = offsets[j]; p < offsets[j + 1]; p++)
+            {
+                y[indices[p]] += scaled * values[p];
+            }
+        }
+    }
+
+    template <typename T>
+    void csr_spmm_rows(int first, int last, int n, const std::size_t *offsets, const int *indices, const T *values,
+                       T alpha, const T *b, int b_row_stride, T *c, int c_row_stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        for (int i = first; i < last; i++)
+        {
+            T *c_row = c + static_cast<std::ptrdiff_t>(i) * c_row_stride;
+            for (std::size_t p = offsets[i]; p < offsets[i + 1]; p++)
+            {
+                kernels.axpy(alpha * values[p], b + static_cast<std::ptrdiff_t>(indices[p]) * b_row_stride, c_row, n);
+            }
+        }
+    }
+}
+
+std::vector<int> SparseKernel::partition(int lines, const std::size_t *offsets, int parts)
+{
+    parts = std::max(parts, 1);
+    std::size_t nonzeros = offsets[lines];
+
+    std::vector<int> bounds(static_cast<std::size_t>(parts) + 1, 0);
+    for (int part = 1; part < parts; part++)
+    {
+        std::size_t target = nonzeros * part / parts;
+        // The line holding the target element, or the next one if its start is closer to the target
+        int line = static_cast<int>(std::upper_bound(offsets, offsets + lines + 1, target) - offsets) - 1;
+        if (line < lines && offsets[line + 1] - target < target - offsets[line])
+        {
+            line++;
+        }
+        bounds[part] = std::max(bounds[part - 1], line);
+    }
+    bounds[parts] = lines;
+
+    return bounds;
+}
+
+template <typename T>
+void SparseKernel::csr_spmv(int rows, const std::size_t *offsets, const int *indices, const T *values, T alpha, const T *x, T *y)
+{
+    csr_spmv_rows(0, rows, offsets, indices, values, alpha, x, y);
+}
+
+template <typename T>
+void SparseKernel::csr_spmv(ThreadPool &pool, int rows, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *x, T *y)
+{
+    int parts = part_count(offsets[rows], pool.size() * PARTS_PER_WORKER);
+    for_each_part(pool, partition(rows, offsets, parts), [&](int first, int last)
+                  { csr_spmv_rows(first, last, offsets, indices, values, alpha, x, y); });
+}
+
+template <typename T>
+void SparseKernel::csc_spmv(int /* rows */, int cols, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *x, T *y)
+{
+    csc_spmv_cols(0, cols, offsets, indices, values, alpha, x, y);
+}
+
+/**
+ * Part 0 accumulates straight into y, the others into zeroed vectors of their own. They are added to y in part
+ * order, so the result only depends on the number of parts.
+ */
+template <typename T>
+void SparseKernel::csc_spmv(ThreadPool &pool, int rows, int cols, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *x, T *y)
+{
+    int parts = part_count(offsets[cols], pool.size());
+    if (parts <= 1)
+    {
+        csc_spmv_cols(0, cols, offsets, indices, values, alpha, x, y);
+        return;
+    }
+
+    std::vector<int> bounds = partition(cols, offsets, parts);
+    std::vector<std::vector<T>> partials(parts - 1);
+    pool.parallel_for(0, parts, 1, [&](std::size_t first_part, std::size_t last_part)
+                      {
+        for (std::size_t part = first_part; part < last_part; part++)
+        {
+            T *out = y;
+            if (part > 0)
+            {
+                partials[part - 1].assign(rows, T(0));
+                out = partials[part - 1].data();
+            }
+            csc_spmv_cols(bounds[part], bounds[part + 1], offsets, indices, values, alpha, x, out);
+        } });
+
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    pool.parallel_for(0, rows, PARALLEL_GRAIN / parts, [&](std::size_t first, std::size_t last)
+                      {
+        for (const std::vector<T> &partial : partials)
+        {
+            kernels.add(y + first, partial.data() + first, y + first, last - first);
+        } });
+}
+
+template <typename T>
+void SparseKernel::csr_spmm(int rows, int n, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *b, int b_row_stride, T *c, int c_row_stride)
+{
+    csr_spmm_rows(0, rows, n, offsets, indices, values, alpha, b, b_row_stride, c, c_row_stride);
+}
+
+template <typename T>
+void SparseKernel::csr_spmm(ThreadPool &pool, int rows, int n, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *b, int b_row_stride, T *c, int c_row_stride)
+{
+    int parts = part_count(offsets[rows] * static_cast<std::size_t>(std::max(n, 1)), pool.size() * PARTS_PER_WORKER);
+    for_each_part(pool, partition(rows, offsets, parts), [&](int first, int last)
+                  { csr_spmm_rows(first, last, n, offsets, indices, values, alpha, b, b_row_stride, c, c_row_stride); });
+}
+
+template <typename T>
+void SparseKernel::csc_spmm(int cols, int n, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *b, int b_row_stride, T *c, int c_row_stride)
+{
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    for (int j = 0; j < cols; j++)
+    {
+        const T *b_row = b + static_cast<std::ptrdiff_t>(j) * b_row_stride;
+        for (std::size_t p = offsets[j]; p < offsets[j + 1]; p++)
+        {
+            kernels.axpy(alpha * values[p], b_row, c + static_cast<std::ptrdiff_t>(indices[p]) * c_row_stride, n);
+        }
+    }
+}
+
+/**
+ * Every element of A touches a whole row of C, so the columns of C are what can be split without write conflicts.
+ */
+template <typename T>
+void SparseKernel::csc_spmm(ThreadPool &pool, int cols, int n, const std::size_t *offsets, const int *indices, const T *values,
+                            T alpha, const T *b, int b_row_stride, T *c, int c_row_stride)
+{
+    std::size_t work = offsets[cols] * static_cast<std::size_t>(std::max(n, 1));
+    std::size_t slice = std::max(MIN_SLICE, static_cast<std::size_t>(n) / part_count(work, pool.size() * PARTS_PER_WORKER));
+    pool.parallel_for(0, n, slice, [&](std::size_t first, std::size_t last)
+                      { csc_spmm(cols, static_cast<int>(last - first), offsets, indices, values,
+                                 alpha, b + first, b_row_stride, c + first, c_row_stride); });
+}
+
+template void SparseKernel::csr_spmv(int, const std::size_t *, const int *, const float *, float, const float *, float *);
+template void SparseKernel::csr_spmv(int, const std::size_t *, const int *, const double *, double, const double *, double *);
+template void SparseKernel::csr_spmv(ThreadPool &, int, const std::size_t *, const int *, const float *, float, const float *, float *);
+template void SparseKernel::csr_spmv(ThreadPool &, int, const std::size_t *, const int *, const double *, double, const double *, double *);
+template void SparseKernel::csc_spmv(int, int, const std::size_t *, const int *, const float *, float, const float *, float *);
+template void SparseKernel::csc_spmv(int, int, const std::size_t *, const int *, const double *, double, const double *, double *);
+template void SparseKernel::csc_spmv(ThreadPool &, int, int, const std::size_t *, const int *, const float *, float, const float *, float *);
+template void SparseKernel::csc_spmv(ThreadPool &, int, int, const std::size_t *, const int *, const double *, double, const double *, double *);
+template void SparseKernel::csr_spmm(int, int, const std::size_t *, const int *, const float *, float, const float *, int, float *, int);
+template void SparseKernel::csr_spmm(int, int, const std::size_t *, const int *, const double *, double, const double *, int, double *, int);
+template void SparseKernel::csr_spmm(ThreadPool &, int, int, const std::size_t *, const int *, const float *, float, const float *, int, float *, int);
+template void SparseKernel::csr_spmm(ThreadPool &, int, int, const std::size_t *, const int *, const double *, double, const double *, int, double *, int);
+template void SparseKernel::csc_spmm(int, int, const std::size_t *, const int *, const float *, float, const float *, int, float *, int);
+template void SparseKernel::csc_spmm(int, int, const std::size_t *, const int *, const double *, double, const double *, int, double *, int);
+template void SparseKernel::csc_spmm(ThreadPool &, int, int, const std::size_t *, const int *, const float *, float, const float *, int, float *, int);
+template void SparseKernel::csc_spmm(ThreadPool &, int, int, const std::size_t *, const int *, const double *, double, const double *, int, double *, int);
@@ -0,0 +1,312 @@
+#include "../include/SparseMatrix.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(int rows, int cols, SparseFormat format, std::shared_ptr<const Arrays> arrays)
+    : rows(rows), cols(cols), format(format), arrays(std::move(arrays)) {}
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(int rows, int cols, SparseFormat format) : rows(rows), cols(cols), format(format)
+{
+    if (rows < 0 || cols < 0)
+    {
+        throw std::invalid_argument("Matrix dimensions must not be negative.");
+    }
+
+    auto empty = std::make_shared<Arrays>();
+    empty->offsets.assign(static_cast<std::size_t>(get_major_size()) + 1, 0);
+    arrays = std::move(empty);
+}
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(int rows, int cols, std::vector<std::size_t> offsets, std::vector<int> indices,
+                                        std::vector<T> values, SparseFormat format) : rows(rows), cols(cols), format(format)
+{
+    if (rows < 0 || cols < 0)
+    {
+        throw std::invalid_argument("Matrix dimensions must not be negative.");
+    }
+
+    int major_size = get_major_size();
+    int minor_size = format == SparseFormat::CSR ? cols : rows;
+    if (offsets.size() != static_cast<std::size_t>(major_size) + 1 || offsets.front() != 0 ||
+        offsets.back() != indices.size() || indices.size() != values.size())
+    {
+        throw InvalidMatrixFormat("Offsets, indices and values do not match the shape of the sparse matrix.");
+    }
+    for (int line = 0; line < major_size; line++)
+    {
+        if (offsets[line] > offsets[line + 1])
+        {
+            throw InvalidMatrixFormat("Offsets of a sparse matrix must not decrease.");
+        }
+        for (std::size_t p = offsets[line]; p < offsets[line + 1]; p++)
+        {
+            if (indices[p] < 0 || indices[p] >= minor_size || (p > offsets[line] && indices[p] <= indices[p - 1]))
+            {
+                throw InvalidMatrixFormat("Indices of a sparse matrix must be in bounds and ascending within each line.");
+            }
+        }
+    }
+
+    auto built = std::make_shared<Arrays>();
+    built->offsets = std::move(offsets);
+    built->indices = std::move(indices);
+    built->values = std::move(values);
+    arrays = std::move(built);
+}
+
+/**
+ * The triplets are bucketed by major line with a counting sort, then every line is sorted and its duplicates merged.
+ */
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::from_triplets(int rows, int cols, const std::vector<SparseTriplet<T>> &triplets,
+                                                         SparseFormat format)
+{
+    BasicSparseMatrix result(rows, cols, format);
+    int major_size = result.get_major_size();
+    bool csr = format == SparseFormat::CSR;
+
+    std::vector<std::size_t> starts(static_cast<std::size_t>(major_size) + 1, 0);
+    for (const SparseTriplet<T> &triplet : triplets)
+    {
+        if (triplet.row < 0 || triplet.row >= rows || triplet.col < 0 || triplet.col >= cols)
+        {
+            throw std::out_of_range("Matrix index out of bounds.");
+        }
+        starts[(csr ? triplet.row : triplet.col) + 1]++;
+    }
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+
+    std::vector<std::pair<int, T>> bucketed(triplets.size());
+    std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+    for (const SparseTriplet<T> &triplet : triplets)
+    {
+        int major = csr ? triplet.row : triplet.col;
+        bucketed[next[major]++] = {csr ? triplet.col : triplet.row, triplet.value};
+    }
+
+    auto built = std::make_shared<Arrays>();
+    built->offsets.assign(starts.size(), 0);
+    built->indices.reserve(triplets.size());
+    built->values.reserve(triplets.size());
+    for (int line = 0; line < major_size; line++)
+    {
+        auto first = bucketed.begin() + starts[line];
+        auto last = bucketed.begin() + starts[line + 1];
+        std::stable_sort(first, last, [](const std::pair<int, T> &left, const std::pair<int, T> &right)
+                         { return left.first < right.first; });
+
+        std::size_t line_start = built->indices.size();
+        for (auto it = first; it != last; ++it)
+        {
+            if (built->indices.size() > line_start && built->indices.back() == it->first)
+            {
+                built->values.back() += it->second;
+            }
+            else
+            {
+                built->indices.push_back(it->first);
+                built->values.push_back(it->second);
+            }
+        }
+        built->offsets[line + 1] = built->indices.size();
+    }
+
+    return BasicSparseMatrix(rows, cols, format, std::move(built));
+}
+
+/**
+ * The view is copied to a dense buffer first, so transposed and padded views are read like any other.
+ * NaNs are never below the tolerance and are kept.
+ */
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::from_dense(const BasicMatrixView<T> &view, SparseFormat format, T drop_tolerance)
+{
+    int rows = view.get_rows();
+    int cols = view.get_cols();
+    std::vector<T> dense(static_cast<std::size_t>(rows) * cols);
+    view.copy_to(dense.data(), cols);
+
+    bool csr = format == SparseFormat::CSR;
+    int major_size = csr ? rows : cols;
+    int minor_size = csr ? cols : rows;
+    std::size_t major_step = csr ? cols : 1;
+    std::size_t minor_step = csr ? 1 : cols;
+
+    auto built = std::make_shared<Arrays>();
+    built->offsets.assign(static_cast<std::size_t>(major_size) + 1, 0);
+    for (int line = 0; line < major_size; line++)
+    {
+        for (int index = 0; index < minor_size; index++)
+        {
+            T value = dense[line * major_step + index * minor_step];
+            if (!(std::abs(value) <= drop_tolerance))
+            {
+                built->indices.push_back(index);
+                built->values.push_back(value);
+            }
+        }
+        built->offsets[line + 1] = built->indices.size();
+    }
+
+    return BasicSparseMatrix(rows, cols, format, std::move(built));
+}
+
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::from_dense(const BasicMatrix<T> &matrix, SparseFormat format, T drop_tolerance)
+{
+    return from_dense(matrix.view(), format, drop_tolerance);
+}
+
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::transpose() const
+{
+    SparseFormat flipped = format == SparseFormat::CSR ? SparseFormat::CSC : SparseFormat::CSR;
+    return BasicSparseMatrix(cols, rows, flipped, arrays);
+}
+
+/**
+ * A counting sort by minor index. Lines are visited in order, so the new minor indices come out ascending.
+ */
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::to_format(SparseFormat target) const
+{
+    if (target == format)
+    {
+        return *this;
+    }
+
+    int major_size = get_major_size();
+    int minor_size = format == SparseFormat::CSR ? cols : rows;
+    const std::vector<std::size_t> &offsets = arrays->offsets;
+    const std::vector<int> &indices = arrays->indices;
+    const std::vector<T> &values = arrays->values;
+
+    auto built = std::make_shared<Arrays>();
+    built->offsets.assign(static_cast<std::size_t>(minor_size) + 1, 0);
+    for (int index : indices)
+    {
+        built->offsets[index + 1]++;
+    }
+    std::partial_sum(built->offsets.begin(), built->offsets.end(), built->offsets.begin());
+
+    built->indices.resize(indices.size());
+    built->values.resize(values.size());
+    std::vector<std::size_t> next(built->offsets.begin(), built->offsets.end() - 1);
+    for (int line = 0; line < major_size; line++)
+    {
+        for (std::size_t p = offsets[line]; p < offsets[line + 1]; p++)
+        {
+            std::size_t q = next[indices[p]]++;
+            built->indices[q] = line;
+            built->values[q] = values[p];
+        }
+    }
+
+    return BasicSparseMatrix(rows, cols, target, std::move(built));
+}
+
+template <typename T>
+BasicMatrix<T> BasicSparseMatrix<T>::to_dense() const
+{
+    BasicMatrix<T> result(rows, cols);
+    T *out = result.data();
+    std::size_t ld = result.get_leading_dimension();
+    bool csr = format == SparseFormat::CSR;
+
+    for (int line = 0; line < get_major_size(); line++)
+    {
+        for (std::size_t p = arrays->offsets[line]; p < arrays->offsets[line + 1]; p++)
+        {
+            std::size_t row = csr ? line : arrays->indices[p];
+            std::size_t col = csr ? arrays->indices[p] : line;
+            out[row * ld + col] = arrays->values[p];
+        }
+    }
+    return result;
+}
+
+template <typename T>
+int BasicSparseMatrix<T>::get_rows() const
+{
+    return rows;
+}
+
+template <typename T>
+int BasicSparseMatrix<T>::get_cols() const
+{
+    return cols;
+}
+
+template <typename T>
+SparseFormat BasicSparseMatrix<T>::get_format() const
+{
+    return format;
+}
+
+template <typename T>
+std::size_t BasicSparseMatrix<T>::get_nonzeros() const
+{
+    return arrays->values.size();
+}
+
+template <typename T>
+const std::vector<std::size_t> &BasicSparseMatrix<T>::get_offsets() const
+{
+    return arrays->offsets;
+}
+
+template <typename T>
+const std::vector<int> &BasicSparseMatrix<T>::get_indices() const
+{
+    return arrays->indices;
+}
+
+template <typename T>
+const std::vector<T> &BasicSparseMatrix<T>::get_values() const
+{
+    return arrays->values;
+}
+
+template <typename T>
+T BasicSparseMatrix<T>::get_element(int row, int col) const
+{
+    if (row < 0 || row >= rows || col < 0 || col >= cols)
+    {
+        throw std::out_of_range("Matrix index out of bounds.");
+    }
+
+    bool csr = format == SparseFormat::CSR;
+    int line = csr ? row : col;
+    int index = csr ? col : row;
+    auto first = arrays->indices.begin() + arrays->offsets[line];
+    auto last = arrays->indices.begin() + arrays->offsets[line + 1];
+    auto found = std::lower_bound(first, last, index);
+    if (found == last || *found != index)
+    {
+        return T(0);
+    }
+    return arrays->values[found - arrays->indices.begin()];
+}
+
+template <typename T>
+void BasicSparseMatrix<T>::display() const
+{
+    to_dense().display();
+}
+
+template <typename T>
+int BasicSparseMatrix<T>::get_major_size() const
+{
+    return format == SparseFormat::CSR ? rows : cols;
+}
+
+template class BasicSparseMatrix<float>;
+template class BasicSparseMatrix<double>;
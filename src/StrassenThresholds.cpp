@@ -0,0 +1,158 @@
+#include "../include/StrassenThresholds.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    std::string format_threshold(int threshold)
+    {
+        return threshold == StrassenThresholds::NEVER ? "never" : std::to_string(threshold);
+    }
+
+    int parse_threshold(const std::string &value)
+    {
+        if (value == "never")
+        {
+            return StrassenThresholds::NEVER;
+        }
+
+        size_t parsed = 0;
+        int threshold = std::stoi(value, &parsed);
+        if (parsed != value.size() || threshold < 0)
+        {
+            throw std::invalid_argument(value);
+        }
+
+        return threshold;
+    }
+}
+
+int StrassenThresholds::threshold_for(int m, int k, int n) const
+{
+    int smallest = std::min({m, k, n});
+    int largest = std::max({m, k, n});
+
+    return largest <= RECTANGULAR_ASPECT_RATIO * smallest ? square : rectangular;
+}
+
+StrassenThresholds StrassenThresholds::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open Strassen config file: " + path);
+    }
+
+    StrassenThresholds thresholds;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+
+        std::istringstream stream(line);
+        std::string key, value, rest;
+        if (!(stream >> key) || key[0] == '#')
+        {
+            continue;
+        }
+
+        try
+        {
+            if (!(stream >> value) || (stream >> rest))
+            {
+                throw std::invalid_argument(line);
+            }
+
+            if (key == "square")
+            {
+                thresholds.square = parse_threshold(value);
+            }
+            else if (key == "rectangular")
+            {
+                thresholds.rectangular = parse_threshold(value);
+            }
+            else
+            {
+                throw std::invalid_argument(key);
+            }
+        }
+        catch (const std::exception &)
+        {
+            throw std::runtime_error("Invalid line " + std::to_string(line_number) + " in Strassen config file: " + path);
+        }
+    }
+
+    return thresholds;
+}
+
+void StrassenThresholds::save(const std::string &path) const
+{
+    std::filesystem::path file_path(path);
+    if (file_path.has_parent_path())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(file_path.parent_path(), error);
+    }
+
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Could not write Strassen config file: " + path);
+    }
+
+    file << "# Strassen crossover thresholds, generated by the autotuner\n";
+    file << "square " << format_threshold(square) << "\n";
+    file << "rectangular " << format_threshold(rectangular) << "\n";
+
+    if (!file)
+    {
+        throw std::runtime_error("Could not write Strassen config file: " + path);
+    }
+}
+
+std::string StrassenThresholds::default_config_path()
+{
+    if (const char *path = std::getenv("LINALG_STRASSEN_CONFIG"))
+    {
+        return path;
+    }
+    if (const char *config_home = std::getenv("XDG_CONFIG_HOME"))
+    {
+        return std::string(config_home) + "/linear-algebra/strassen.conf";
+    }
+    if (const char *home = std::getenv("HOME"))
+    {
+        return std::string(home) + "/.config/linear-algebra/strassen.conf";
+    }
+
+    return "";
+}
+
+const StrassenThresholds &StrassenThresholds::startup_defaults()
+{
+    static const StrassenThresholds thresholds = []()
+    {
+        std::string path = default_config_path();
+        if (path.empty() || !std::filesystem::exists(path))
+        {
+            return StrassenThresholds();
+        }
+
+        try
+        {
+            return load(path);
+        }
+        catch (const std::exception &)
+        {
+            return StrassenThresholds();
+        }
+    }();
+
+    return thresholds;
+}
@@ -0,0 +1,128 @@
+#include "../include/StrassenTuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    Matrix benchmark_matrix(int rows, int cols)
+    {
+        Matrix result(rows, cols);
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < cols; j++)
+            {
+                result.unchecked(i, j) = static_cast<double>((i * 7 + j * 3) % 17) / 17.0 - 0.5;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Once Strassen is this many times slower than the blocked kernel, larger sizes are not tried.
+     * Strassen only gains a constant factor per size doubling, so it would take sizes far beyond
+     * the candidates to catch up.
+     */
+    constexpr double HOPELESS_SLOWDOWN = 4.0;
+}
+
+StrassenTuner::StrassenTuner() {}
+
+StrassenTuner::StrassenTuner(ThreadPool &pool) : thread_pool(&pool) {}
+
+void StrassenTuner::set_sizes(const std::vector<int> &candidate_sizes)
+{
+    if (candidate_sizes.empty())
+    {
+        throw std::invalid_argument("At least one candidate size is required.");
+    }
+    if (*std::min_element(candidate_sizes.begin(), candidate_sizes.end()) < 2)
+    {
+        throw std::invalid_argument("Candidate sizes must be at least 2.");
+    }
+
+    sizes = candidate_sizes;
+    std::sort(sizes.begin(), sizes.end());
+}
+
+void StrassenTuner::set_repetitions(int count)
+{
+    if (count <= 0)
+    {
+        throw std::invalid_argument("Repetitions must be positive.");
+    }
+
+    repetitions = count;
+}
+
+StrassenThresholds StrassenTuner::tune() const
+{
+    StrassenThresholds thresholds;
+    thresholds.square = find_crossover(1);
+    thresholds.rectangular = find_crossover(RECTANGULAR_TUNING_RATIO);
+
+    return thresholds;
+}
+
+int StrassenTuner::find_crossover(int aspect_ratio) const
+{
+    StrassenThresholds blocked_only;
+    blocked_only.square = StrassenThresholds::NEVER;
+    blocked_only.rectangular = StrassenThresholds::NEVER;
+    MatrixOperator blocked_operator = create_operator(blocked_only);
+
+    int crossover = StrassenThresholds::NEVER;
+    int previous_size = sizes.front() / 2;
+    for (int size : sizes)
+    {
+        Matrix m1 = benchmark_matrix(size, size);
+        Matrix m2 = benchmark_matrix(size, size * aspect_ratio);
+
+        StrassenThresholds one_level;
+        one_level.square = size / 2;
+        one_level.rectangular = size / 2;
+        MatrixOperator strassen_operator = create_operator(one_level);
+
+        double blocked_time = time_matmul(blocked_operator, m1, m2);
+        double strassen_time = time_matmul(strassen_operator, m1, m2);
+
+        if (strassen_time < blocked_time)
+        {
+            crossover = previous_size;
+            break;
+        }
+        if (strassen_time > HOPELESS_SLOWDOWN * blocked_time)
+        {
+            break;
+        }
+
+        previous_size = size;
+    }
+
+    return crossover;
+}
+
+double StrassenTuner::time_matmul(const MatrixOperator &mat_operator, const Matrix &m1, const Matrix &m2) const
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repetitions; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Matrix result = mat_operator.matmul(m1, m2);
+        auto end = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+
+    return best;
+}
+
+MatrixOperator StrassenTuner::create_operator(const StrassenThresholds &thresholds) const
+{
+    MatrixOperator mat_operator = thread_pool != nullptr ? MatrixOperator(*thread_pool) : MatrixOperator();
+    mat_operator.set_strassen_thresholds(thresholds);
+
+    return mat_operator;
+}
@@ -0,0 +1,62 @@
+#include "../include/StrassenWorkspace.hpp"
+#include "../include/MatrixAllocator.hpp"
+
+#include <algorithm>
+
+StrassenWorkspace::StrassenWorkspace() : buffer(), buffer_capacity(0), allocation_count(0) {}
+
+/**
+ * Odd dimensions are peeled off before splitting, so a level works on quadrants of (m / 2) x (k / 2),
+ * (k / 2) x (n / 2) and (m / 2) x (n / 2).
+ *
+ * A serial Strassen-Winograd level writes its products into the output quadrants and only keeps one sum
+ * of A quadrants, which later also holds one product, and one sum of B quadrants. A parallel level keeps
+ * all eight operand sums and the three products that do not fit into the output, so that all seven
+ * products can be in flight at once.
+ */
+std::size_t StrassenWorkspace::required_size(int m, int k, int n, int threshold, int parallel_depth)
+{
+    if (std::min({m, k, n}) <= std::max(threshold, 1))
+    {
+        return 0;
+    }
+
+    std::size_t a_block = static_cast<std::size_t>(m / 2) * (k / 2);
+    std::size_t b_block = static_cast<std::size_t>(k / 2) * (n / 2);
+    std::size_t c_block = static_cast<std::size_t>(m / 2) * (n / 2);
+
+    if (parallel_depth > 0)
+    {
+        return 4 * a_block + 4 * b_block + 3 * c_block + 7 * required_size(m / 2, k / 2, n / 2, threshold, parallel_depth - 1);
+    }
+
+    return std::max(a_block, c_block) + b_block + required_size(m / 2, k / 2, n / 2, threshold, 0);
+}
+
+void StrassenWorkspace::reserve(std::size_t count)
+{
+    if (count <= buffer_capacity)
+    {
+        return;
+    }
+
+    buffer.reset();
+    buffer = MatrixAllocator::get_default().allocate_shared(count);
+    buffer_capacity = count;
+    allocation_count++;
+}
+
+double *StrassenWorkspace::data()
+{
+    return buffer.get();
+}
+
+std::size_t StrassenWorkspace::capacity() const
+{
+    return buffer_capacity;
+}
+
+std::size_t StrassenWorkspace::get_allocation_count() const
+{
+    return allocation_count;
+}
@@ -6,41 +6,106 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <random>
+#include <exception>
+#include <algorithm>
+
+namespace
+{
+    /**
+     * The pool and deque index of the worker running on this thread, so that submissions from inside
+     * a task can go to the worker's own deque.
+     */
+    thread_local const ThreadPool *current_pool = nullptr;
+    thread_local size_t current_worker = 0;
+
+    /**
+     * Shared by the caller and the helper tasks of one parallel_for. Chunks are claimed from next_chunk and
+     * remaining_chunks counts down to zero as they finish. Helper tasks that start after every chunk has been
+     * claimed return without touching run_chunk, which lives on the caller's stack.
+     */
+    struct ChunkedLoop
+    {
+        const std::function<void(size_t)> *run_chunk;
+        size_t chunk_count;
+        std::atomic<size_t> next_chunk{0};
+        std::atomic<size_t> remaining_chunks;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+
+        void run_available_chunks()
+        {
+            size_t index;
+            while ((index = next_chunk.fetch_add(1)) < chunk_count)
+            {
+                try
+                {
+                    (*run_chunk)(index);
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                if (remaining_chunks.fetch_sub(1) == 1)
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+            }
+        }
+    };
+
+    std::minstd_rand &steal_rng()
+    {
+        thread_local std::minstd_rand rng(static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        return rng;
+    }
+}
 
 /**
  * @brief Constructs a ThreadPool object with the specified number of worker threads.
  *
  * @param pool_size The number of worker threads to create in the pool.
+ * @param scheduling How tasks are distributed over the workers.
  *
  * The ThreadPool constructor initializes the stop flag to false and creates the specified number of worker threads.
  * Each worker thread is responsible for executing tasks from the task queue. The worker threads continuously wait for tasks
  * to be added to the queue using a condition variable. Once a task is available, the worker thread locks the queue mutex,
  * pops the task from the queue, unlocks the mutex, and executes the task. The worker threads continue to run until the stop
  * flag is set to true and the task queue is empty.
+ *
+ * In work-stealing mode every worker also gets its own deque, which is created before any worker starts.
  */
-ThreadPool::ThreadPool(size_t pool_size)
-    : stop(false)
+ThreadPool::ThreadPool(size_t pool_size, Scheduling scheduling)
+    : stop(false), scheduling(scheduling)
 {
-    for (size_t i = 0; i < pool_size; i++)
+    if (scheduling == Scheduling::WorkStealing)
     {
-        workers.emplace_back([this]
-                             {
-            while (true)
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex);
-                condition.wait(lock, [this] {
-                    return stop || !tasks.empty();
-                });
-                if (stop && tasks.empty())
-                    return;
-
-                auto task = std::move(tasks.front());
-                tasks.pop();
-                lock.unlock();
+        for (size_t i = 0; i < pool_size; i++)
+        {
+            deques.emplace_back(new WorkStealingDeque());
+        }
+    }
 
-                if (task)
-                    task();
-            } });
+    for (size_t i = 0; i < pool_size; i++)
+    {
+        if (scheduling == Scheduling::WorkStealing)
+        {
+            workers.emplace_back([this, i]
+                                 { run_work_stealing_worker(i); });
+        }
+        else
+        {
+            workers.emplace_back([this]
+                                 { run_shared_queue_worker(); });
+        }
     }
 }
 
@@ -59,3 +124,272 @@ ThreadPool::~ThreadPool()
     for (auto &worker : workers)
         worker.join();
 }
+
+bool ThreadPool::run_pending_task()
+{
+    std::function<void()> task;
+    if (!take_task(task))
+    {
+        return false;
+    }
+
+    if (task)
+        task();
+
+    return true;
+}
+
+size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+ThreadPool::Scheduling ThreadPool::get_scheduling() const
+{
+    return scheduling;
+}
+
+/**
+ * In work-stealing mode pending_tasks counts every queued task, wherever it sits. It is raised before the task
+ * is published and checked by idle workers under the mutex, and the submitter only takes the mutex to wake someone
+ * when a worker has announced that it is about to sleep. Both sides use sequentially consistent operations, so
+ * either the sleeping worker sees the new task or the submitter sees the sleeping worker.
+ */
+void ThreadPool::submit(std::function<void()> task)
+{
+    if (scheduling == Scheduling::SharedQueue)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            tasks.emplace(std::move(task));
+        }
+        condition.notify_one();
+        return;
+    }
+
+    pending_tasks.fetch_add(1);
+
+    if (current_pool == this)
+    {
+        deques[current_worker]->push(new std::function<void()>(std::move(task)));
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        tasks.emplace(std::move(task));
+        injected_tasks.fetch_add(1);
+    }
+
+    if (idle_workers.load() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+        }
+        condition.notify_one();
+    }
+}
+
+void ThreadPool::submit_copies(const std::function<void()> &task, size_t copies)
+{
+    if (copies == 0)
+    {
+        return;
+    }
+
+    if (scheduling == Scheduling::WorkStealing && current_pool == this)
+    {
+        pending_tasks.fetch_add(copies);
+        for (size_t i = 0; i < copies; i++)
+        {
+            deques[current_worker]->push(new std::function<void()>(task));
+        }
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (scheduling == Scheduling::WorkStealing)
+        {
+            pending_tasks.fetch_add(copies);
+            injected_tasks.fetch_add(copies);
+        }
+        for (size_t i = 0; i < copies; i++)
+        {
+            tasks.emplace(task);
+        }
+    }
+
+    if (scheduling == Scheduling::SharedQueue || idle_workers.load() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+        }
+        condition.notify_all();
+    }
+}
+
+size_t ThreadPool::chunk_size(size_t count, size_t grain) const
+{
+    size_t target_chunks = std::max<size_t>(workers.size(), 1) * CHUNKS_PER_WORKER;
+
+    return std::max({grain, (count + target_chunks - 1) / target_chunks, size_t(1)});
+}
+
+void ThreadPool::run_chunks(size_t chunk_count, const std::function<void(size_t)> &run_chunk)
+{
+    if (chunk_count <= 1 || workers.empty())
+    {
+        for (size_t i = 0; i < chunk_count; i++)
+        {
+            run_chunk(i);
+        }
+        return;
+    }
+
+    auto loop = std::make_shared<ChunkedLoop>();
+    loop->run_chunk = &run_chunk;
+    loop->chunk_count = chunk_count;
+    loop->remaining_chunks = chunk_count;
+
+    // The caller works on chunks too, so one helper fewer than there are chunks is enough.
+    submit_copies([loop]()
+                  { loop->run_available_chunks(); },
+                  std::min(chunk_count - 1, workers.size()));
+
+    loop->run_available_chunks();
+
+    while (loop->remaining_chunks.load() > 0)
+    {
+        if (!run_pending_task())
+        {
+            std::unique_lock<std::mutex> lock(loop->mutex);
+            loop->done.wait_for(lock, std::chrono::microseconds(100), [&loop]
+                                { return loop->remaining_chunks.load() == 0; });
+        }
+    }
+
+    if (loop->error)
+    {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+bool ThreadPool::take_task(std::function<void()> &task)
+{
+    if (scheduling == Scheduling::SharedQueue)
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (tasks.empty())
+        {
+            return false;
+        }
+
+        task = std::move(tasks.front());
+        tasks.pop();
+        return true;
+    }
+
+    auto take = [this, &task](std::function<void()> *taken)
+    {
+        std::unique_ptr<std::function<void()>> owned(taken);
+        task = std::move(*owned);
+        pending_tasks.fetch_sub(1);
+        return true;
+    };
+
+    bool is_worker = current_pool == this;
+    if (is_worker)
+    {
+        if (std::function<void()> *taken = deques[current_worker]->pop())
+        {
+            return take(taken);
+        }
+    }
+
+    if (injected_tasks.load(std::memory_order_relaxed) > 0)
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (!tasks.empty())
+        {
+            task = std::move(tasks.front());
+            tasks.pop();
+            injected_tasks.fetch_sub(1);
+            pending_tasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    size_t victim_count = deques.size();
+    if (victim_count == 0)
+    {
+        return false;
+    }
+
+    size_t first_victim = steal_rng()() % victim_count;
+    for (size_t i = 0; i < victim_count; i++)
+    {
+        size_t victim = (first_victim + i) % victim_count;
+        if (is_worker && victim == current_worker)
+        {
+            continue;
+        }
+
+        if (std::function<void()> *taken = deques[victim]->steal())
+        {
+            return take(taken);
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run_shared_queue_worker()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        condition.wait(lock, [this]
+                       { return stop || !tasks.empty(); });
+        if (stop && tasks.empty())
+            return;
+
+        auto task = std::move(tasks.front());
+        tasks.pop();
+        lock.unlock();
+
+        if (task)
+            task();
+    }
+}
+
+void ThreadPool::run_work_stealing_worker(size_t index)
+{
+    current_pool = this;
+    current_worker = index;
+
+    while (true)
+    {
+        std::function<void()> task;
+        if (take_task(task))
+        {
+            if (task)
+                task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        idle_workers.fetch_add(1);
+        condition.wait(lock, [this]
+                       { return stop || pending_tasks.load() > 0; });
+        idle_workers.fetch_sub(1);
+
+        if (stop && pending_tasks.load() == 0)
+            return;
+
+        // A task is queued somewhere but might still be in the middle of being published.
+        if (pending_tasks.load() > 0)
+        {
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+}
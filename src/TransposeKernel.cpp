@@ -0,0 +1,285 @@
+#include "../include/TransposeKernel.hpp"
+#include "../include/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace
+{
+    /**
+     * Work is handed to the pool in pieces of at least this many elements.
+     */
+    constexpr std::size_t PARALLEL_GRAIN = 1 << 15;
+
+    /**
+     * The largest tile the micro-kernels use, sizes the stack buffer for swapping tiles.
+     */
+    constexpr int MAX_TILE = 16;
+
+    /**
+     * Splits a side in half, rounded down to a multiple of the tile so that the halves stay tile aligned.
+     */
+    int split_point(int size, int tile)
+    {
+        int half = size / 2;
+        return half >= tile ? half - half % tile : half;
+    }
+
+    template <typename T>
+    void transpose_leaf(int rows, int cols, const T *in, int in_stride, T *out, int out_stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        int tile = kernels.transpose_tile;
+        int full_rows = rows - rows % tile;
+        int full_cols = cols - cols % tile;
+
+        for (int i = 0; i < full_rows; i += tile)
+        {
+            for (int j = 0; j < full_cols; j += tile)
+            {
+                kernels.transpose_micro_kernel(in + i * in_stride + j, in_stride, out + j * out_stride + i, out_stride);
+            }
+        }
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = i < full_rows ? full_cols : 0; j < cols; j++)
+            {
+                out[j * out_stride + i] = in[i * in_stride + j];
+            }
+        }
+    }
+
+    template <typename T>
+    void transpose_recursive(int rows, int cols, const T *in, int in_stride, T *out, int out_stride)
+    {
+        if (rows <= TransposeKernel::LEAF_SIZE && cols <= TransposeKernel::LEAF_SIZE)
+        {
+            transpose_leaf(rows, cols, in, in_stride, out, out_stride);
+            return;
+        }
+
+        int tile = SimdKernels::get<T>().transpose_tile;
+        if (rows >= cols)
+        {
+            int top = split_point(rows, tile);
+            transpose_recursive(top, cols, in, in_stride, out, out_stride);
+            transpose_recursive(rows - top, cols, in + top * in_stride, in_stride, out + top, out_stride);
+        }
+        else
+        {
+            int left = split_point(cols, tile);
+            transpose_recursive(rows, left, in, in_stride, out, out_stride);
+            transpose_recursive(rows, cols - left, in + left, in_stride, out + left * out_stride, out_stride);
+        }
+    }
+
+    /**
+     * Replaces the rows x cols block x with the transpose of the cols x rows block y and vice versa.
+     * Both live in the same matrix on opposite sides of the diagonal, so they do not overlap.
+     */
+    template <typename T>
+    void swap_transpose_leaf(int rows, int cols, T *x, T *y, int stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        int tile = kernels.transpose_tile;
+        int full_rows = rows - rows % tile;
+        int full_cols = cols - cols % tile;
+        T buffer[MAX_TILE * MAX_TILE];
+
+        for (int i = 0; i < full_rows; i += tile)
+        {
+            for (int j = 0; j < full_cols; j += tile)
+            {
+                T *x_tile = x + i * stride + j;
+                T *y_tile = y + j * stride + i;
+                kernels.transpose_micro_kernel(x_tile, stride, buffer, tile);
+                kernels.transpose_micro_kernel(y_tile, stride, x_tile, stride);
+                for (int r = 0; r < tile; r++)
+                {
+                    std::copy(buffer + r * tile, buffer + (r + 1) * tile, y_tile + r * stride);
+                }
+            }
+        }
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = i < full_rows ? full_cols : 0; j < cols; j++)
+            {
+                std::swap(x[i * stride + j], y[j * stride + i]);
+            }
+        }
+    }
+
+    template <typename T>
+    void swap_transpose_recursive(int rows, int cols, T *x, T *y, int stride)
+    {
+        if (rows <= TransposeKernel::LEAF_SIZE && cols <= TransposeKernel::LEAF_SIZE)
+        {
+            swap_transpose_leaf(rows, cols, x, y, stride);
+            return;
+        }
+
+        int tile = SimdKernels::get<T>().transpose_tile;
+        if (rows >= cols)
+        {
+            int top = split_point(rows, tile);
+            swap_transpose_recursive(top, cols, x, y, stride);
+            swap_transpose_recursive(rows - top, cols, x + top * stride, y + top, stride);
+        }
+        else
+        {
+            int left = split_point(cols, tile);
+            swap_transpose_recursive(rows, left, x, y, stride);
+            swap_transpose_recursive(rows, cols - left, x + left, y + left * stride, stride);
+        }
+    }
+
+    template <typename T>
+    void transpose_in_place_leaf(int n, T *data, int stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        int tile = kernels.transpose_tile;
+        int full = n - n % tile;
+        T buffer[MAX_TILE * MAX_TILE];
+
+        for (int i = 0; i < full; i += tile)
+        {
+            T *diagonal = data + i * stride + i;
+            kernels.transpose_micro_kernel(diagonal, stride, buffer, tile);
+            for (int r = 0; r < tile; r++)
+            {
+                std::copy(buffer + r * tile, buffer + (r + 1) * tile, diagonal + r * stride);
+            }
+        }
+
+        // The off-diagonal tiles of the full part, a tile row right of the diagonal with the tile column below it.
+        for (int i = 0; i < full; i += tile)
+        {
+            swap_transpose_leaf(tile, full - i - tile, data + i * stride + i + tile, data + (i + tile) * stride + i, stride);
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = std::max(i + 1, full); j < n; j++)
+            {
+                std::swap(data[i * stride + j], data[j * stride + i]);
+            }
+        }
+    }
+
+    template <typename T>
+    void transpose_in_place_recursive(int n, T *data, int stride)
+    {
+        if (n <= TransposeKernel::LEAF_SIZE)
+        {
+            transpose_in_place_leaf(n, data, stride);
+            return;
+        }
+
+        int half = split_point(n, SimdKernels::get<T>().transpose_tile);
+        transpose_in_place_recursive(half, data, stride);
+        transpose_in_place_recursive(n - half, data + half * stride + half, stride);
+        swap_transpose_recursive(half, n - half, data + half, data + half * stride, stride);
+    }
+}
+
+template <typename T>
+void TransposeKernel::transpose(int rows, int cols, const T *in, int in_row_stride, T *out, int out_row_stride)
+{
+    if (rows <= 0 || cols <= 0)
+    {
+        return;
+    }
+
+    transpose_recursive(rows, cols, in, in_row_stride, out, out_row_stride);
+}
+
+template <typename T>
+void TransposeKernel::transpose(ThreadPool &pool, int rows, int cols, const T *in, int in_row_stride, T *out, int out_row_stride)
+{
+    if (rows <= 0 || cols <= 0)
+    {
+        return;
+    }
+
+    if (rows >= cols)
+    {
+        std::size_t grain = std::max<std::size_t>(LEAF_SIZE, PARALLEL_GRAIN / cols);
+        pool.parallel_for(0, rows, grain, [&](std::size_t first, std::size_t last)
+                          { transpose_recursive(static_cast<int>(last - first), cols,
+                                                in + first * in_row_stride, in_row_stride,
+                                                out + first, out_row_stride); });
+    }
+    else
+    {
+        std::size_t grain = std::max<std::size_t>(LEAF_SIZE, PARALLEL_GRAIN / rows);
+        pool.parallel_for(0, cols, grain, [&](std::size_t first, std::size_t last)
+                          { transpose_recursive(rows, static_cast<int>(last - first),
+                                                in + first, in_row_stride,
+                                                out + first * out_row_stride, out_row_stride); });
+    }
+}
+
+template <typename T>
+void TransposeKernel::transpose_in_place(int n, T *data, int row_stride)
+{
+    if (n <= 1)
+    {
+        return;
+    }
+
+    transpose_in_place_recursive(n, data, row_stride);
+}
+
+/**
+ * The matrix is cut into a grid of square blocks. Block pair (i, j) with i < j is swapped by one task and
+ * diagonal block (i, i) is transposed by one task, so no two tasks touch the same elements.
+ */
+template <typename T>
+void TransposeKernel::transpose_in_place(ThreadPool &pool, int n, T *data, int row_stride)
+{
+    if (n <= 1)
+    {
+        return;
+    }
+
+    int block = LEAF_SIZE * 4;
+    int block_count = (n + block - 1) / block;
+    std::size_t grain = std::max<std::size_t>(1, PARALLEL_GRAIN / (static_cast<std::size_t>(block) * block));
+
+    pool.parallel_for(0, static_cast<std::size_t>(block_count) * block_count, grain, [&](std::size_t first, std::size_t last)
+                      {
+        for (std::size_t index = first; index < last; index++)
+        {
+            int i = static_cast<int>(index / block_count);
+            int j = static_cast<int>(index % block_count);
+            if (j < i)
+            {
+                continue;
+            }
+
+            int rows = std::min(block, n - i * block);
+            int cols = std::min(block, n - j * block);
+            T *upper = data + static_cast<std::ptrdiff_t>(i) * block * row_stride + j * block;
+            if (i == j)
+            {
+                transpose_in_place_recursive(rows, upper, row_stride);
+            }
+            else
+            {
+                T *lower = data + static_cast<std::ptrdiff_t>(j) * block * row_stride + i * block;
+                swap_transpose_recursive(rows, cols, upper, lower, row_stride);
+            }
+        } });
+}
+
+template void TransposeKernel::transpose(int, int, const float *, int, float *, int);
+template void TransposeKernel::transpose(int, int, const double *, int, double *, int);
+template void TransposeKernel::transpose(ThreadPool &, int, int, const float *, int, float *, int);
+template void TransposeKernel::transpose(ThreadPool &, int, int, const double *, int, double *, int);
+template void TransposeKernel::transpose_in_place(int, float *, int);
+template void TransposeKernel::transpose_in_place(int, double *, int);
+template void TransposeKernel::transpose_in_place(ThreadPool &, int, float *, int);
+template void TransposeKernel::transpose_in_place(ThreadPool &, int, double *, int);
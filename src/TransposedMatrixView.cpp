@@ -1,14 +1,18 @@
 #include "../include/MatrixView.hpp"
 #include "../include/TransposedMatrixView.hpp"
 
-TransposedMatrixView::TransposedMatrixView(std::shared_ptr<const double[]> data, int r, int c, int row_off, int col_off)
-    : MatrixView(data, r, c, row_off, col_off) {}
+#include <utility>
+
+template <typename T>
+BasicTransposedMatrixView<T>::BasicTransposedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off)
+    : BasicTransposedMatrixView(std::move(data), r, c, row_off, col_off, r) {}
 
 /**
- * Calls base class MatrixView with rows and cols in the reversed order,
- * thus simulating a transposed matrix.
+ * Element (row, col) of the view is element (col, row) of the data, whose rows are data_row_stride elements apart.
  */
-double TransposedMatrixView::get_element(int row, int col) const
-{
-    return MatrixView::parent_data[(col + MatrixView::col_offset) * rows + row + MatrixView::row_offset];
-}
+template <typename T>
+BasicTransposedMatrixView<T>::BasicTransposedMatrixView(std::shared_ptr<const T[]> data, int r, int c, int row_off, int col_off, int data_row_stride)
+    : BasicMatrixView<T>(data, data.get() + static_cast<std::ptrdiff_t>(col_off) * data_row_stride + row_off, r, c, 1, data_row_stride, r, c) {}
+
+template class BasicTransposedMatrixView<float>;
+template class BasicTransposedMatrixView<double>;
@@ -0,0 +1,113 @@
+#include "../include/Vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+template <typename T>
+BasicVector<T>::BasicVector(int size, bool zero_initialize) : size(size)
+{
+    if (size < 0)
+    {
+        throw std::invalid_argument("Vector size must not be negative.");
+    }
+
+    storage = MatrixAllocator::get_default().allocate_shared<T>(size);
+    if (zero_initialize)
+    {
+        std::fill(storage.get(), storage.get() + size, T(0));
+    }
+}
+
+template <typename T>
+BasicVector<T>::BasicVector(int size) : BasicVector(size, true) {}
+
+template <typename T>
+BasicVector<T>::BasicVector(const std::vector<T> &values) : BasicVector(static_cast<int>(values.size()), false)
+{
+    std::copy(values.begin(), values.end(), storage.get());
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::uninitialized(int size)
+{
+    return BasicVector(size, false);
+}
+
+template <typename T>
+int BasicVector<T>::get_size() const
+{
+    return size;
+}
+
+template <typename T>
+T &BasicVector<T>::operator()(int i)
+{
+    check_index(i);
+    return data()[i];
+}
+
+template <typename T>
+const T &BasicVector<T>::operator()(int i) const
+{
+    check_index(i);
+    return storage[i];
+}
+
+template <typename T>
+void BasicVector<T>::set_element(int i, T val)
+{
+    (*this)(i) = val;
+}
+
+template <typename T>
+T BasicVector<T>::get_element(int i) const
+{
+    return (*this)(i);
+}
+
+template <typename T>
+BasicMatrixView<T> BasicVector<T>::view() const
+{
+    return BasicMatrixView<T>(storage, size, 1, 0, 0);
+}
+
+template <typename T>
+std::vector<T> BasicVector<T>::to_std_vector() const
+{
+    return std::vector<T>(storage.get(), storage.get() + size);
+}
+
+template <typename T>
+void BasicVector<T>::display() const
+{
+    for (int i = 0; i < size; i++)
+    {
+        std::cout << storage[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+template <typename T>
+void BasicVector<T>::clone_storage(bool keep_contents)
+{
+    std::shared_ptr<T[]> clone = MatrixAllocator::get_default().allocate_shared<T>(size);
+    if (keep_contents)
+    {
+        std::copy(storage.get(), storage.get() + size, clone.get());
+    }
+    storage = std::move(clone);
+}
+
+template <typename T>
+void BasicVector<T>::check_index(int i) const
+{
+    if (i < 0 || i >= size)
+    {
+        throw std::out_of_range("Vector index out of bounds.");
+    }
+}
+
+template class BasicVector<float>;
+template class BasicVector<double>;
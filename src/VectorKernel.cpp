@@ -0,0 +1,152 @@
+#include "../include/VectorKernel.hpp"
+#include "../include/SimdKernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+    /**
+     * Work is handed to the pool in pieces of at least this many elements.
+     */
+    constexpr std::size_t PARALLEL_GRAIN = 1 << 15;
+
+    /**
+     * Column-wise products accumulate into slices of y this long, which stay in L1 while every column streams past.
+     */
+    constexpr int Y_SLICE = 1024;
+
+    /**
+     * Returns how many rows of the given width make up one PARALLEL_GRAIN piece.
+     */
+    std::size_t rows_per_piece(int cols)
+    {
+        return std::max<std::size_t>(1, PARALLEL_GRAIN / std::max(cols, 1));
+    }
+
+    /**
+     * Computes rows [first, last) of y += alpha * A * x.
+     */
+    template <typename T>
+    void gemv_rows(int first, int last, int n, T alpha, const T *a, int a_row_stride, int a_col_stride, const T *x, T *y)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+
+        if (a_col_stride == 1)
+        {
+            for (int i = first; i < last; i++)
+            {
+                y[i] += alpha * kernels.dot(a + static_cast<std::ptrdiff_t>(i) * a_row_stride, x, n);
+            }
+        }
+        else if (a_row_stride == 1)
+        {
+            for (int slice = first; slice < last; slice += Y_SLICE)
+            {
+                std::size_t length = std::min(Y_SLICE, last - slice);
+                for (int j = 0; j < n; j++)
+                {
+                    kernels.axpy(alpha * x[j], a + static_cast<std::ptrdiff_t>(j) * a_col_stride + slice, y + slice, length);
+                }
+            }
+        }
+        else
+        {
+            for (int i = first; i < last; i++)
+            {
+                const T *row = a + static_cast<std::ptrdiff_t>(i) * a_row_stride;
+                T sum = 0;
+                for (int j = 0; j < n; j++)
+                {
+                    sum += row[static_cast<std::ptrdiff_t>(j) * a_col_stride] * x[j];
+                }
+                y[i] += alpha * sum;
+            }
+        }
+    }
+
+    template <typename T>
+    void ger_rows(int first, int last, int n, T alpha, const T *x, const T *y, T *a, int a_row_stride)
+    {
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        for (int i = first; i < last; i++)
+        {
+            kernels.axpy(alpha * x[i], y, a + static_cast<std::ptrdiff_t>(i) * a_row_stride, n);
+        }
+    }
+}
+
+template <typename T>
+void VectorKernel::gemv(int m, int n, T alpha, const T *a, int a_row_stride, int a_col_stride, const T *x, T *y)
+{
+    gemv_rows(0, m, n, alpha, a, a_row_stride, a_col_stride, x, y);
+}
+
+template <typename T>
+void VectorKernel::gemv(ThreadPool &pool, int m, int n, T alpha, const T *a, int a_row_stride, int a_col_stride, const T *x, T *y)
+{
+    pool.parallel_for(0, m, rows_per_piece(n), [&](std::size_t first, std::size_t last)
+                      { gemv_rows(static_cast<int>(first), static_cast<int>(last), n, alpha, a, a_row_stride, a_col_stride, x, y); });
+}
+
+template <typename T>
+void VectorKernel::ger(int m, int n, T alpha, const T *x, const T *y, T *a, int a_row_stride)
+{
+    ger_rows(0, m, n, alpha, x, y, a, a_row_stride);
+}
+
+template <typename T>
+void VectorKernel::ger(ThreadPool &pool, int m, int n, T alpha, const T *x, const T *y, T *a, int a_row_stride)
+{
+    pool.parallel_for(0, m, rows_per_piece(n), [&](std::size_t first, std::size_t last)
+                      { ger_rows(static_cast<int>(first), static_cast<int>(last), n, alpha, x, y, a, a_row_stride); });
+}
+
+template <typename T>
+T VectorKernel::dot(std::size_t n, const T *x, const T *y)
+{
+    return SimdKernels::get<T>().dot(x, y, n);
+}
+
+template <typename T>
+T VectorKernel::dot(ThreadPool &pool, std::size_t n, const T *x, const T *y)
+{
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    return pool.parallel_reduce(
+        0, n, PARALLEL_GRAIN, T(0),
+        [&](std::size_t first, std::size_t last)
+        { return kernels.dot(x + first, y + first, last - first); },
+        [](T left, T right)
+        { return left + right; });
+}
+
+template <typename T>
+void VectorKernel::axpy(std::size_t n, T alpha, const T *x, T *y)
+{
+    SimdKernels::get<T>().axpy(alpha, x, y, n);
+}
+
+template <typename T>
+void VectorKernel::axpy(ThreadPool &pool, std::size_t n, T alpha, const T *x, T *y)
+{
+    const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+    pool.parallel_for(0, n, PARALLEL_GRAIN, [&](std::size_t first, std::size_t last)
+                      { kernels.axpy(alpha, x + first, y + first, last - first); });
+}
+
+template void VectorKernel::gemv(int, int, float, const float *, int, int, const float *, float *);
+template void VectorKernel::gemv(int, int, double, const double *, int, int, const double *, double *);
+template void VectorKernel::gemv(ThreadPool &, int, int, float, const float *, int, int, const float *, float *);
+template void VectorKernel::gemv(ThreadPool &, int, int, double, const double *, int, int, const double *, double *);
+template void VectorKernel::ger(int, int, float, const float *, const float *, float *, int);
+template void VectorKernel::ger(int, int, double, const double *, const double *, double *, int);
+template void VectorKernel::ger(ThreadPool &, int, int, float, const float *, const float *, float *, int);
+template void VectorKernel::ger(ThreadPool &, int, int, double, const double *, const double *, double *, int);
+template float VectorKernel::dot(std::size_t, const float *, const float *);
+template double VectorKernel::dot(std::size_t, const double *, const double *);
+template float VectorKernel::dot(ThreadPool &, std::size_t, const float *, const float *);
+template double VectorKernel::dot(ThreadPool &, std::size_t, const double *, const double *);
+template void VectorKernel::axpy(std::size_t, float, const float *, float *);
+template void VectorKernel::axpy(std::size_t, double, const double *, double *);
+template void VectorKernel::axpy(ThreadPool &, std::size_t, float, const float *, float *);
+template void VectorKernel::axpy(ThreadPool &, std::size_t, double, const double *, double *);
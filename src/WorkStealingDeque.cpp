@@ -0,0 +1,119 @@
+#include "../include/WorkStealingDeque.hpp"
+
+WorkStealingDeque::Buffer::Buffer(std::int64_t capacity)
+    : capacity(capacity), slots(new std::atomic<Task *>[capacity])
+{
+    for (std::int64_t i = 0; i < capacity; i++)
+    {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+WorkStealingDeque::Task *WorkStealingDeque::Buffer::get(std::int64_t index) const
+{
+    return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+}
+
+void WorkStealingDeque::Buffer::put(std::int64_t index, Task *task)
+{
+    slots[index & (capacity - 1)].store(task, std::memory_order_relaxed);
+}
+
+WorkStealingDeque::WorkStealingDeque(std::size_t initial_capacity) : top(0), bottom(0)
+{
+    std::int64_t capacity = 1;
+    while (capacity < static_cast<std::int64_t>(initial_capacity))
+    {
+        capacity *= 2;
+    }
+
+    buffers.emplace_back(new Buffer(capacity));
+    buffer.store(buffers.back().get(), std::memory_order_relaxed);
+}
+
+void WorkStealingDeque::push(Task *task)
+{
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_acquire);
+    Buffer *current = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > current->capacity - 1)
+    {
+        current = grow(current, t, b);
+    }
+
+    current->put(b, task);
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+WorkStealingDeque::Task *WorkStealingDeque::pop()
+{
+    std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *current = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // Empty.
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task *task = current->get(b);
+    if (t == b)
+    {
+        // Last task: race the thieves for it.
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return task;
+}
+
+WorkStealingDeque::Task *WorkStealingDeque::steal()
+{
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+    {
+        return nullptr;
+    }
+
+    Buffer *current = buffer.load(std::memory_order_acquire);
+    Task *task = current->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    return task;
+}
+
+std::size_t WorkStealingDeque::size() const
+{
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+}
+
+WorkStealingDeque::Buffer *WorkStealingDeque::grow(Buffer *old_buffer, std::int64_t top_index, std::int64_t bottom_index)
+{
+    buffers.emplace_back(new Buffer(old_buffer->capacity * 2));
+    Buffer *new_buffer = buffers.back().get();
+
+    for (std::int64_t i = top_index; i < bottom_index; i++)
+    {
+        new_buffer->put(i, old_buffer->get(i));
+    }
+
+    buffer.store(new_buffer, std::memory_order_release);
+    return new_buffer;
+}
@@ -1,6 +1,52 @@
+#include "../include/StrassenThresholds.hpp"
+#include "../include/StrassenTuner.hpp"
+#include "../include/ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
 #include <iostream>
+#include <string>
+#include <thread>
 
-int main()
+/**
+ * Usage: linear_algebra --tune-strassen [config_path]
+ *
+ * Measures the Strassen crossover on this machine and writes it to config_path, or to
+ * StrassenThresholds::default_config_path() if no path is given. The file is picked up
+ * by every MatrixOperator created afterwards. Prints the usage and exits with status 1 on any
+ * other arguments, or the error if the file can not be written.
+ */
+int main(int argc, char **argv)
 {
+    if (argc < 2 || argc > 3 || std::string(argv[1]) != "--tune-strassen")
+    {
+        std::cerr << "Usage: " << argv[0] << " --tune-strassen [config_path]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argc >= 3 ? argv[2] : StrassenThresholds::default_config_path();
+    if (path.empty())
+    {
+        std::cerr << "No config path given and no default location available." << std::endl;
+        return 1;
+    }
+
+    ThreadPool thread_pool(std::max(1u, std::thread::hardware_concurrency()), ThreadPool::Scheduling::WorkStealing);
+    StrassenTuner tuner(thread_pool);
+    StrassenThresholds thresholds = tuner.tune();
+    try
+    {
+        thresholds.save(path);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Square threshold: " << thresholds.square << std::endl;
+    std::cout << "Rectangular threshold: " << thresholds.rectangular << std::endl;
+    std::cout << "Written to " << path << std::endl;
+
     return 0;
-};
\ No newline at end of file
+};
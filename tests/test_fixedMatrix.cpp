@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "../include/FixedMatrix.hpp"
+#include "../include/Matrix.hpp"
+#include "../include/MatrixOperator.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    constexpr FixedMatrix<2, 3> A({1, 2, 3,
+                                   4, 5, 6});
+    constexpr FixedMatrix<3, 2> B({7, 8,
+                                   9, 10,
+                                   11, 12});
+    constexpr FixedMatrix<3, 3> TRANSFORM({2, 0, 1,
+                                           1, 1, 0,
+                                           0, 0, 4});
+}
+
+// Everything below is evaluated by the compiler.
+static_assert(A * B == FixedMatrix<2, 2>({58, 64, 139, 154}), "multiply");
+static_assert(A + A == A * 2.0, "add");
+static_assert(A - A == FixedMatrix<2, 3>(), "subtract");
+static_assert(A.transpose() == FixedMatrix<3, 2>({1, 4, 2, 5, 3, 6}), "transpose");
+static_assert(TRANSFORM * TRANSFORM.inverse() == FixedMatrix<3, 3>::identity(), "inverse");
+static_assert(FixedMatrix<4, 4>::identity().inverse() == FixedMatrix<4, 4>::identity(), "inverse of identity");
+static_assert((FixedMatrix<1, 3>({1, 2, 3}) * FixedMatrix<3, 1>({4, 5, 6}))(0, 0) == 32, "row times column");
+
+TEST(FixedMatrixTest, ArithmeticMatchesMatrix)
+{
+    FixedMatrix<8, 8> X;
+    FixedMatrix<8, 8> Y;
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            X(i, j) = (i * 3 + j * 5) % 7 - 3;
+            Y(i, j) = (i * 5 + j * 2) % 11 - 5;
+        }
+    }
+
+    MatrixOperator matrix_operator;
+    Matrix product = matrix_operator.matmul(X.to_matrix(), Y.to_matrix());
+    Matrix sum = X.to_matrix() + Y.to_matrix();
+
+    FixedMatrix<8, 8> fixed_product = X * Y;
+    FixedMatrix<8, 8> fixed_sum = X;
+    fixed_sum += Y;
+    FixedMatrix<8, 8> transposed = X.transpose();
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            EXPECT_EQ(fixed_product(i, j), product(i, j));
+            EXPECT_EQ(fixed_sum(i, j), sum(i, j));
+            EXPECT_EQ(transposed(i, j), X(j, i));
+        }
+    }
+}
+
+TEST(FixedMatrixTest, InverseWithPivoting)
+{
+    // The leading zero forces a row swap.
+    FixedMatrix<4, 4> M({0, 2, 1, 3,
+                         1, 1, 0, 2,
+                         4, 0, 1, 1,
+                         2, 3, 5, 1});
+    FixedMatrix<4, 4> product = M * M.inverse();
+    FixedMatrix<4, 4> identity = FixedMatrix<4, 4>::identity();
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            EXPECT_NEAR(product(i, j), identity(i, j), 1e-12);
+        }
+    }
+
+    FixedMatrix<3, 3> singular({1, 2, 3,
+                                2, 4, 6,
+                                0, 1, 1});
+    EXPECT_THROW(singular.inverse(), std::domain_error);
+}
+
+TEST(FixedMatrixTest, ConvertsToAndFromMatrix)
+{
+    Matrix M(5, 12);
+    for (int i = 0; i < 5; i++)
+    {
+        for (int j = 0; j < 12; j++)
+        {
+            M(i, j) = i * 12 + j;
+        }
+    }
+
+    FixedMatrix<5, 12> from_matrix(M);
+    FixedMatrix<3, 4> from_view(M.view().sub_view(1, 2, 3, 4));
+    FixedMatrix<12, 5> from_transposed(M.transpose_view());
+    EXPECT_EQ(from_matrix(4, 11), 59);
+    EXPECT_EQ(from_view(2, 3), M(3, 5));
+    EXPECT_EQ(from_transposed(11, 4), 59);
+
+    Matrix back = from_view.to_matrix();
+    ASSERT_EQ(back.get_rows(), 3);
+    ASSERT_EQ(back.get_cols(), 4);
+    EXPECT_EQ(back(0, 0), M(1, 2));
+
+    MatrixView view = from_view.view();
+    EXPECT_EQ(view.get_element(1, 2), M(2, 4));
+
+    EXPECT_THROW((FixedMatrix<4, 12>(M)), InvalidMatrixFormat);
+    EXPECT_THROW((FixedMatrix<5, 12>(M.transpose_view())), InvalidMatrixFormat);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
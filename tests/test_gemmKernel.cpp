@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include "../include/GemmKernel.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST(GemmKernelTest, MultiplyRowMajor)
+{
+    GemmKernel kernel;
+
+    int m = 13, n = 19, k = 7;
+    std::vector<double> a = filled_buffer(m * k, 1);
+    std::vector<double> b = filled_buffer(k * n, 2);
+    std::vector<double> c(m * n, 0.0);
+
+    kernel.multiply(m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(), n);
+
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            double expected = 0;
+            for (int p = 0; p < k; p++)
+            {
+                expected += a[i * k + p] * b[p * n + j];
+            }
+            EXPECT_EQ(c[i * n + j], expected);
+        }
+    }
+}
+
+TEST(GemmKernelTest, MultiplyAccumulatesIntoC)
+{
+    GemmKernel kernel;
+
+    std::vector<double> a = {1, 2, 3, 4};
+    std::vector<double> b = {5, 6, 7, 8};
+    std::vector<double> c = {1, 1, 1, 1};
+
+    kernel.multiply(2, 2, 2, a.data(), 2, 1, b.data(), 2, 1, c.data(), 2);
+
+    EXPECT_EQ(c[0], 1 + 5 + 2 * 7);
+    EXPECT_EQ(c[1], 1 + 6 + 2 * 8);
+    EXPECT_EQ(c[2], 1 + 3 * 5 + 4 * 7);
+    EXPECT_EQ(c[3], 1 + 3 * 6 + 4 * 8);
+}
+
+TEST(GemmKernelTest, MultiplyTransposedOperandsWithSmallBlocks)
+{
+    GemmBlockSizes block_sizes;
+    block_sizes.mc = 5;
+    block_sizes.kc = 3;
+    block_sizes.nc = 9;
+    GemmKernel kernel(block_sizes);
+
+    int m = 17, n = 23, k = 11;
+
+    // A is stored as its transpose (k x m) and B as its transpose (n x k).
+    std::vector<double> a_t = filled_buffer(k * m, 3);
+    std::vector<double> b_t = filled_buffer(n * k, 4);
+    std::vector<double> c(m * n, 0.0);
+
+    kernel.multiply(m, n, k, a_t.data(), 1, m, b_t.data(), 1, k, c.data(), n);
+
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            double expected = 0;
+            for (int p = 0; p < k; p++)
+            {
+                expected += a_t[p * m + i] * b_t[j * k + p];
+            }
+            EXPECT_EQ(c[i * n + j], expected);
+        }
+    }
+}
+
+TEST(GemmKernelTest, MultiplyOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    GemmKernel kernel;
+
+    int m = 67, n = 53, k = 31;
+    std::vector<double> a = filled_buffer(m * k, 5);
+    std::vector<double> b = filled_buffer(k * n, 6);
+    std::vector<double> c(m * n, 0.0);
+
+    kernel.multiply(thread_pool, m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(), n);
+
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            double expected = 0;
+            for (int p = 0; p < k; p++)
+            {
+                expected += a[i * k + p] * b[p * n + j];
+            }
+            EXPECT_EQ(c[i * n + j], expected);
+        }
+    }
+}
+
+TEST(GemmKernelTest, MultiplyFloatWithSmallBlocksOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    GemmBlockSizes block_sizes;
+    block_sizes.mc = 24;
+    block_sizes.kc = 16;
+    block_sizes.nc = 48;
+    GemmKernel kernel(block_sizes);
+
+    int m = 67, n = 101, k = 37;
+    std::vector<double> a_values = filled_buffer(m * k, 7);
+    std::vector<double> b_values = filled_buffer(k * n, 8);
+    std::vector<float> a(a_values.begin(), a_values.end());
+    std::vector<float> b(b_values.begin(), b_values.end());
+    std::vector<float> c(m * n, 1.0f);
+
+    kernel.multiply(thread_pool, m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(), n, 0.5);
+
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            float expected = 0;
+            for (int p = 0; p < k; p++)
+            {
+                expected += a[i * k + p] * b[p * n + j];
+            }
+            EXPECT_EQ(c[i * n + j], 1.0f + 0.5f * expected);
+        }
+    }
+}
+
+/**
+ * 1e8 + 1 is not a float, so a float accumulator would drop every one of the 1000 unit products.
+ */
+TEST(GemmKernelTest, MultiplyFloatOperandsIntoDouble)
+{
+    GemmKernel kernel;
+
+    int k = 1001;
+    std::vector<float> a(2 * k, 1.0f);
+    std::vector<float> b(k * 3, 1.0f);
+    a[0] = 1e8f;
+    std::vector<double> c(2 * 3, 0.0);
+
+    kernel.multiply(2, 3, k, a.data(), k, 1, b.data(), 3, 1, c.data(), 3);
+
+    for (int j = 0; j < 3; j++)
+    {
+        EXPECT_EQ(c[j], 1e8 + 1000);
+        EXPECT_EQ(c[3 + j], 1001.0);
+    }
+}
+
+TEST(GemmKernelTest, MultiplyInt8OnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    GemmKernel kernel;
+
+    int m = 67, n = 53, k = 31;
+    std::vector<double> a_values = filled_buffer(m * k, 9);
+    std::vector<double> b_values = filled_buffer(k * n, 10);
+    std::vector<std::int8_t> a(a_values.begin(), a_values.end());
+    std::vector<std::int8_t> b(b_values.begin(), b_values.end());
+    std::vector<float> row_scales(m, 0.5f);
+    std::vector<float> col_scales(n, 0.25f);
+    std::vector<float> c(m * n, 0.0f);
+
+    kernel.multiply_int8(thread_pool, m, n, k, a.data(), k, row_scales.data(), b.data(), n, col_scales.data(), c.data(), n);
+
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            double expected = 0;
+            for (int p = 0; p < k; p++)
+            {
+                expected += a_values[i * k + p] * b_values[p * n + j];
+            }
+            EXPECT_EQ(c[i * n + j], static_cast<float>(0.125 * expected));
+        }
+    }
+}
+
+TEST(GemmKernelTest, ThrowsOnInvalidBlockSizes)
+{
+    GemmBlockSizes block_sizes;
+    block_sizes.kc = 0;
+
+    EXPECT_THROW(GemmKernel kernel(block_sizes), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
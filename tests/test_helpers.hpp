@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../include/Matrix.hpp"
+
+#include <vector>
+
+/**
+ * Seeded test data shared by the test executables. Elements are small integers, so every sum and product is exact
+ * and kernels that add in different orders agree bit for bit.
+ */
+
+/**
+ * Returns size elements between -5 and 5.
+ */
+template <typename T = double>
+std::vector<T> filled_buffer(int size, int seed)
+{
+    std::vector<T> buffer(size);
+    for (int i = 0; i < size; i++)
+    {
+        buffer[i] = static_cast<T>((i * 7 + seed) % 11 - 5);
+    }
+    return buffer;
+}
+
+/**
+ * Returns a rows x cols matrix with elements between -6 and 6.
+ */
+template <typename T = double>
+BasicMatrix<T> filled_matrix(int rows, int cols, int seed)
+{
+    BasicMatrix<T> M(rows, cols);
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            M(i, j) = static_cast<T>((i * 31 + j * 17 + seed) % 13 - 6);
+        }
+    }
+    return M;
+}
+
+/**
+ * Returns a rows x cols matrix in which about one element in density is nonzero, with values between -4 and 4.
+ */
+template <typename T = double>
+BasicMatrix<T> sparse_matrix(int rows, int cols, int density, int seed)
+{
+    BasicMatrix<T> M(rows, cols);
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            if ((i * 13 + j * 5 + seed) % density == 0)
+            {
+                M(i, j) = static_cast<T>((i + j + seed) % 9 - 4);
+            }
+        }
+    }
+    return M;
+}
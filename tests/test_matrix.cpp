@@ -4,6 +4,7 @@
 #include "../include/InvalidMatrixFormat.hpp"
 #include "../include/TransposedMatrixView.hpp"
 
+#include <cstdint>
 #include <iostream>
 
 TEST(MatrixTest, TestSetElement)
@@ -258,9 +259,397 @@ TEST(MatrixTest, TestSubtractionOperatorNegativeNumbers)
     }
 }
 
+TEST(MatrixTest, TestScalarMultiplicationOperator)
+{
+    Matrix A(2, 3);
+
+    std::vector<std::vector<double>> AData = {{1, 2, 3}, {4, 5, 6}};
+    A.set_data(AData);
+
+    Matrix B = A * 3;
+
+    for (int i = 0; i < B.get_rows(); i++)
+    {
+        for (int j = 0; j < B.get_cols(); j++)
+        {
+            EXPECT_EQ(B.get_element(i, j), AData[i][j] * 3);
+        }
+    }
+}
+
+TEST(MatrixTest, TestUncheckedAccess)
+{
+    Matrix A(2, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}});
+
+    EXPECT_EQ(A.data()[4], 5);
+    EXPECT_EQ(A.unchecked(1, 2), 6);
+
+    A.unchecked(0, 1) = 20;
+    EXPECT_EQ(A(0, 1), 20);
+
+    const Matrix &B = A;
+    EXPECT_EQ(B.unchecked(0, 1), 20);
+    EXPECT_EQ(B.data(), A.data());
+}
+
+TEST(MatrixTest, TestRowSpans)
+{
+    Matrix A(3, 2);
+    A.set_data({{1, 2}, {3, 4}, {5, 6}});
+
+    Span<double> row = A.row(1);
+    EXPECT_EQ(row.size(), 2);
+    EXPECT_EQ(row.data(), A.data() + 2);
+
+    for (double &value : row)
+    {
+        value *= 10;
+    }
+    EXPECT_EQ(A(1, 0), 30);
+    EXPECT_EQ(A(1, 1), 40);
+
+    const Matrix &B = A;
+    double sum = 0;
+    for (double value : B.row(2))
+    {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 11);
+}
+
+TEST(MatrixTest, TestColumnIterators)
+{
+    Matrix A(3, 2);
+    A.set_data({{1, 2}, {3, 4}, {5, 6}});
+
+    StridedSpan<double> column = A.column(1);
+    EXPECT_EQ(column.size(), 3);
+    EXPECT_EQ(column[2], 6);
+
+    std::vector<double> values(column.begin(), column.end());
+    EXPECT_EQ(values, std::vector<double>({2, 4, 6}));
+
+    std::fill(column.begin(), column.end(), 0.0);
+    EXPECT_EQ(A(0, 1), 0);
+    EXPECT_EQ(A(2, 1), 0);
+    EXPECT_EQ(A(2, 0), 5);
+
+    const Matrix &B = A;
+    auto first = B.column(0).begin();
+    auto last = B.column(0).end();
+    EXPECT_EQ(last - first, 3);
+    EXPECT_EQ(first[1], 3);
+    EXPECT_EQ(*(last - 1), 5);
+    EXPECT_TRUE(first < last);
+}
+
 TEST(MatrixViewTest, TestConvertToMatrix)
 {
-    // TODO: Test convert_to_matrix() method
+    Matrix A(3, 4);
+    A.set_data({{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}});
+
+    Matrix block = A.view().convert_to_matrix(1, 3, 1, 4);
+
+    EXPECT_EQ(block.get_rows(), 2);
+    EXPECT_EQ(block.get_cols(), 3);
+    EXPECT_EQ(block(0, 0), 6);
+    EXPECT_EQ(block(1, 2), 12);
+
+    Matrix transposed_block = A.transpose_view().convert_to_matrix(2, 4, 0, 2);
+
+    EXPECT_EQ(transposed_block(0, 0), 3);
+    EXPECT_EQ(transposed_block(0, 1), 7);
+    EXPECT_EQ(transposed_block(1, 0), 4);
+    EXPECT_EQ(transposed_block(1, 1), 8);
+
+    EXPECT_THROW(A.view().convert_to_matrix(0, 4, 0, 1), std::out_of_range);
+}
+
+TEST(MatrixViewTest, TestTransposeAndSubViewShareData)
+{
+    Matrix A(3, 4);
+    A.set_data({{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}});
+
+    MatrixView transposed = A.view().transpose();
+
+    EXPECT_EQ(transposed.get_rows(), 4);
+    EXPECT_EQ(transposed.get_cols(), 3);
+    EXPECT_EQ(transposed.get_row_stride(), 1);
+    EXPECT_EQ(transposed.get_col_stride(), 4);
+    EXPECT_EQ(transposed.data(), A.view().data());
+
+    MatrixView block = transposed.sub_view(1, 1, 3, 2);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            EXPECT_EQ(block.get_element(i, j), A(j + 1, i + 1));
+        }
+    }
+
+    MatrixView back = block.transpose();
+    EXPECT_EQ(back.get_element(1, 2), A(2, 3));
+
+    EXPECT_THROW(transposed.sub_view(2, 0, 3, 1), std::out_of_range);
+}
+
+TEST(MatrixViewTest, TestPaddedViewReadsZerosOutsideData)
+{
+    Matrix A(2, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}});
+
+    MatrixView padded = A.view().padded(4, 4);
+
+    EXPECT_TRUE(padded.is_padded());
+    EXPECT_EQ(padded.get_data_rows(), 2);
+    EXPECT_EQ(padded.get_data_cols(), 3);
+    EXPECT_EQ(padded.get_element(1, 2), 6);
+    EXPECT_EQ(padded.get_element(1, 3), 0);
+    EXPECT_EQ(padded.get_element(3, 0), 0);
+    EXPECT_THROW(padded.get_element(4, 0), std::out_of_range);
+    EXPECT_THROW(A.view().padded(1, 3), std::invalid_argument);
+
+    // A block that lies entirely in the padding has no stored data.
+    MatrixView corner = padded.sub_view(2, 3, 2, 1);
+    EXPECT_EQ(corner.get_data_rows(), 0);
+    EXPECT_EQ(corner.get_element(1, 0), 0);
+
+    std::vector<double> dense(16, -1.0);
+    padded.transpose().copy_to(dense.data(), 4);
+    EXPECT_EQ(dense, std::vector<double>({1, 4, 0, 0, 2, 5, 0, 0, 3, 6, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST(MatrixTest, TestAlignedStorage)
+{
+    for (int cols : {1, 3, 8, 10, 512, 513})
+    {
+        Matrix A(3, cols);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(A.data()) % Matrix::ALIGNMENT, 0);
+        if (cols >= 8)
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(A.row(2).data()) % Matrix::ALIGNMENT, 0);
+        }
+    }
+}
+
+TEST(MatrixTest, TestUninitializedClearsPadding)
+{
+    Matrix A = Matrix::uninitialized(4, 10);
+    ASSERT_EQ(A.get_rows(), 4);
+    ASSERT_EQ(A.get_cols(), 10);
+    ASSERT_EQ(A.get_leading_dimension(), 16);
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 10; j < 16; j++)
+        {
+            EXPECT_EQ(A.data()[i * 16 + j], 0);
+        }
+    }
+}
+
+TEST(MatrixTest, TestDefaultLeadingDimension)
+{
+    EXPECT_EQ(Matrix::default_leading_dimension(3), 3);
+    EXPECT_EQ(Matrix::default_leading_dimension(8), 8);
+    EXPECT_EQ(Matrix::default_leading_dimension(10), 16);
+    EXPECT_EQ(Matrix::default_leading_dimension(500), 504);
+
+    // A row pitch of a whole number of pages would alias, so it gets one more cache line.
+    EXPECT_EQ(Matrix::default_leading_dimension(512), 520);
+    EXPECT_EQ(Matrix::default_leading_dimension(1020), 1032);
+
+    Matrix A(4, 10);
+    EXPECT_EQ(A.get_leading_dimension(), 16);
+    EXPECT_EQ(A.get_cols(), 10);
+}
+
+TEST(MatrixTest, TestExplicitLeadingDimension)
+{
+    EXPECT_THROW(Matrix(2, 3, 2), std::invalid_argument);
+
+    Matrix A(3, 2, 5);
+    A.set_data({{1, 2}, {3, 4}, {5, 6}});
+
+    EXPECT_EQ(A.get_leading_dimension(), 5);
+    EXPECT_EQ(A.data()[5], 3);
+    EXPECT_EQ(A.row(2).data(), A.data() + 10);
+    EXPECT_EQ(A.column(1).get_stride(), 5);
+    EXPECT_EQ(A.unchecked(2, 1), 6);
+
+    Matrix B(3, 2);
+    B.set_data({{10, 20}, {30, 40}, {50, 60}});
+
+    Matrix sum = A + B;
+    Matrix difference = B - A;
+    Matrix scaled = A * 2;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            EXPECT_EQ(sum(i, j), 11 * A(i, j));
+            EXPECT_EQ(difference(i, j), 9 * A(i, j));
+            EXPECT_EQ(scaled(i, j), 2 * A(i, j));
+        }
+    }
+
+    Matrix transposed = A.transpose_view().convert_to_matrix(0, 2, 0, 3);
+    EXPECT_EQ(transposed(1, 2), 6);
+    EXPECT_EQ(A.view().get_element(2, 0), 5);
+    EXPECT_EQ(A.view().get_row_stride(), 5);
+
+    MatrixView square = A.create_square_view();
+    EXPECT_EQ(square.get_element(1, 1), 4);
+    EXPECT_EQ(square.get_element(2, 3), 0);
+}
+
+TEST(MatrixTest, TestCompoundAssignment)
+{
+    Matrix A(2, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}});
+    Matrix B(2, 3);
+    B.set_data({{10, 20, 30}, {40, 50, 60}});
+
+    const double *storage = A.data();
+    A += B;
+    A -= B * 0.5;
+    A *= 2;
+
+    EXPECT_EQ(A.data(), storage);
+    EXPECT_EQ(A(0, 0), 12);
+    EXPECT_EQ(A(1, 2), 72);
+
+    Matrix C(3, 2);
+    EXPECT_THROW(A += C, InvalidMatrixFormat);
+}
+
+TEST(MatrixTest, TestTransposeInPlace)
+{
+    Matrix A(3, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    Matrix expected = A.transpose();
+
+    const double *storage = A.data();
+    A.transpose_in_place();
+
+    EXPECT_EQ(A.data(), storage);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            EXPECT_EQ(A(i, j), expected(i, j));
+        }
+    }
+    EXPECT_EQ(A(0, 2), 7);
+
+    Matrix B(2, 3);
+    EXPECT_THROW(B.transpose_in_place(), InvalidMatrixFormat);
+}
+
+TEST(MatrixTest, TestCopyOnWrite)
+{
+    Matrix A(3, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    const Matrix &const_A = A;
+
+    Matrix B = A;
+    const Matrix &const_B = B;
+    EXPECT_EQ(const_B.data(), const_A.data());
+
+    B(0, 0) = 10;
+    EXPECT_EQ(A(0, 0), 1);
+    EXPECT_EQ(B(0, 0), 10);
+    EXPECT_EQ(B(2, 2), 9);
+    EXPECT_NE(const_B.data(), const_A.data());
+
+    // Storage of its own is written in place.
+    const double *storage = const_B.data();
+    B.set_element(1, 1, 20);
+    B.unchecked(2, 1) = 30;
+    B.row(0)[1] = 40;
+    B.column(2)[0] = 50;
+    EXPECT_EQ(const_B.data(), storage);
+    EXPECT_EQ(A(1, 1), 5);
+    EXPECT_EQ(A(2, 1), 8);
+    EXPECT_EQ(A(0, 1), 2);
+    EXPECT_EQ(A(0, 2), 3);
+
+    Matrix C = std::move(B);
+    EXPECT_EQ(static_cast<const Matrix &>(C).data(), storage);
+}
+
+TEST(MatrixTest, TestCopyOnWriteKeepsViews)
+{
+    Matrix A(2, 2);
+    A.set_data({{1, 2}, {3, 4}});
+
+    MatrixView view = A.view();
+    A(0, 1) = 7;
+    EXPECT_EQ(view.get_element(0, 1), 2);
+
+    TransposedMatrixView transposed = A.transpose_view();
+    A.transpose_in_place();
+    EXPECT_EQ(transposed.get_element(1, 0), 7);
+    EXPECT_EQ(A(1, 0), 7);
+
+    // Assigning an expression to shared storage leaves the copy untouched.
+    Matrix copy = A;
+    A += A;
+    EXPECT_EQ(A(1, 0), 14);
+    EXPECT_EQ(copy(1, 0), 7);
+}
+
+TEST(MatrixViewTest, TestSplitKeepsLayout)
+{
+    Matrix A(4, 4);
+    A.set_data({{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16}});
+
+    std::array<MatrixView, 4> transposed_blocks = A.transpose_view().split();
+    EXPECT_EQ(transposed_blocks[1].get_element(0, 0), A(2, 0));
+    EXPECT_EQ(transposed_blocks[1].get_element(1, 0), A(2, 1));
+    EXPECT_EQ(transposed_blocks[2].get_element(0, 1), A(1, 2));
+
+    Matrix B(3, 3);
+    B.set_data({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+
+    std::array<MatrixView, 4> padded_blocks = B.create_square_view().split();
+    EXPECT_EQ(padded_blocks[3].get_element(0, 0), 9);
+    EXPECT_EQ(padded_blocks[3].get_element(0, 1), 0);
+    EXPECT_EQ(padded_blocks[3].get_element(1, 1), 0);
+    EXPECT_EQ(padded_blocks[1].get_element(1, 0), 6);
+}
+
+TEST(MatrixTest, TestFloatMatrix)
+{
+    // Sixteen floats fill a cache line and 1024 of them a page.
+    EXPECT_EQ(FloatMatrix::default_leading_dimension(10), 10);
+    EXPECT_EQ(FloatMatrix::default_leading_dimension(20), 32);
+    EXPECT_EQ(FloatMatrix::default_leading_dimension(1024), 1040);
+
+    FloatMatrix A(3, 20);
+    EXPECT_EQ(A.get_leading_dimension(), 32);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(A.row(1).data()) % FloatMatrix::ALIGNMENT, 0);
+    EXPECT_EQ(A(2, 19), 0.0f);
+
+    FloatMatrix B(2, 3);
+    B.set_data({{1.5f, 2, 3}, {4, 5, 6}});
+    EXPECT_EQ(B.get_element(0, 0), 1.5f);
+
+    FloatMatrix transposed = B.transpose();
+    FloatMatrixView view = B.transpose_view();
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            EXPECT_EQ(transposed(j, i), B(i, j));
+            EXPECT_EQ(view.get_element(j, i), B(i, j));
+        }
+    }
+
+    FloatMatrix copy = view.convert_to_matrix(1, 3, 0, 2);
+    EXPECT_EQ(copy(0, 1), 5);
+    EXPECT_EQ(copy(1, 0), 3);
 }
 
 int main(int argc, char **argv)
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixAllocator.hpp"
+
+#include <cstdint>
+#include <thread>
+
+TEST(MatrixAllocatorTest, RoundsUpToSizeClasses)
+{
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(0), 64);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(1), 64);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(9), 128);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(32), 256);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(33), 320);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(64), 512);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(65), 640);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(1000), 8192);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(1025), 10240);
+
+    // Beyond 1 GiB requests bypass the pool and keep their size.
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size(std::size_t(1) << 27), std::size_t(1) << 30);
+    EXPECT_EQ(PooledMatrixAllocator::rounded_size((std::size_t(1) << 27) + 1), (std::size_t(1) << 30) + 8);
+}
+
+TEST(MatrixAllocatorTest, ReusesFreedBuffers)
+{
+    PooledMatrixAllocator allocator;
+
+    double *first = allocator.allocate(100);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % MatrixAllocator::ALIGNMENT, 0);
+    allocator.deallocate(first, 100);
+    EXPECT_EQ(allocator.get_stats().bytes_held, PooledMatrixAllocator::rounded_size(100));
+
+    // Any request of the same size class gets the buffer back.
+    double *second = allocator.allocate(97);
+    EXPECT_EQ(second, first);
+    allocator.deallocate(second, 97);
+
+    double *other_class = allocator.allocate(1000);
+    EXPECT_NE(other_class, first);
+    allocator.deallocate(other_class, 1000);
+
+    MatrixAllocatorStats stats = allocator.get_stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.bytes_held, PooledMatrixAllocator::rounded_size(100) + PooledMatrixAllocator::rounded_size(1000));
+
+    allocator.release_cached();
+    EXPECT_EQ(allocator.get_stats().bytes_held, 0);
+}
+
+TEST(MatrixAllocatorTest, SharesBuffersBetweenThreads)
+{
+    PooledMatrixAllocator allocator(0);
+
+    // Without room in the thread cache the buffer goes to the shared free list.
+    double *buffer = allocator.allocate(500);
+    allocator.deallocate(buffer, 500);
+
+    double *taken = nullptr;
+    std::thread([&]
+                { taken = allocator.allocate(500); })
+        .join();
+    EXPECT_EQ(taken, buffer);
+    allocator.deallocate(taken, 500);
+
+    EXPECT_EQ(allocator.get_stats().hits, 1);
+}
+
+TEST(MatrixAllocatorTest, ThreadCacheIsReleasedOnExit)
+{
+    PooledMatrixAllocator allocator;
+
+    double *buffer = nullptr;
+    std::thread([&]
+                {
+        buffer = allocator.allocate(500);
+        allocator.deallocate(buffer, 500); })
+        .join();
+    EXPECT_EQ(allocator.get_stats().bytes_held, PooledMatrixAllocator::rounded_size(500));
+
+    double *taken = allocator.allocate(500);
+    EXPECT_EQ(taken, buffer);
+    allocator.deallocate(taken, 500);
+}
+
+TEST(MatrixAllocatorTest, FreesBeyondTheCacheLimits)
+{
+    PooledMatrixAllocator allocator(0, 0);
+
+    for (int iteration = 0; iteration < 3; iteration++)
+    {
+        double *buffer = allocator.allocate(64);
+        allocator.deallocate(buffer, 64);
+    }
+
+    MatrixAllocatorStats stats = allocator.get_stats();
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.misses, 3);
+    EXPECT_EQ(stats.bytes_held, 0);
+}
+
+TEST(MatrixAllocatorTest, MatricesUseTheDefaultAllocator)
+{
+    PooledMatrixAllocator pool;
+    MatrixAllocator::set_default(&pool);
+
+    const double *storage = nullptr;
+    {
+        Matrix A(40, 30);
+        A(3, 4) = 7;
+        storage = A.data();
+    }
+    {
+        // The recycled buffer is zeroed again.
+        Matrix B(40, 30);
+        EXPECT_EQ(B.data(), storage);
+        EXPECT_EQ(B(3, 4), 0);
+    }
+    EXPECT_EQ(pool.get_stats().hits, 1);
+    EXPECT_EQ(pool.get_stats().misses, 1);
+
+    HeapMatrixAllocator heap;
+    MatrixAllocator::set_default(&heap);
+    {
+        Matrix C(5, 5);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(C.data()) % Matrix::ALIGNMENT, 0);
+    }
+    EXPECT_EQ(heap.get_stats().misses, 1);
+
+    MatrixAllocator::set_default(nullptr);
+    EXPECT_EQ(&MatrixAllocator::get_default(), &MatrixAllocator::get_default());
+    EXPECT_NE(&MatrixAllocator::get_default(), &heap);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include "../include/MatrixBatch.hpp"
+#include "../include/Matrix.hpp"
+#include "../include/MatrixAllocator.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+TEST(MatrixBatchTest, MatricesAreZeroedAndCacheLineAligned)
+{
+    MatrixBatch batch(5, 3, 7);
+
+    ASSERT_EQ(batch.get_count(), 5);
+    ASSERT_EQ(batch.get_rows(), 3);
+    ASSERT_EQ(batch.get_cols(), 7);
+    EXPECT_EQ(batch.get_stride(), 24u);
+    EXPECT_EQ(FloatMatrixBatch(2, 3, 7).get_stride(), 32u);
+
+    for (int index = 0; index < 5; index++)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(batch.data(index)) % MatrixAllocator::ALIGNMENT, 0u);
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 7; j++)
+            {
+                EXPECT_EQ(batch(index, i, j), 0.0);
+            }
+        }
+    }
+}
+
+TEST(MatrixBatchTest, ElementsOfDifferentMatricesAreIndependent)
+{
+    MatrixBatch batch(3, 2, 2);
+    batch(0, 1, 1) = 4.0;
+    batch(2, 0, 1) = -1.5;
+
+    EXPECT_EQ(batch(0, 1, 1), 4.0);
+    EXPECT_EQ(batch(1, 1, 1), 0.0);
+    EXPECT_EQ(batch.data(2)[1], -1.5);
+    EXPECT_EQ(batch.get_matrix(2)(0, 1), -1.5);
+
+    EXPECT_THROW(batch(3, 0, 0), std::out_of_range);
+    EXPECT_THROW(batch(0, 2, 0), std::out_of_range);
+    EXPECT_THROW(batch.view(-1), std::out_of_range);
+}
+
+TEST(MatrixBatchTest, SetMatrixFromAnyView)
+{
+    Matrix M(3, 2);
+    M.set_data({{1, 2}, {3, 4}, {5, 6}});
+
+    MatrixBatch batch(2, 2, 3);
+    batch.set_matrix(1, M.transpose_view());
+
+    Matrix stored = batch.get_matrix(1);
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            EXPECT_EQ(stored(i, j), M(j, i));
+            EXPECT_EQ(batch.view(1).get_element(i, j), M(j, i));
+            EXPECT_EQ(batch(0, i, j), 0.0);
+        }
+    }
+
+    EXPECT_THROW(batch.set_matrix(0, M.view()), InvalidMatrixFormat);
+}
+
+TEST(MatrixBatchTest, CopiesAndViewsKeepTheirElements)
+{
+    FloatMatrixBatch batch(2, 2, 2);
+    batch(1, 0, 0) = 1.0f;
+
+    FloatMatrixBatch copy = batch;
+    FloatMatrixView view = batch.view(1);
+    batch(1, 0, 0) = 2.0f;
+
+    EXPECT_EQ(copy(1, 0, 0), 1.0f);
+    EXPECT_EQ(view.get_element(0, 0), 1.0f);
+    EXPECT_EQ(batch(1, 0, 0), 2.0f);
+}
+
+TEST(MatrixBatchTest, ThrowsOnNegativeSizes)
+{
+    EXPECT_THROW(MatrixBatch(-1, 2, 2), std::invalid_argument);
+    EXPECT_THROW(MatrixBatch(1, 2, -2), std::invalid_argument);
+    EXPECT_NO_THROW(MatrixBatch(0, 4, 4));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
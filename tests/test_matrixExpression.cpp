@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "../include/Matrix.hpp"
+#include "../include/MatrixExpression.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+#include "test_helpers.hpp"
+
+TEST(MatrixExpressionTest, FusesSeveralTerms)
+{
+    // Wider than one strip, so rows are evaluated in several pieces.
+    Matrix A = filled_matrix(7, 600, 1);
+    Matrix B = filled_matrix(7, 600, 2);
+    Matrix C = filled_matrix(7, 600, 3);
+
+    Matrix D = A + B - C * 0.5 + A * 2;
+    for (int i = 0; i < 7; i++)
+    {
+        for (int j = 0; j < 600; j++)
+        {
+            EXPECT_EQ(D(i, j), A(i, j) + B(i, j) - C(i, j) * 0.5 + A(i, j) * 2);
+        }
+    }
+
+    EXPECT_EQ((A - B)(3, 599), A(3, 599) - B(3, 599));
+}
+
+TEST(MatrixExpressionTest, ShapeMismatchThrowsWhenBuilt)
+{
+    Matrix A(2, 3);
+    Matrix B(3, 2);
+
+    EXPECT_THROW(A + B, InvalidMatrixFormat);
+    EXPECT_THROW(A - B * 2, InvalidMatrixFormat);
+}
+
+TEST(MatrixExpressionTest, ViewsAreOperands)
+{
+    Matrix A(2, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}});
+    Matrix B(3, 2);
+    B.set_data({{10, 20}, {30, 40}, {50, 60}});
+
+    // The transpose is gathered, the padding reads as zero.
+    Matrix sum = B + A.transpose_view();
+    EXPECT_EQ(sum(0, 1), 24);
+    EXPECT_EQ(sum(2, 0), 53);
+
+    Matrix padded = A.create_square_view() * 2 - A.view().padded(4, 4);
+    EXPECT_EQ(padded.get_rows(), 4);
+    EXPECT_EQ(padded(1, 2), 6);
+    EXPECT_EQ(padded(3, 3), 0);
+}
+
+TEST(MatrixExpressionTest, HonoursLeadingDimension)
+{
+    Matrix A(3, 2, 5);
+    A.set_data({{1, 2}, {3, 4}, {5, 6}});
+    Matrix B(3, 2);
+    B.set_data({{1, 1}, {1, 1}, {1, 1}});
+
+    Matrix C(3, 2, 7);
+    C = A * 3 + B;
+    EXPECT_EQ(C.get_leading_dimension(), 7);
+    EXPECT_EQ(C(2, 1), 19);
+    EXPECT_EQ(C(1, 0), 10);
+}
+
+TEST(MatrixExpressionTest, AssignmentReusesStorage)
+{
+    Matrix A = filled_matrix(20, 30, 4);
+    Matrix B = filled_matrix(20, 30, 5);
+    Matrix expected = A + B * 2;
+
+    const double *storage = A.data();
+    A = A + B * 2;
+
+    EXPECT_EQ(A.data(), storage);
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j < 30; j++)
+        {
+            EXPECT_EQ(A(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixExpressionTest, AssignmentThroughAliasingViewUsesNewStorage)
+{
+    Matrix A(3, 3);
+    A.set_data({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+
+    const double *storage = A.data();
+    A = A + A.transpose_view();
+
+    EXPECT_NE(A.data(), storage);
+    EXPECT_EQ(A(0, 1), 6);
+    EXPECT_EQ(A(1, 0), 6);
+    EXPECT_EQ(A(2, 2), 18);
+}
+
+TEST(MatrixExpressionTest, FloatOperands)
+{
+    FloatMatrix A(5, 300);
+    FloatMatrix B(300, 5);
+    for (int i = 0; i < 5; i++)
+    {
+        for (int j = 0; j < 300; j++)
+        {
+            A(i, j) = static_cast<float>((i * 31 + j * 17) % 13 - 6);
+            B(j, i) = static_cast<float>((i * 7 + j * 5) % 11 - 5);
+        }
+    }
+
+    FloatMatrix C = A * 0.5 - B.transpose_view() + A;
+    for (int i = 0; i < 5; i++)
+    {
+        for (int j = 0; j < 300; j++)
+        {
+            EXPECT_EQ(C(i, j), A(i, j) * 0.5f - B(j, i) + A(i, j));
+        }
+    }
+
+    static_assert(std::is_same<decltype((A + A)(0, 0)), float>::value, "Float expressions evaluate to float.");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
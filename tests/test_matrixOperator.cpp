@@ -3,9 +3,32 @@
 #include "../include/Matrix.hpp"
 #include "../include/MatrixOperator.hpp"
 #include "../include/InvalidMatrixFormat.hpp"
+#include "test_helpers.hpp"
 
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
+template <typename T>
+static BasicMatrix<T> reference_matmul(const BasicMatrix<T> &A, const BasicMatrix<T> &B)
+{
+    BasicMatrix<T> C(A.get_rows(), B.get_cols());
+    for (int i = 0; i < A.get_rows(); i++)
+    {
+        for (int j = 0; j < B.get_cols(); j++)
+        {
+            T value = 0;
+            for (int k = 0; k < A.get_cols(); k++)
+            {
+                value += A(i, k) * B(k, j);
+            }
+            C(i, j) = value;
+        }
+    }
+    return C;
+}
+
 TEST(MatrixOperatorTest, AdditionPositiveNumbers)
 {
     MatrixOperator matrixOperator;
@@ -180,6 +203,1209 @@ TEST(MatrixOperatorTest, MatrixMultiplicationSquareMatrices)
     }
 }
 
+TEST(MatrixOperatorTest, MatrixMultiplicationRectangularMatrices)
+{
+    MatrixOperator mat_operator;
+
+    Matrix A = filled_matrix(37, 53, 1);
+    Matrix B = filled_matrix(53, 29, 2);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    ASSERT_EQ(C.get_rows(), 37);
+    ASSERT_EQ(C.get_cols(), 29);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, MatrixMultiplicationAboveStrassenThreshold)
+{
+    MatrixOperator mat_operator;
+
+    Matrix A = filled_matrix(300, 270, 3);
+    Matrix B = filled_matrix(270, 280, 4);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    ASSERT_EQ(C.get_rows(), 300);
+    ASSERT_EQ(C.get_cols(), 280);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, ThrowsFormatExceptionMatmul)
+{
+    MatrixOperator mat_operator;
+
+    Matrix A(2, 3);
+    Matrix B(2, 3);
+
+    EXPECT_THROW(mat_operator.matmul(A, B), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, MatrixMultiplicationOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator mat_operator(thread_pool);
+    mat_operator.set_parallel_threshold(0);
+
+    EXPECT_EQ(mat_operator.get_thread_count(), 4);
+
+    Matrix A = filled_matrix(131, 77, 5);
+    Matrix B = filled_matrix(77, 95, 6);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, OwnedThreadPoolAboveStrassenThreshold)
+{
+    MatrixOperator mat_operator(static_cast<size_t>(3));
+
+    EXPECT_EQ(mat_operator.get_thread_count(), 3);
+
+    Matrix A = filled_matrix(260, 300, 7);
+    Matrix B = filled_matrix(300, 270, 8);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, ParallelStrassenBelowParallelDepth)
+{
+    ThreadPool thread_pool(2);
+    MatrixOperator mat_operator(thread_pool);
+    mat_operator.set_strassen_parallel_depth(3);
+
+    EXPECT_EQ(mat_operator.get_strassen_parallel_depth(), 3);
+    EXPECT_THROW(mat_operator.set_strassen_parallel_depth(-1), std::invalid_argument);
+
+    Matrix A = filled_matrix(300, 300, 9);
+    Matrix B = filled_matrix(300, 300, 10);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, DeepStrassenRecursionWithSmallThresholds)
+{
+    MatrixOperator mat_operator;
+
+    StrassenThresholds thresholds;
+    thresholds.square = 4;
+    thresholds.rectangular = 4;
+    mat_operator.set_strassen_thresholds(thresholds);
+
+    EXPECT_EQ(mat_operator.get_strassen_thresholds().square, 4);
+
+    Matrix A = filled_matrix(45, 23, 11);
+    Matrix B = filled_matrix(23, 61, 12);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+
+    thresholds.square = -1;
+    EXPECT_THROW(mat_operator.set_strassen_thresholds(thresholds), std::invalid_argument);
+}
+
+TEST(MatrixOperatorTest, WorkspaceIsReusedAcrossMatmulCalls)
+{
+    MatrixOperator mat_operator;
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    mat_operator.set_strassen_thresholds(thresholds);
+
+    StrassenWorkspace workspace;
+
+    Matrix A = filled_matrix(60, 50, 13);
+    Matrix B = filled_matrix(50, 40, 14);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int call = 0; call < 3; call++)
+    {
+        Matrix C = mat_operator.matmul(A, B, workspace);
+
+        for (int i = 0; i < C.get_rows(); i++)
+        {
+            for (int j = 0; j < C.get_cols(); j++)
+            {
+                EXPECT_EQ(C(i, j), expected(i, j));
+            }
+        }
+    }
+
+    EXPECT_EQ(workspace.get_allocation_count(), 1);
+    EXPECT_EQ(workspace.capacity(), StrassenWorkspace::required_size(60, 50, 40, 8, 0));
+}
+
+TEST(MatrixOperatorTest, ParallelStrassenWithSmallThresholds)
+{
+    ThreadPool thread_pool(3);
+    MatrixOperator mat_operator(thread_pool);
+    mat_operator.set_strassen_parallel_depth(2);
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    thresholds.rectangular = 8;
+    mat_operator.set_strassen_thresholds(thresholds);
+
+    Matrix A = filled_matrix(70, 90, 15);
+    Matrix B = filled_matrix(90, 65, 16);
+
+    Matrix C = mat_operator.matmul(A, B);
+    Matrix expected = reference_matmul(A, B);
+
+    for (int i = 0; i < C.get_rows(); i++)
+    {
+        for (int j = 0; j < C.get_cols(); j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, StrassenWorkspaceHoldsOnlyRecursionTemporaries)
+{
+    ThreadPool thread_pool(2);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_strassen_parallel_depth(1);
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    serial_operator.set_strassen_thresholds(thresholds);
+    parallel_operator.set_strassen_thresholds(thresholds);
+
+    Matrix A = filled_matrix(64, 64, 17);
+    Matrix B = filled_matrix(64, 64, 18);
+    Matrix expected = reference_matmul(A, B);
+
+    StrassenWorkspace serial_workspace;
+    StrassenWorkspace parallel_workspace;
+    Matrix serial = serial_operator.matmul(A, B, serial_workspace);
+    Matrix parallel = parallel_operator.matmul(A, B, parallel_workspace);
+
+    for (int i = 0; i < 64; i++)
+    {
+        for (int j = 0; j < 64; j++)
+        {
+            EXPECT_EQ(serial(i, j), expected(i, j));
+            EXPECT_EQ(parallel(i, j), expected(i, j));
+        }
+    }
+
+    EXPECT_EQ(serial_workspace.capacity(), StrassenWorkspace::required_size(64, 64, 64, 8, 0));
+    EXPECT_EQ(parallel_workspace.capacity(), StrassenWorkspace::required_size(64, 64, 64, 8, 1));
+}
+
+TEST(MatrixOperatorTest, StrassenPeelsOddDimensions)
+{
+    ThreadPool thread_pool(2);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_strassen_parallel_depth(1);
+
+    StrassenThresholds thresholds;
+    thresholds.square = 4;
+    thresholds.rectangular = 4;
+    serial_operator.set_strassen_thresholds(thresholds);
+    parallel_operator.set_strassen_thresholds(thresholds);
+
+    const int shapes[][3] = {{33, 33, 33}, {65, 17, 40}, {31, 67, 23}, {9, 10, 11}, {48, 47, 49}};
+    for (const auto &shape : shapes)
+    {
+        Matrix A = filled_matrix(shape[0], shape[1], 19);
+        Matrix B = filled_matrix(shape[1], shape[2], 20);
+        Matrix expected = reference_matmul(A, B);
+
+        Matrix serial = serial_operator.matmul(A, B);
+        Matrix parallel = parallel_operator.matmul(A, B);
+
+        for (int i = 0; i < expected.get_rows(); i++)
+        {
+            for (int j = 0; j < expected.get_cols(); j++)
+            {
+                EXPECT_EQ(serial(i, j), expected(i, j));
+                EXPECT_EQ(parallel(i, j), expected(i, j));
+            }
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, ElementwiseOperationsOnThreadPool)
+{
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(3);
+
+    // Large enough to be split into several chunks.
+    Matrix A = filled_matrix(301, 299, 21);
+    Matrix B = filled_matrix(301, 299, 22);
+
+    Matrix serial_sum = serial_operator.add(A, B);
+    Matrix parallel_sum = parallel_operator.add(A, B);
+    for (int i = 0; i < A.get_rows(); i++)
+    {
+        for (int j = 0; j < A.get_cols(); j++)
+        {
+            EXPECT_EQ(parallel_sum(i, j), serial_sum(i, j));
+        }
+    }
+
+    // Integer valued entries, so the sum is exact in any order.
+    EXPECT_EQ(parallel_operator.hadamard_product(A, B), serial_operator.hadamard_product(A, B));
+
+    std::shared_ptr<double[]> a_data(new double[A.get_rows() * A.get_cols()]);
+    std::shared_ptr<double[]> b_data(new double[B.get_rows() * B.get_cols()]);
+    for (int i = 0; i < A.get_rows(); i++)
+    {
+        for (int j = 0; j < A.get_cols(); j++)
+        {
+            a_data[i * A.get_cols() + j] = A(i, j);
+            b_data[i * B.get_cols() + j] = B(i, j);
+        }
+    }
+
+    MatrixView top(a_data, A.get_rows(), A.get_cols(), 0, 0);
+    MatrixView bottom(b_data, B.get_rows(), B.get_cols(), 0, 0);
+    MatrixView merged = parallel_operator.merge_top_bottom(top, bottom);
+    MatrixView side_by_side = parallel_operator.merge_side_to_side(top, bottom);
+    for (int i = 0; i < A.get_rows(); i++)
+    {
+        for (int j = 0; j < A.get_cols(); j++)
+        {
+            EXPECT_EQ(merged.get_element(i, j), A(i, j));
+            EXPECT_EQ(merged.get_element(i + A.get_rows(), j), B(i, j));
+            EXPECT_EQ(side_by_side.get_element(i, j), A(i, j));
+            EXPECT_EQ(side_by_side.get_element(i, j + A.get_cols()), B(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, KernelsHonourLeadingDimension)
+{
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(3);
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    thresholds.rectangular = 8;
+    serial_operator.set_strassen_thresholds(thresholds);
+
+    // Operands with an odd row pitch that differs from the default one of the results.
+    Matrix dense_a = filled_matrix(45, 37, 23);
+    Matrix dense_b = filled_matrix(37, 45, 24);
+    Matrix A(45, 37, 41);
+    Matrix B(37, 45, 53);
+    for (int i = 0; i < 45; i++)
+    {
+        for (int j = 0; j < 37; j++)
+        {
+            A(i, j) = dense_a(i, j);
+            B(j, i) = dense_b(j, i);
+        }
+    }
+
+    Matrix expected = reference_matmul(dense_a, dense_b);
+    for (const MatrixOperator *matrix_operator : {&serial_operator, &parallel_operator})
+    {
+        Matrix product = matrix_operator->matmul(A, B);
+        for (int i = 0; i < 45; i++)
+        {
+            for (int j = 0; j < 45; j++)
+            {
+                EXPECT_EQ(product(i, j), expected(i, j));
+            }
+        }
+
+        Matrix sum = matrix_operator->add(A, dense_a);
+        for (int i = 0; i < 45; i++)
+        {
+            for (int j = 0; j < 37; j++)
+            {
+                EXPECT_EQ(sum(i, j), 2 * dense_a(i, j));
+            }
+        }
+
+        EXPECT_EQ(matrix_operator->hadamard_product(A, dense_a), serial_operator.hadamard_product(dense_a, dense_a));
+    }
+}
+
+TEST(MatrixOperatorTest, GemmAccumulatesIntoOutput)
+{
+    ThreadPool thread_pool(2);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    thresholds.rectangular = 8;
+    serial_operator.set_strassen_thresholds(thresholds);
+    parallel_operator.set_strassen_thresholds(thresholds);
+
+    // Below and above the Strassen threshold.
+    const int shapes[][3] = {{5, 7, 3}, {33, 40, 29}};
+    for (const auto &shape : shapes)
+    {
+        Matrix A = filled_matrix(shape[0], shape[1], 25);
+        Matrix B = filled_matrix(shape[1], shape[2], 26);
+        Matrix C0 = filled_matrix(shape[0], shape[2], 27);
+        Matrix product = reference_matmul(A, B);
+
+        for (const MatrixOperator *matrix_operator : {&serial_operator, &parallel_operator})
+        {
+            for (double beta : {0.0, 1.0, -0.5})
+            {
+                Matrix C = C0 * 1;
+                matrix_operator->gemm(2.0, A, B, beta, C);
+
+                for (int i = 0; i < C.get_rows(); i++)
+                {
+                    for (int j = 0; j < C.get_cols(); j++)
+                    {
+                        EXPECT_EQ(C(i, j), 2.0 * product(i, j) + beta * C0(i, j));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, GemmWithZeroBetaIgnoresOutput)
+{
+    MatrixOperator matrix_operator;
+
+    Matrix A = filled_matrix(4, 3, 28);
+    Matrix B = filled_matrix(3, 5, 29);
+    Matrix C(4, 5);
+    C(1, 1) = std::numeric_limits<double>::quiet_NaN();
+
+    matrix_operator.gemm(1.0, A, B, 0.0, C);
+
+    Matrix expected = reference_matmul(A, B);
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, GemmSteadyStateDoesNotAllocate)
+{
+    MatrixOperator matrix_operator;
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    thresholds.rectangular = 8;
+    matrix_operator.set_strassen_thresholds(thresholds);
+
+    Matrix A = filled_matrix(48, 48, 30);
+    Matrix B = filled_matrix(48, 48, 31);
+    Matrix C(48, 48);
+    const double *storage = C.data();
+
+    StrassenWorkspace workspace;
+    for (int iteration = 0; iteration < 3; iteration++)
+    {
+        matrix_operator.gemm(1.0, A, B, 1.0, C, workspace);
+    }
+
+    EXPECT_EQ(C.data(), storage);
+    EXPECT_EQ(workspace.get_allocation_count(), 1);
+
+    Matrix product = reference_matmul(A, B);
+    EXPECT_EQ(C(17, 23), 3 * product(17, 23));
+}
+
+TEST(MatrixOperatorTest, GemmValidatesOperands)
+{
+    MatrixOperator matrix_operator;
+
+    Matrix A(2, 3);
+    Matrix B(3, 4);
+    Matrix C(2, 3);
+    Matrix square(3, 3);
+
+    EXPECT_THROW(matrix_operator.gemm(1.0, A, B, 0.0, C), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, GemmIntoItsOwnOperand)
+{
+    MatrixOperator matrix_operator;
+
+    Matrix square = filled_matrix(30, 30, 48);
+    Matrix original = square;
+    Matrix expected = reference_matmul(square, square);
+
+    matrix_operator.gemm(1.0, square, square, 1.0, square);
+    matrix_operator.gemm(1.0, original.transpose_view(), original.transpose_view(), 1.0, original);
+
+    Matrix copy = filled_matrix(30, 30, 48);
+    Matrix transposed_product = reference_matmul(copy.transpose(), copy.transpose());
+    for (int i = 0; i < 30; i++)
+    {
+        for (int j = 0; j < 30; j++)
+        {
+            EXPECT_EQ(square(i, j), expected(i, j) + copy(i, j));
+            EXPECT_EQ(original(i, j), transposed_product(i, j) + copy(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, TransposeOnThreadPool)
+{
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(3);
+
+    // Large enough to be split over the pool.
+    Matrix A = filled_matrix(301, 299, 32);
+    Matrix serial = serial_operator.transpose(A);
+    Matrix parallel = parallel_operator.transpose(A);
+
+    Matrix square = filled_matrix(260, 260, 33);
+    Matrix square_transposed = square.transpose();
+    parallel_operator.transpose_in_place(square);
+
+    for (int i = 0; i < A.get_cols(); i++)
+    {
+        for (int j = 0; j < A.get_rows(); j++)
+        {
+            EXPECT_EQ(serial(i, j), A(j, i));
+            EXPECT_EQ(parallel(i, j), A(j, i));
+        }
+    }
+    for (int i = 0; i < 260; i++)
+    {
+        for (int j = 0; j < 260; j++)
+        {
+            EXPECT_EQ(square(i, j), square_transposed(i, j));
+        }
+    }
+
+    EXPECT_THROW(parallel_operator.transpose_in_place(A), InvalidMatrixFormat);
+}
+
+template <typename T>
+static BasicMatrix<T> transposed_copy(const BasicMatrix<T> &M)
+{
+    BasicMatrix<T> transposed(M.get_cols(), M.get_rows());
+    for (int i = 0; i < M.get_rows(); i++)
+    {
+        for (int j = 0; j < M.get_cols(); j++)
+        {
+            transposed(j, i) = M(i, j);
+        }
+    }
+    return transposed;
+}
+
+template <typename T = double>
+static void expect_transposed_products(const MatrixOperator &matrix_operator, int m, int k, int n)
+{
+    BasicMatrix<T> A = filled_matrix<T>(m, k, 40);
+    BasicMatrix<T> B = filled_matrix<T>(k, n, 41);
+    BasicMatrix<T> A_t = transposed_copy(A);
+    BasicMatrix<T> B_t = transposed_copy(B);
+    BasicMatrix<T> expected = reference_matmul(A, B);
+
+    std::vector<BasicMatrix<T>> products;
+    products.push_back(matrix_operator.matmul(A.view(), B.view()));
+    products.push_back(matrix_operator.matmul(A.view(), B_t.transpose_view()));
+    products.push_back(matrix_operator.matmul(A_t.transpose_view(), B.view()));
+    products.push_back(matrix_operator.matmul(A_t.transpose_view(), B_t.transpose_view()));
+
+    for (const BasicMatrix<T> &C : products)
+    {
+        ASSERT_EQ(C.get_rows(), m);
+        ASSERT_EQ(C.get_cols(), n);
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                EXPECT_EQ(C(i, j), expected(i, j));
+            }
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, MatmulOfTransposedViews)
+{
+    MatrixOperator matrix_operator;
+    expect_transposed_products(matrix_operator, 37, 53, 29);
+    expect_transposed_products(matrix_operator, 300, 270, 280);
+
+    ThreadPool thread_pool(4);
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_parallel_threshold(0);
+    expect_transposed_products(parallel_operator, 131, 77, 95);
+    expect_transposed_products(parallel_operator, 260, 300, 270);
+}
+
+TEST(MatrixOperatorTest, MatmulOfSubAndPaddedViews)
+{
+    MatrixOperator matrix_operator;
+
+    StrassenThresholds thresholds;
+    thresholds.square = 8;
+    thresholds.rectangular = 8;
+    matrix_operator.set_strassen_thresholds(thresholds);
+
+    Matrix A = filled_matrix(40, 50, 42);
+    Matrix B = filled_matrix(30, 45, 43);
+
+    MatrixView a = A.view().sub_view(3, 5, 20, 30);
+    MatrixView b = B.view().padded(30, 64).transpose().sub_view(7, 0, 40, 30);
+    Matrix dense_a = a.convert_to_matrix(0, 20, 0, 30);
+    Matrix dense_b = b.transpose().convert_to_matrix(0, 30, 0, 40);
+    Matrix expected = reference_matmul(dense_a, dense_b);
+
+    Matrix C = matrix_operator.matmul(a, b.transpose());
+    ASSERT_EQ(C.get_rows(), 20);
+    ASSERT_EQ(C.get_cols(), 40);
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j < 40; j++)
+        {
+            EXPECT_EQ(C(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(MatrixOperatorTest, GemmWithTransposedOperand)
+{
+    MatrixOperator matrix_operator;
+
+    Matrix A = filled_matrix(45, 33, 44);
+    Matrix B = filled_matrix(45, 27, 45);
+    Matrix C = filled_matrix(33, 27, 46);
+    Matrix initial = filled_matrix(33, 27, 46);
+
+    matrix_operator.gemm(2.0, A.transpose_view(), B.view(), -1.0, C);
+
+    Matrix product = reference_matmul(transposed_copy(A), B);
+    for (int i = 0; i < 33; i++)
+    {
+        for (int j = 0; j < 27; j++)
+        {
+            EXPECT_EQ(C(i, j), 2 * product(i, j) - initial(i, j));
+        }
+    }
+
+    EXPECT_THROW(matrix_operator.gemm(1.0, A.view(), B.view(), 0.0, C), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, FloatMatmulOfTransposedViews)
+{
+    // Small integer elements keep every float product exact, also through Strassen's sums.
+    MatrixOperator matrix_operator;
+    expect_transposed_products<float>(matrix_operator, 37, 53, 29);
+    expect_transposed_products<float>(matrix_operator, 300, 270, 280);
+
+    ThreadPool thread_pool(4);
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_parallel_threshold(0);
+    expect_transposed_products<float>(parallel_operator, 260, 300, 270);
+}
+
+TEST(MatrixOperatorTest, FloatGemmAndElementwiseOperations)
+{
+    MatrixOperator matrix_operator;
+
+    StrassenThresholds thresholds;
+    thresholds.square = 16;
+    thresholds.rectangular = 16;
+    matrix_operator.set_strassen_thresholds(thresholds);
+
+    FloatMatrix A = filled_matrix<float>(67, 45, 47);
+    FloatMatrix B = filled_matrix<float>(45, 51, 48);
+    FloatMatrix C = filled_matrix<float>(67, 51, 49);
+    FloatMatrix initial = filled_matrix<float>(67, 51, 49);
+
+    matrix_operator.gemm(2.0, A, B, -1.0, C);
+
+    FloatMatrix product = reference_matmul(A, B);
+    for (int i = 0; i < 67; i++)
+    {
+        for (int j = 0; j < 51; j++)
+        {
+            EXPECT_EQ(C(i, j), 2 * product(i, j) - initial(i, j));
+        }
+    }
+
+    FloatMatrix sum = matrix_operator.add(C, initial);
+    FloatMatrix transposed = matrix_operator.transpose(A);
+    float expected_hadamard = 0;
+    for (int i = 0; i < 67; i++)
+    {
+        for (int j = 0; j < 51; j++)
+        {
+            EXPECT_EQ(sum(i, j), C(i, j) + initial(i, j));
+            expected_hadamard += C(i, j) * initial(i, j);
+        }
+        for (int j = 0; j < 45; j++)
+        {
+            EXPECT_EQ(transposed(j, i), A(i, j));
+        }
+    }
+    EXPECT_EQ(matrix_operator.hadamard_product(C, initial), expected_hadamard);
+}
+
+TEST(MatrixOperatorTest, MatmulMixedAccumulatesInDouble)
+{
+    MatrixOperator matrix_operator;
+
+    FloatMatrix A = filled_matrix<float>(37, 300, 50);
+    FloatMatrix B = filled_matrix<float>(300, 29, 51);
+    for (int i = 0; i < 37; i++)
+    {
+        for (int p = 0; p < 300; p++)
+        {
+            A(i, p) *= 0.1f;
+        }
+    }
+
+    Matrix C = matrix_operator.matmul_mixed(A, B);
+    Matrix CT = matrix_operator.matmul_mixed(A.view(), transposed_copy(B).transpose_view());
+    ASSERT_EQ(C.get_rows(), 37);
+    ASSERT_EQ(C.get_cols(), 29);
+    for (int i = 0; i < 37; i++)
+    {
+        for (int j = 0; j < 29; j++)
+        {
+            double expected = 0;
+            for (int p = 0; p < 300; p++)
+            {
+                expected += static_cast<double>(A(i, p)) * B(p, j);
+            }
+            EXPECT_NEAR(C(i, j), expected, 1e-11);
+            EXPECT_EQ(CT(i, j), C(i, j));
+        }
+    }
+
+    EXPECT_THROW(matrix_operator.matmul_mixed(A, A), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, GemmMixedWithPaddedOperandOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator matrix_operator(thread_pool);
+    matrix_operator.set_parallel_threshold(0);
+
+    FloatMatrix A = filled_matrix<float>(67, 45, 52);
+    FloatMatrix B = filled_matrix<float>(40, 51, 53);
+    Matrix C = filled_matrix(67, 51, 54);
+    Matrix initial = filled_matrix(67, 51, 54);
+
+    // The last five rows of the padded B read as zero.
+    matrix_operator.gemm_mixed(2.0, A.view(), B.view().padded(45, 51), -1.0, C);
+
+    for (int i = 0; i < 67; i++)
+    {
+        for (int j = 0; j < 51; j++)
+        {
+            double product = 0;
+            for (int p = 0; p < 40; p++)
+            {
+                product += A(i, p) * B(p, j);
+            }
+            EXPECT_EQ(C(i, j), 2 * product - initial(i, j));
+        }
+    }
+
+    EXPECT_THROW(matrix_operator.gemm_mixed(1.0, A.view(), B.view(), 0.0, C), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, MatmulQuantizedAppliesRowAndColumnScales)
+{
+    int m = 19, k = 45, n = 23;
+    std::vector<std::int8_t> a_values(m * k), b_values(k * n);
+    for (int i = 0; i < m * k; i++)
+    {
+        a_values[i] = static_cast<std::int8_t>((i * 37) % 255 - 127);
+    }
+    for (int i = 0; i < k * n; i++)
+    {
+        b_values[i] = static_cast<std::int8_t>((i * 53) % 255 - 127);
+    }
+    std::vector<float> a_scales(m), b_scales(n);
+    for (int i = 0; i < m; i++)
+    {
+        a_scales[i] = 0.25f * static_cast<float>(1 + i % 3);
+    }
+    for (int j = 0; j < n; j++)
+    {
+        b_scales[j] = 0.5f * static_cast<float>(1 + j % 2);
+    }
+    QuantizedMatrix A(m, k, a_values, a_scales, QuantizationAxis::PerRow);
+    QuantizedMatrix B(k, n, b_values, b_scales, QuantizationAxis::PerColumn);
+
+    ThreadPool thread_pool(4);
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_parallel_threshold(0);
+
+    FloatMatrix C = MatrixOperator().matmul_quantized(A, B);
+    FloatMatrix parallel_C = parallel_operator.matmul_quantized(A, B);
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            std::int32_t sum = 0;
+            for (int p = 0; p < k; p++)
+            {
+                sum += a_values[i * k + p] * b_values[p * n + j];
+            }
+            EXPECT_EQ(C(i, j), a_scales[i] * b_scales[j] * static_cast<float>(sum));
+            EXPECT_EQ(parallel_C(i, j), C(i, j));
+        }
+    }
+
+    EXPECT_THROW(MatrixOperator().matmul_quantized(B, A), std::invalid_argument);
+    QuantizedMatrix wrong_shape(m, n, std::vector<std::int8_t>(m * n), b_scales, QuantizationAxis::PerColumn);
+    EXPECT_THROW(MatrixOperator().matmul_quantized(A, wrong_shape), InvalidMatrixFormat);
+}
+
+/**
+ * Rounding moves every value by at most half its scale, so each product term is off by at most
+ * max|a| * max|b| / 127 when both operands are at most 6 in magnitude.
+ */
+TEST(MatrixOperatorTest, MatmulQuantizedApproximatesFloatProduct)
+{
+    MatrixOperator matrix_operator;
+
+    FloatMatrix A = filled_matrix<float>(33, 71, 55);
+    FloatMatrix B = filled_matrix<float>(71, 42, 56);
+    FloatMatrix exact = matrix_operator.matmul(A, B);
+
+    QuantizedMatrix qa = QuantizedMatrix::quantize(A.view(), QuantizationAxis::PerRow);
+    QuantizedMatrix qb = QuantizedMatrix::quantize(B.view(), QuantizationAxis::PerColumn);
+    FloatMatrix C = matrix_operator.matmul_quantized(qa, qb);
+
+    float bound = 71 * 6.0f * 6.0f / 127;
+    for (int i = 0; i < 33; i++)
+    {
+        for (int j = 0; j < 42; j++)
+        {
+            EXPECT_NEAR(C(i, j), exact(i, j), bound);
+        }
+    }
+}
+
+template <typename T>
+static BasicMatrixBatch<T> filled_batch(int count, int rows, int cols, int seed)
+{
+    BasicMatrixBatch<T> batch(count, rows, cols);
+    for (int index = 0; index < count; index++)
+    {
+        batch.set_matrix(index, filled_matrix<T>(rows, cols, seed + index).view());
+    }
+    return batch;
+}
+
+TEST(MatrixOperatorTest, MatmulBatchedMatchesMatmul)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+    parallel_operator.set_parallel_threshold(0);
+
+    MatrixBatch A = filled_batch<double>(150, 16, 24, 60);
+    MatrixBatch B = filled_batch<double>(150, 24, 20, 61);
+    FloatMatrixBatch FA = filled_batch<float>(9, 37, 33, 62);
+    FloatMatrixBatch FB = filled_batch<float>(9, 33, 41, 63);
+
+    for (const MatrixOperator *op : {&serial_operator, &parallel_operator})
+    {
+        MatrixBatch C = op->matmul_batched(A, B);
+        ASSERT_EQ(C.get_count(), 150);
+        for (int index = 0; index < 150; index++)
+        {
+            Matrix expected = reference_matmul(A.get_matrix(index), B.get_matrix(index));
+            for (int i = 0; i < 16; i++)
+            {
+                for (int j = 0; j < 20; j++)
+                {
+                    EXPECT_EQ(C(index, i, j), expected(i, j));
+                }
+            }
+        }
+
+        FloatMatrixBatch FC = op->matmul_batched(FA, FB);
+        for (int index = 0; index < 9; index++)
+        {
+            FloatMatrix expected = reference_matmul(FA.get_matrix(index), FB.get_matrix(index));
+            for (int i = 0; i < 37; i++)
+            {
+                for (int j = 0; j < 41; j++)
+                {
+                    EXPECT_EQ(FC(index, i, j), expected(i, j));
+                }
+            }
+        }
+    }
+
+    EXPECT_THROW(parallel_operator.matmul_batched(A, A), InvalidMatrixFormat);
+    EXPECT_THROW(parallel_operator.matmul_batched(A, filled_batch<double>(149, 24, 20, 61)), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, GemmBatchedAccumulatesAndAllowsAliasing)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator matrix_operator(thread_pool);
+    matrix_operator.set_parallel_threshold(0);
+
+    MatrixBatch A = filled_batch<double>(40, 12, 12, 64);
+    MatrixBatch B = filled_batch<double>(40, 12, 12, 65);
+    MatrixBatch C = filled_batch<double>(40, 12, 12, 66);
+    MatrixBatch initial = C;
+
+    matrix_operator.gemm_batched(2.0, A, B, -1.0, C);
+    for (int index = 0; index < 40; index++)
+    {
+        Matrix product = reference_matmul(A.get_matrix(index), B.get_matrix(index));
+        for (int i = 0; i < 12; i++)
+        {
+            for (int j = 0; j < 12; j++)
+            {
+                EXPECT_EQ(C(index, i, j), 2 * product(i, j) - initial(index, i, j));
+            }
+        }
+    }
+
+    // A squared into A itself, the operand keeps the elements it had before the call.
+    MatrixBatch original = A;
+    matrix_operator.gemm_batched(1.0, A, A, 0.0, A);
+    for (int index = 0; index < 40; index++)
+    {
+        Matrix squared = reference_matmul(original.get_matrix(index), original.get_matrix(index));
+        for (int i = 0; i < 12; i++)
+        {
+            for (int j = 0; j < 12; j++)
+            {
+                EXPECT_EQ(A(index, i, j), squared(i, j));
+            }
+        }
+    }
+
+    MatrixBatch wrong_shape(40, 12, 13);
+    EXPECT_THROW(matrix_operator.gemm_batched(1.0, A, B, 0.0, wrong_shape), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, MatmulBatchedViewsOfDifferentShapes)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator matrix_operator(thread_pool);
+    matrix_operator.set_parallel_threshold(0);
+
+    Matrix A = filled_matrix(30, 20, 67);
+    Matrix B = filled_matrix(30, 25, 68);
+    Matrix C = filled_matrix(9, 14, 69);
+
+    std::vector<MatrixView> lhs = {A.view(), A.transpose_view(), C.view().padded(9, 16)};
+    std::vector<MatrixView> rhs = {A.transpose_view(), B.view(), B.view().sub_view(0, 0, 16, 5)};
+    std::vector<Matrix> results = matrix_operator.matmul_batched(lhs, rhs);
+
+    ASSERT_EQ(results.size(), 3u);
+    std::vector<Matrix> expected = {
+        reference_matmul(A, transposed_copy(A)),
+        reference_matmul(transposed_copy(A), B),
+        reference_matmul(C.view().padded(9, 16).convert_to_matrix(0, 9, 0, 16), B.view().sub_view(0, 0, 16, 5).convert_to_matrix(0, 16, 0, 5)),
+    };
+    for (std::size_t index = 0; index < 3; index++)
+    {
+        ASSERT_EQ(results[index].get_rows(), expected[index].get_rows());
+        ASSERT_EQ(results[index].get_cols(), expected[index].get_cols());
+        for (int i = 0; i < expected[index].get_rows(); i++)
+        {
+            for (int j = 0; j < expected[index].get_cols(); j++)
+            {
+                EXPECT_EQ(results[index](i, j), expected[index](i, j));
+            }
+        }
+    }
+
+    rhs.pop_back();
+    EXPECT_THROW(matrix_operator.matmul_batched(lhs, rhs), InvalidMatrixFormat);
+    rhs.push_back(B.view());
+    EXPECT_THROW(matrix_operator.matmul_batched(lhs, rhs), InvalidMatrixFormat);
+}
+
+template <typename T = double>
+static BasicVector<T> filled_vector(int size, int seed)
+{
+    return BasicVector<T>(filled_buffer<T>(size, seed));
+}
+
+template <typename T>
+static BasicVector<T> reference_gemv(const BasicMatrixView<T> &A, const BasicVector<T> &x)
+{
+    BasicVector<T> y(A.get_rows());
+    for (int i = 0; i < A.get_rows(); i++)
+    {
+        for (int j = 0; j < A.get_cols(); j++)
+        {
+            y(i) += A.get_element(i, j) * x(j);
+        }
+    }
+    return y;
+}
+
+TEST(MatrixOperatorTest, GemvOfMatrixAndViews)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+
+    // Large enough for the parallel operator to split every product over the pool.
+    Matrix A = filled_matrix(300, 170, 70);
+    Vector x = filled_vector(170, 1);
+    Vector z = filled_vector(300, 2);
+
+    for (const MatrixOperator *op : {&serial_operator, &parallel_operator})
+    {
+        EXPECT_EQ(op->gemv(A, x).to_std_vector(), reference_gemv(A.view(), x).to_std_vector());
+        EXPECT_EQ(op->gemv(A.transpose_view(), z).to_std_vector(), reference_gemv<double>(A.transpose_view(), z).to_std_vector());
+
+        MatrixView sub = A.view().sub_view(10, 20, 150, 100);
+        Vector w = filled_vector(100, 3);
+        EXPECT_EQ(op->gemv(sub, w).to_std_vector(), reference_gemv(sub, w).to_std_vector());
+
+        MatrixView padded = A.view().sub_view(0, 0, 290, 160).padded(300, 170);
+        EXPECT_EQ(op->gemv(padded, x).to_std_vector(), reference_gemv(padded, x).to_std_vector());
+    }
+
+    FloatMatrix F = filled_matrix<float>(41, 29, 71);
+    FloatVector fx = filled_vector<float>(41, 4);
+    EXPECT_EQ(parallel_operator.gemv(F.transpose_view(), fx).to_std_vector(),
+              reference_gemv<float>(F.transpose_view(), fx).to_std_vector());
+
+    EXPECT_THROW(serial_operator.gemv(A, z), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, GemvAccumulatesAndAllowsAliasing)
+{
+    MatrixOperator matrix_operator;
+    Matrix A = filled_matrix(24, 24, 72);
+    Vector x = filled_vector(24, 5);
+    Vector y = filled_vector(24, 6);
+    Vector initial = y;
+
+    matrix_operator.gemv(2.0, A.view(), x, -1.0, y);
+    Vector product = reference_gemv(A.view(), x);
+    for (int i = 0; i < 24; i++)
+    {
+        EXPECT_EQ(y(i), 2 * product(i) - initial(i));
+    }
+
+    // x = A^T * x, the operand keeps the elements it had before the call.
+    Vector original = x;
+    matrix_operator.gemv(1.0, A.transpose_view(), x, 0.0, x);
+    EXPECT_EQ(x.to_std_vector(), reference_gemv<double>(A.transpose_view(), original).to_std_vector());
+
+    Vector wrong_size(23);
+    EXPECT_THROW(matrix_operator.gemv(1.0, A.view(), x, 0.0, wrong_size), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, GerDotAndAxpy)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+
+    Vector x = filled_vector(400, 7);
+    Vector y = filled_vector(130, 8);
+    Matrix A = filled_matrix(400, 130, 73);
+
+    for (const MatrixOperator *op : {&serial_operator, &parallel_operator})
+    {
+        Matrix B = A;
+        op->ger(-2.0, x, y, B);
+        for (int i = 0; i < 400; i++)
+        {
+            for (int j = 0; j < 130; j++)
+            {
+                EXPECT_EQ(B(i, j), A(i, j) - 2 * x(i) * y(j));
+            }
+        }
+
+        Vector u = filled_vector(50000, 9);
+        Vector v = filled_vector(50000, 10);
+        double expected_dot = 0;
+        for (int i = 0; i < 50000; i++)
+        {
+            expected_dot += u(i) * v(i);
+        }
+        EXPECT_EQ(op->dot(u, v), expected_dot);
+
+        Vector w = v;
+        op->axpy(3.0, u, w);
+        for (int i = 0; i < 50000; i++)
+        {
+            EXPECT_EQ(w(i), v(i) + 3 * u(i));
+        }
+    }
+
+    EXPECT_THROW(serial_operator.ger(1.0, y, x, A), InvalidMatrixFormat);
+    EXPECT_THROW(serial_operator.dot(x, y), InvalidMatrixFormat);
+    EXPECT_THROW(serial_operator.axpy(1.0, x, y), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, SpmvInBothFormats)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+
+    // Enough nonzeros for the parallel operator to split the product over the pool.
+    Matrix M = sparse_matrix(1200, 900, 11, 74);
+    SparseMatrix A = SparseMatrix::from_dense(M);
+    Vector x = filled_vector(900, 11);
+    Vector z = filled_vector(1200, 12);
+
+    for (const MatrixOperator *op : {&serial_operator, &parallel_operator})
+    {
+        EXPECT_EQ(op->spmv(A, x).to_std_vector(), reference_gemv(M.view(), x).to_std_vector());
+        EXPECT_EQ(op->spmv(A.to_format(SparseFormat::CSC), x).to_std_vector(), reference_gemv(M.view(), x).to_std_vector());
+        EXPECT_EQ(op->spmv(A.transpose(), z).to_std_vector(), reference_gemv<double>(M.transpose_view(), z).to_std_vector());
+
+        Vector y = z;
+        op->spmv(2.0, A, x, -1.0, y);
+        Vector product = reference_gemv(M.view(), x);
+        for (int i = 0; i < 1200; i++)
+        {
+            EXPECT_EQ(y(i), 2 * product(i) - z(i));
+        }
+    }
+
+    // y = A^T * y for square A, the operand keeps the elements it had before the call.
+    FloatMatrix F = sparse_matrix<float>(50, 50, 11, 75);
+    FloatVector v = filled_vector<float>(50, 13);
+    FloatVector original = v;
+    serial_operator.spmv(1.0, FloatSparseMatrix::from_dense(F).transpose(), v, 0.0, v);
+    EXPECT_EQ(v.to_std_vector(), reference_gemv<float>(F.transpose_view(), original).to_std_vector());
+
+    EXPECT_THROW(serial_operator.spmv(A, z), InvalidMatrixFormat);
+}
+
+TEST(MatrixOperatorTest, SpmmWithDenseMatricesAndViews)
+{
+    ThreadPool thread_pool(4);
+    MatrixOperator serial_operator;
+    MatrixOperator parallel_operator(thread_pool);
+
+    Matrix M = sparse_matrix(300, 200, 11, 76);
+    SparseMatrix A = SparseMatrix::from_dense(M);
+    Matrix B = filled_matrix(200, 70, 77);
+    Matrix D = filled_matrix(70, 200, 78);
+
+    for (const MatrixOperator *op : {&serial_operator, &parallel_operator})
+    {
+        Matrix expected = reference_matmul(M, B);
+        for (const SparseMatrix &S : {A, A.to_format(SparseFormat::CSC)})
+        {
+            Matrix C = op->spmm(S, B);
+            Matrix CT = op->spmm(S, D.transpose_view());
+            for (int i = 0; i < 300; i++)
+            {
+                for (int j = 0; j < 70; j++)
+                {
+                    EXPECT_EQ(C(i, j), expected(i, j));
+                }
+            }
+            Matrix expected_transposed = reference_matmul(M, transposed_copy(D));
+            for (int i = 0; i < 300; i++)
+            {
+                for (int j = 0; j < 70; j++)
+                {
+                    EXPECT_EQ(CT(i, j), expected_transposed(i, j));
+                }
+            }
+        }
+
+        // Dense times sparse through the transpose: (B^T * M)^T = M^T * B
+        Matrix dense_sparse = op->spmm(A.transpose(), filled_matrix(300, 40, 79).view());
+        Matrix expected_dense_sparse = reference_matmul(transposed_copy(M), filled_matrix(300, 40, 79));
+        for (int i = 0; i < 200; i++)
+        {
+            for (int j = 0; j < 40; j++)
+            {
+                EXPECT_EQ(dense_sparse(i, j), expected_dense_sparse(i, j));
+            }
+        }
+    }
+
+    // C = 2 * A * C + C, with B a padded view of C.
+    Matrix square = sparse_matrix(60, 60, 11, 80);
+    Matrix C = filled_matrix(60, 60, 81);
+    Matrix initial = C;
+    serial_operator.spmm(2.0, SparseMatrix::from_dense(square), C.view().sub_view(0, 0, 55, 60).padded(60, 60), 1.0, C);
+    Matrix padded_initial = initial;
+    for (int i = 55; i < 60; i++)
+    {
+        for (int j = 0; j < 60; j++)
+        {
+            padded_initial(i, j) = 0;
+        }
+    }
+    Matrix product = reference_matmul(square, padded_initial);
+    for (int i = 0; i < 60; i++)
+    {
+        for (int j = 0; j < 60; j++)
+        {
+            EXPECT_EQ(C(i, j), 2 * product(i, j) + initial(i, j));
+        }
+    }
+
+    EXPECT_THROW(serial_operator.spmm(A, D), InvalidMatrixFormat);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
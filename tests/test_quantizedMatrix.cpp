@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "../include/QuantizedMatrix.hpp"
+#include "../include/Matrix.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+#include "test_helpers.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A filled matrix with fractional elements whose magnitude varies between rows and between columns.
+ */
+static Matrix scaled_matrix(int rows, int cols, int seed)
+{
+    Matrix M = filled_matrix(rows, cols, seed);
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            M(i, j) *= 0.37 * (1 + i % 3) * (1 + j % 2);
+        }
+    }
+    return M;
+}
+
+TEST(QuantizedMatrixTest, QuantizePerRow)
+{
+    Matrix M = scaled_matrix(9, 14, 1);
+    QuantizedMatrix Q = QuantizedMatrix::quantize(M.view(), QuantizationAxis::PerRow);
+
+    ASSERT_EQ(Q.get_rows(), 9);
+    ASSERT_EQ(Q.get_cols(), 14);
+    EXPECT_EQ(Q.get_axis(), QuantizationAxis::PerRow);
+    ASSERT_EQ(Q.get_scales().size(), 9u);
+
+    FloatMatrix restored = Q.dequantize();
+    for (int i = 0; i < 9; i++)
+    {
+        double largest = 0;
+        for (int j = 0; j < 14; j++)
+        {
+            largest = std::max(largest, std::abs(M(i, j)));
+        }
+        float scale = Q.get_scales()[i];
+        EXPECT_FLOAT_EQ(scale, static_cast<float>(largest / 127));
+
+        for (int j = 0; j < 14; j++)
+        {
+            EXPECT_GE(Q.get_value(i, j), -127);
+            EXPECT_NEAR(restored(i, j), M(i, j), 0.5 * scale + 1e-6);
+        }
+    }
+}
+
+TEST(QuantizedMatrixTest, QuantizePerColumnOfFloatView)
+{
+    FloatMatrix M(6, 4);
+    M.set_data({{1, -2, 0, 0.5f},
+                {2, 4, 0, -0.25f},
+                {-3, 8, 0, 1},
+                {4, -16, 0, 0},
+                {5, 32, 0, 0},
+                {-127, 64, 0, 0}});
+    QuantizedMatrix Q = QuantizedMatrix::quantize(M.view(), QuantizationAxis::PerColumn);
+
+    ASSERT_EQ(Q.get_scales().size(), 4u);
+    EXPECT_EQ(Q.get_scales()[0], 1.0f);
+    EXPECT_EQ(Q.get_scales()[1], 64.0f / 127);
+    EXPECT_EQ(Q.get_scales()[2], 1.0f); // A column of zeros
+    EXPECT_EQ(Q.get_value(5, 0), -127);
+    EXPECT_EQ(Q.get_value(5, 1), 127);
+    EXPECT_EQ(Q.get_value(2, 0), -3);
+    EXPECT_EQ(Q.get_value(0, 2), 0);
+    EXPECT_EQ(Q.get_value(2, 3), 127);
+}
+
+TEST(QuantizedMatrixTest, QuantizeTransposedView)
+{
+    Matrix M = scaled_matrix(11, 7, 2);
+    QuantizedMatrix Q = QuantizedMatrix::quantize(M.transpose_view(), QuantizationAxis::PerColumn);
+    QuantizedMatrix expected = QuantizedMatrix::quantize(M.view(), QuantizationAxis::PerRow);
+
+    ASSERT_EQ(Q.get_rows(), 7);
+    ASSERT_EQ(Q.get_cols(), 11);
+    EXPECT_EQ(Q.get_scales(), expected.get_scales());
+    for (int i = 0; i < 7; i++)
+    {
+        for (int j = 0; j < 11; j++)
+        {
+            EXPECT_EQ(Q.get_value(i, j), expected.get_value(j, i));
+        }
+    }
+}
+
+TEST(QuantizedMatrixTest, TinyDoubleRowGetsUsableScale)
+{
+    // largest / 127 is below the smallest float, so it would round to a scale of 0.
+    Matrix M(2, 3);
+    M.set_data({{1e-44, -5e-45, 0}, {1, -2, 0.5}});
+    QuantizedMatrix Q = QuantizedMatrix::quantize(M.view(), QuantizationAxis::PerRow);
+
+    EXPECT_EQ(Q.get_scales()[0], 1.0f);
+    for (int j = 0; j < 3; j++)
+    {
+        EXPECT_EQ(Q.get_value(0, j), 0);
+    }
+    EXPECT_EQ(Q.get_value(1, 1), -127);
+
+    FloatMatrix restored = Q.dequantize();
+    EXPECT_EQ(restored(0, 0), 0.0f);
+    EXPECT_NEAR(restored(1, 0), 1.0f, 0.01f);
+}
+
+TEST(QuantizedMatrixTest, ThrowsOnValuesWithoutFloatScale)
+{
+    Matrix huge(1, 2);
+    huge.set_data({{1e300, 1}});
+    EXPECT_THROW(QuantizedMatrix::quantize(huge.view(), QuantizationAxis::PerRow), std::invalid_argument);
+
+    FloatMatrix nan(1, 2);
+    nan.set_data({{std::nanf(""), 1}});
+    EXPECT_THROW(QuantizedMatrix::quantize(nan.view(), QuantizationAxis::PerColumn), std::invalid_argument);
+}
+
+TEST(QuantizedMatrixTest, ConstructorValidatesShape)
+{
+    std::vector<std::int8_t> values(6, 1);
+
+    QuantizedMatrix Q(2, 3, values, {0.5f, 2.0f}, QuantizationAxis::PerRow);
+    EXPECT_EQ(Q.dequantize()(1, 2), 2.0f);
+    EXPECT_THROW(Q.get_value(2, 0), std::out_of_range);
+
+    EXPECT_THROW(QuantizedMatrix(2, 3, values, {1.0f, 1.0f}, QuantizationAxis::PerColumn), InvalidMatrixFormat);
+    EXPECT_THROW(QuantizedMatrix(3, 3, values, {1.0f, 1.0f, 1.0f}, QuantizationAxis::PerRow), InvalidMatrixFormat);
+    EXPECT_THROW(QuantizedMatrix(-2, -3, values, {}, QuantizationAxis::PerRow), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
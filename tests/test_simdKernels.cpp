@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include "../include/SimdKernels.hpp"
+#include "../include/GemmKernel.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <vector>
+
+static const SimdLevel ALL_LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+TEST(SimdKernelsTest, DetectedLevelIsSupported)
+{
+    EXPECT_TRUE(SimdKernels::is_supported(SimdKernels::detect_level()));
+    EXPECT_TRUE(SimdKernels::is_supported(SimdLevel::Scalar));
+}
+
+TEST(SimdKernelsTest, ForceLevelSwitchesActiveTable)
+{
+    SimdKernels::force_level(SimdLevel::Scalar);
+    EXPECT_EQ(SimdKernels::active_level(), SimdLevel::Scalar);
+
+    SimdKernels::reset_level();
+    EXPECT_EQ(SimdKernels::active_level(), SimdKernels::detect_level());
+}
+
+/**
+ * Small integers keep every sum and product exact, so all levels and element types agree bit for bit.
+ */
+template <typename T>
+static void check_element_wise_kernels()
+{
+    // Odd length so that every vector width has a remainder.
+    const int n = 37;
+    std::vector<T> x = filled_buffer<T>(n, 1);
+    std::vector<T> y = filled_buffer<T>(n, 2);
+
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+
+        std::vector<T> sum(n), difference(n), scaled(n);
+        kernels.add(x.data(), y.data(), sum.data(), n);
+        kernels.subtract(x.data(), y.data(), difference.data(), n);
+        kernels.scale(x.data(), T(2.5), scaled.data(), n);
+        std::vector<T> accumulated = y;
+        kernels.axpy(T(-1.5), x.data(), accumulated.data(), n);
+
+        T expected_dot = 0;
+        for (int i = 0; i < n; i++)
+        {
+            EXPECT_EQ(sum[i], x[i] + y[i]);
+            EXPECT_EQ(difference[i], x[i] - y[i]);
+            EXPECT_EQ(scaled[i], x[i] * T(2.5));
+            EXPECT_EQ(accumulated[i], y[i] + T(-1.5) * x[i]);
+            expected_dot += x[i] * y[i];
+        }
+        EXPECT_EQ(kernels.dot(x.data(), y.data(), n), expected_dot);
+    }
+
+    SimdKernels::reset_level();
+}
+
+TEST(SimdKernelsTest, ElementWiseKernelsMatchScalar)
+{
+    check_element_wise_kernels<double>();
+}
+
+TEST(SimdKernelsTest, FloatElementWiseKernelsMatchScalar)
+{
+    check_element_wise_kernels<float>();
+}
+
+template <typename T>
+static void check_gemm_on_every_level()
+{
+    int m = 29, n = 35, k = 21;
+    std::vector<T> a = filled_buffer<T>(m * k, 3);
+    std::vector<T> b = filled_buffer<T>(k * n, 4);
+
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+
+        GemmKernel kernel;
+        std::vector<T> c(m * n, T(0));
+        kernel.multiply(m, n, k, a.data(), k, 1, b.data(), n, 1, c.data(), n);
+
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                T expected = 0;
+                for (int p = 0; p < k; p++)
+                {
+                    expected += a[i * k + p] * b[p * n + j];
+                }
+                EXPECT_EQ(c[i * n + j], expected);
+            }
+        }
+    }
+
+    SimdKernels::reset_level();
+}
+
+TEST(SimdKernelsTest, GemmMatchesReferenceOnEveryLevel)
+{
+    check_gemm_on_every_level<double>();
+}
+
+TEST(SimdKernelsTest, FloatGemmMatchesReferenceOnEveryLevel)
+{
+    check_gemm_on_every_level<float>();
+}
+
+template <typename T>
+static void check_transpose_micro_kernel_on_every_level()
+{
+    // Strides wider than the largest tile, so that rows are not contiguous.
+    const int size = 16;
+    const int in_stride = 19;
+    const int out_stride = 21;
+    std::vector<T> in(size * in_stride);
+    for (int i = 0; i < size * in_stride; i++)
+    {
+        in[i] = static_cast<T>(i);
+    }
+
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+        const SimdKernelTable<T> &kernels = SimdKernels::get<T>();
+        int tile = kernels.transpose_tile;
+        ASSERT_LE(tile, size);
+
+        std::vector<T> out(size * out_stride, T(-1));
+        kernels.transpose_micro_kernel(in.data(), in_stride, out.data(), out_stride);
+
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < out_stride; j++)
+            {
+                T expected = i < tile && j < tile ? in[j * in_stride + i] : T(-1);
+                EXPECT_EQ(out[i * out_stride + j], expected);
+            }
+        }
+    }
+
+    SimdKernels::reset_level();
+}
+
+TEST(SimdKernelsTest, TransposeMicroKernelOnEveryLevel)
+{
+    check_transpose_micro_kernel_on_every_level<double>();
+}
+
+TEST(SimdKernelsTest, FloatTransposeMicroKernelOnEveryLevel)
+{
+    check_transpose_micro_kernel_on_every_level<float>();
+}
+
+/**
+ * Odd k with kc = 3 slices the shared dimension into 12 steps and an odd remainder of 11, and the extremes of int8
+ * are included. Power of two scales keep the dequantized sums exact.
+ */
+TEST(SimdKernelsTest, Int8GemmMatchesReferenceOnEveryLevel)
+{
+    int m = 13, n = 37, k = 23;
+    std::vector<std::int8_t> a(m * k), b(k * n);
+    for (int i = 0; i < m * k; i++)
+    {
+        a[i] = static_cast<std::int8_t>(i % 3 == 0 ? -128 : (i * 37) % 255 - 127);
+    }
+    for (int i = 0; i < k * n; i++)
+    {
+        b[i] = static_cast<std::int8_t>(i % 5 == 0 ? 127 : (i * 53) % 255 - 127);
+    }
+    std::vector<float> row_scales(m), col_scales(n);
+    for (int i = 0; i < m; i++)
+    {
+        row_scales[i] = 1.0f / static_cast<float>(1 << (i % 4));
+    }
+    for (int j = 0; j < n; j++)
+    {
+        col_scales[j] = static_cast<float>(1 << (j % 3));
+    }
+
+    GemmBlockSizes block_sizes;
+    block_sizes.mc = 8;
+    block_sizes.kc = 3;
+    block_sizes.nc = 24;
+
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+
+        GemmKernel kernel(block_sizes);
+        std::vector<float> c(m * n, 1.0f);
+        kernel.multiply_int8(m, n, k, a.data(), k, row_scales.data(), b.data(), n, col_scales.data(), c.data(), n);
+
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                std::int32_t sum = 0;
+                for (int p = 0; p < k; p++)
+                {
+                    sum += a[i * k + p] * b[p * n + j];
+                }
+                EXPECT_EQ(c[i * n + j], 1.0f + row_scales[i] * col_scales[j] * static_cast<float>(sum));
+            }
+        }
+    }
+
+    SimdKernels::reset_level();
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
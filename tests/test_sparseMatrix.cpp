@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include "../include/SparseMatrix.hpp"
+#include "../include/SparseKernel.hpp"
+#include "../include/Matrix.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/InvalidMatrixFormat.hpp"
+#include "test_helpers.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+template <typename T>
+static void expect_same_elements(const BasicMatrix<T> &actual, const BasicMatrix<T> &expected)
+{
+    ASSERT_EQ(actual.get_rows(), expected.get_rows());
+    ASSERT_EQ(actual.get_cols(), expected.get_cols());
+    for (int i = 0; i < expected.get_rows(); i++)
+    {
+        for (int j = 0; j < expected.get_cols(); j++)
+        {
+            EXPECT_EQ(actual(i, j), expected(i, j));
+        }
+    }
+}
+
+TEST(SparseMatrixTest, FromTripletsSortsAndSumsDuplicates)
+{
+    SparseMatrix A = SparseMatrix::from_triplets(3, 4, {{2, 1, 4.0}, {0, 3, 1.0}, {0, 0, 2.0}, {2, 1, -1.0}, {1, 2, 5.0}});
+
+    EXPECT_EQ(A.get_format(), SparseFormat::CSR);
+    EXPECT_EQ(A.get_nonzeros(), 4u);
+    EXPECT_EQ(A.get_offsets(), (std::vector<std::size_t>{0, 2, 3, 4}));
+    EXPECT_EQ(A.get_indices(), (std::vector<int>{0, 3, 2, 1}));
+    EXPECT_EQ(A.get_values(), (std::vector<double>{2, 1, 5, 3}));
+    EXPECT_EQ(A.get_element(2, 1), 3.0);
+    EXPECT_EQ(A.get_element(1, 1), 0.0);
+
+    SparseMatrix B = SparseMatrix::from_triplets(3, 4, {{2, 1, 4.0}, {0, 3, 1.0}, {0, 0, 2.0}}, SparseFormat::CSC);
+    EXPECT_EQ(B.get_offsets(), (std::vector<std::size_t>{0, 1, 2, 2, 3}));
+    EXPECT_EQ(B.get_indices(), (std::vector<int>{0, 2, 0}));
+
+    EXPECT_THROW(SparseMatrix::from_triplets(3, 4, {{3, 0, 1.0}}), std::out_of_range);
+    EXPECT_THROW(A.get_element(0, 4), std::out_of_range);
+}
+
+TEST(SparseMatrixTest, DenseRoundTripInBothFormats)
+{
+    Matrix M = sparse_matrix(23, 31, 7, 1);
+
+    for (SparseFormat format : {SparseFormat::CSR, SparseFormat::CSC})
+    {
+        SparseMatrix A = SparseMatrix::from_dense(M, format);
+        EXPECT_EQ(A.get_format(), format);
+        expect_same_elements(A.to_dense(), M);
+        expect_same_elements(SparseMatrix::from_dense(M.transpose_view(), format).to_dense(), M.transpose());
+    }
+
+    Matrix N = M;
+    N(0, 0) = 0.25;
+    EXPECT_EQ(SparseMatrix::from_dense(N, SparseFormat::CSR, 0.5).get_nonzeros(), SparseMatrix::from_dense(M).get_nonzeros());
+}
+
+TEST(SparseMatrixTest, TransposeSharesArraysAndConversionKeepsElements)
+{
+    FloatMatrix M = sparse_matrix<float>(17, 9, 7, 2);
+    FloatSparseMatrix A = FloatSparseMatrix::from_dense(M);
+
+    FloatSparseMatrix T = A.transpose();
+    EXPECT_EQ(T.get_format(), SparseFormat::CSC);
+    EXPECT_EQ(T.get_rows(), 9);
+    EXPECT_EQ(T.get_cols(), 17);
+    EXPECT_EQ(T.get_values().data(), A.get_values().data());
+    expect_same_elements(T.to_dense(), M.transpose());
+
+    FloatSparseMatrix C = A.to_format(SparseFormat::CSC);
+    EXPECT_EQ(C.get_format(), SparseFormat::CSC);
+    EXPECT_EQ(C.get_nonzeros(), A.get_nonzeros());
+    expect_same_elements(C.to_dense(), M);
+    expect_same_elements(C.to_format(SparseFormat::CSR).to_dense(), M);
+    EXPECT_EQ(C.to_format(SparseFormat::CSR).get_indices(), A.get_indices());
+}
+
+TEST(SparseMatrixTest, ConstructorValidatesArrays)
+{
+    SparseMatrix A(2, 3, {0, 1, 3}, {2, 0, 1}, {1.0, 2.0, 3.0}, SparseFormat::CSR);
+    EXPECT_EQ(A.get_element(1, 1), 3.0);
+
+    EXPECT_THROW(SparseMatrix(2, 3, {0, 1}, {2}, {1.0}, SparseFormat::CSR), InvalidMatrixFormat);
+    EXPECT_THROW(SparseMatrix(2, 3, {0, 1, 3}, {2, 1, 0}, {1.0, 2.0, 3.0}, SparseFormat::CSR), InvalidMatrixFormat);
+    EXPECT_THROW(SparseMatrix(2, 3, {0, 1, 3}, {2, 0, 3}, {1.0, 2.0, 3.0}, SparseFormat::CSR), InvalidMatrixFormat);
+    EXPECT_THROW(SparseMatrix(2, 3, {0, 2, 1}, {2}, {1.0}, SparseFormat::CSR), InvalidMatrixFormat);
+    EXPECT_THROW(SparseMatrix(-1, 3), std::invalid_argument);
+    EXPECT_EQ(SparseMatrix(4, 0).get_nonzeros(), 0u);
+}
+
+TEST(SparseMatrixTest, PartitionBalancesNonzeros)
+{
+    // One dense line among sparse ones.
+    std::vector<std::size_t> offsets = {0, 1, 2, 102, 103, 104, 105, 106, 107, 108};
+    std::vector<int> bounds = SparseKernel::partition(9, offsets.data(), 4);
+
+    ASSERT_EQ(bounds.size(), 5u);
+    EXPECT_EQ(bounds.front(), 0);
+    EXPECT_EQ(bounds.back(), 9);
+    for (std::size_t part = 1; part < bounds.size(); part++)
+    {
+        EXPECT_LE(bounds[part - 1], bounds[part]);
+    }
+    EXPECT_EQ(bounds[1], 2); // The dense line starts the second part
+
+    std::vector<std::size_t> empty = {0, 0, 0};
+    EXPECT_EQ(SparseKernel::partition(2, empty.data(), 3), (std::vector<int>{0, 2, 2, 2}));
+}
+
+TEST(SparseMatrixTest, KernelsMatchDenseProductOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    // Enough nonzeros for every kernel to split its work into several parts.
+    const int m = 1400;
+    const int k = 800;
+    const int n = 40;
+    Matrix M = sparse_matrix(m, k, 7, 3);
+    SparseMatrix csr = SparseMatrix::from_dense(M);
+    SparseMatrix csc = SparseMatrix::from_dense(M, SparseFormat::CSC);
+    Matrix B = sparse_matrix(k, n, 7, 4);
+    for (int i = 0; i < k; i++)
+    {
+        B(i, i % n) += 1;
+    }
+
+    std::vector<double> x(k);
+    for (int j = 0; j < k; j++)
+    {
+        x[j] = j % 5 - 2;
+    }
+    std::vector<double> expected_y(m, 1.0);
+    Matrix expected_c(m, n);
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            double element = M.unchecked(i, j);
+            if (element == 0)
+            {
+                continue;
+            }
+            expected_y[i] += 2 * element * x[j];
+            for (int l = 0; l < n; l++)
+            {
+                expected_c.unchecked(i, l) += 2 * element * B.unchecked(j, l);
+            }
+        }
+    }
+
+    for (const SparseMatrix *A : {&csr, &csc})
+    {
+        const std::size_t *offsets = A->get_offsets().data();
+        const int *indices = A->get_indices().data();
+        const double *values = A->get_values().data();
+        bool is_csr = A->get_format() == SparseFormat::CSR;
+
+        std::vector<double> serial_y(m, 1.0), parallel_y(m, 1.0);
+        Matrix serial_c(m, n), parallel_c(m, n);
+        if (is_csr)
+        {
+            SparseKernel::csr_spmv(m, offsets, indices, values, 2.0, x.data(), serial_y.data());
+            SparseKernel::csr_spmv(thread_pool, m, offsets, indices, values, 2.0, x.data(), parallel_y.data());
+            SparseKernel::csr_spmm(m, n, offsets, indices, values, 2.0, B.data(), B.get_leading_dimension(), serial_c.data(), serial_c.get_leading_dimension());
+            SparseKernel::csr_spmm(thread_pool, m, n, offsets, indices, values, 2.0, B.data(), B.get_leading_dimension(), parallel_c.data(), parallel_c.get_leading_dimension());
+        }
+        else
+        {
+            SparseKernel::csc_spmv(m, k, offsets, indices, values, 2.0, x.data(), serial_y.data());
+            SparseKernel::csc_spmv(thread_pool, m, k, offsets, indices, values, 2.0, x.data(), parallel_y.data());
+            SparseKernel::csc_spmm(k, n, offsets, indices, values, 2.0, B.data(), B.get_leading_dimension(), serial_c.data(), serial_c.get_leading_dimension());
+            SparseKernel::csc_spmm(thread_pool, k, n, offsets, indices, values, 2.0, B.data(), B.get_leading_dimension(), parallel_c.data(), parallel_c.get_leading_dimension());
+        }
+
+        EXPECT_EQ(serial_y, expected_y);
+        EXPECT_EQ(parallel_y, expected_y);
+        expect_same_elements(serial_c, expected_c);
+        expect_same_elements(parallel_c, expected_c);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
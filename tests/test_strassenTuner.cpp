@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "../include/StrassenThresholds.hpp"
+#include "../include/StrassenTuner.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static std::string temporary_path(const std::string &name)
+{
+    return ::testing::TempDir() + name;
+}
+
+TEST(StrassenThresholdsTest, ThresholdForPicksShapeBucket)
+{
+    StrassenThresholds thresholds;
+    thresholds.square = 100;
+    thresholds.rectangular = 300;
+
+    EXPECT_EQ(thresholds.threshold_for(512, 512, 512), 100);
+    EXPECT_EQ(thresholds.threshold_for(512, 1024, 600), 100);
+    EXPECT_EQ(thresholds.threshold_for(512, 512, 2048), 300);
+}
+
+TEST(StrassenThresholdsTest, SaveAndLoadRoundTrip)
+{
+    std::string path = temporary_path("strassen_round_trip.conf");
+
+    StrassenThresholds thresholds;
+    thresholds.square = 384;
+    thresholds.rectangular = StrassenThresholds::NEVER;
+    thresholds.save(path);
+
+    StrassenThresholds loaded = StrassenThresholds::load(path);
+
+    EXPECT_EQ(loaded.square, 384);
+    EXPECT_EQ(loaded.rectangular, StrassenThresholds::NEVER);
+
+    std::remove(path.c_str());
+}
+
+TEST(StrassenThresholdsTest, LoadKeepsDefaultsForMissingKeys)
+{
+    std::string path = temporary_path("strassen_partial.conf");
+    {
+        std::ofstream file(path);
+        file << "# only the square threshold\n";
+        file << "square 64\n";
+    }
+
+    StrassenThresholds loaded = StrassenThresholds::load(path);
+
+    EXPECT_EQ(loaded.square, 64);
+    EXPECT_EQ(loaded.rectangular, StrassenThresholds().rectangular);
+
+    std::remove(path.c_str());
+}
+
+TEST(StrassenThresholdsTest, LoadThrowsOnInvalidFile)
+{
+    std::string path = temporary_path("strassen_invalid.conf");
+    {
+        std::ofstream file(path);
+        file << "square sixty-four\n";
+    }
+
+    EXPECT_THROW(StrassenThresholds::load(path), std::runtime_error);
+    EXPECT_THROW(StrassenThresholds::load(temporary_path("does_not_exist.conf")), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST(StrassenTunerTest, TuneReturnsCandidateOrNever)
+{
+    StrassenTuner tuner;
+    tuner.set_sizes({32, 16});
+    tuner.set_repetitions(1);
+
+    StrassenThresholds thresholds = tuner.tune();
+
+    for (int threshold : {thresholds.square, thresholds.rectangular})
+    {
+        EXPECT_TRUE(threshold == 8 || threshold == 16 || threshold == StrassenThresholds::NEVER);
+    }
+}
+
+TEST(StrassenTunerTest, RejectsInvalidSettings)
+{
+    StrassenTuner tuner;
+
+    EXPECT_THROW(tuner.set_sizes({}), std::invalid_argument);
+    EXPECT_THROW(tuner.set_sizes({1, 64}), std::invalid_argument);
+    EXPECT_THROW(tuner.set_repetitions(0), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
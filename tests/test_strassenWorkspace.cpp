@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "../include/StrassenWorkspace.hpp"
+
+TEST(StrassenWorkspaceTest, RequiredSizeOfBaseCaseIsZero)
+{
+    EXPECT_EQ(StrassenWorkspace::required_size(64, 64, 64, 64, 0), 0);
+    EXPECT_EQ(StrassenWorkspace::required_size(1, 1, 1, 0, 0), 0);
+    EXPECT_EQ(StrassenWorkspace::required_size(500, 16, 500, 16, 0), 0);
+}
+
+TEST(StrassenWorkspaceTest, RequiredSizeSumsLevels)
+{
+    // Two serial levels: 2 blocks of 32x32, then 2 blocks of 16x16.
+    EXPECT_EQ(StrassenWorkspace::required_size(64, 64, 64, 16, 0), 2 * 32 * 32 + 2 * 16 * 16);
+
+    // One parallel level with seven independent serial sub-levels.
+    EXPECT_EQ(StrassenWorkspace::required_size(64, 64, 64, 16, 1), 11 * 32 * 32 + 7 * 2 * 16 * 16);
+}
+
+TEST(StrassenWorkspaceTest, RequiredSizeOfRectangularAndOddShapes)
+{
+    // A sums are 20x10, B sums 10x30 and products 20x30. The odd dimensions are peeled off.
+    EXPECT_EQ(StrassenWorkspace::required_size(41, 21, 61, 16, 0), 20 * 30 + 10 * 30);
+
+    EXPECT_EQ(StrassenWorkspace::required_size(41, 21, 61, 16, 1), 4 * 20 * 10 + 4 * 10 * 30 + 3 * 20 * 30);
+}
+
+TEST(StrassenWorkspaceTest, ReserveOnlyGrows)
+{
+    StrassenWorkspace workspace;
+
+    EXPECT_EQ(workspace.capacity(), 0);
+    EXPECT_EQ(workspace.get_allocation_count(), 0);
+
+    workspace.reserve(1000);
+    double *data = workspace.data();
+    workspace.reserve(500);
+
+    EXPECT_EQ(workspace.capacity(), 1000);
+    EXPECT_EQ(workspace.data(), data);
+    EXPECT_EQ(workspace.get_allocation_count(), 1);
+
+    workspace.reserve(2000);
+
+    EXPECT_EQ(workspace.capacity(), 2000);
+    EXPECT_EQ(workspace.get_allocation_count(), 2);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -85,6 +85,247 @@ TEST(ThreadPoolTest, TestDestruction)
     EXPECT_EQ(counter.load(), 5);
 }
 
+TEST(ThreadPoolTest, ReportsSize)
+{
+    ThreadPool thread_pool(3);
+
+    EXPECT_EQ(thread_pool.size(), 3);
+}
+
+TEST(ThreadPoolTest, RecursiveSubmissionDoesNotDeadlock)
+{
+    ThreadPool thread_pool(1);
+
+    std::function<int(int)> sum_to = [&](int n) -> int
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+        auto future = thread_pool.enqueue(sum_to, n - 1);
+        return n + thread_pool.wait_and_help(future);
+    };
+
+    auto future = thread_pool.enqueue(sum_to, 10);
+
+    EXPECT_EQ(thread_pool.wait_and_help(future), 55);
+}
+
+TEST(ThreadPoolTest, RunPendingTaskOnEmptyQueue)
+{
+    ThreadPool thread_pool(1);
+
+    EXPECT_FALSE(thread_pool.run_pending_task());
+}
+
+TEST(ThreadPoolTest, WorkStealingRunsExternalSubmissions)
+{
+    ThreadPool thread_pool(4, ThreadPool::Scheduling::WorkStealing);
+
+    EXPECT_EQ(thread_pool.get_scheduling(), ThreadPool::Scheduling::WorkStealing);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+    {
+        futures.emplace_back(thread_pool.enqueue([i]
+                                                 { return i * i; }));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(futures[i].get(), i * i);
+    }
+}
+
+TEST(ThreadPoolTest, WorkStealingRecursiveSubmission)
+{
+    ThreadPool thread_pool(3, ThreadPool::Scheduling::WorkStealing);
+
+    // Each call spawns two subtasks, so most tasks are pushed to worker deques and spread by stealing.
+    std::function<long long(int, int)> sum_range = [&](int begin, int end) -> long long
+    {
+        if (end - begin <= 4)
+        {
+            long long sum = 0;
+            for (int i = begin; i < end; i++)
+            {
+                sum += i;
+            }
+            return sum;
+        }
+
+        int middle = begin + (end - begin) / 2;
+        auto left = thread_pool.enqueue(sum_range, begin, middle);
+        auto right = thread_pool.enqueue(sum_range, middle, end);
+        return thread_pool.wait_and_help(left) + thread_pool.wait_and_help(right);
+    };
+
+    auto future = thread_pool.enqueue(sum_range, 0, 10000);
+
+    EXPECT_EQ(thread_pool.wait_and_help(future), 10000LL * 9999 / 2);
+}
+
+TEST(ThreadPoolTest, WorkStealingDestructionRunsQueuedTasks)
+{
+    std::atomic<int> counter{0};
+    {
+        ThreadPool thread_pool(2, ThreadPool::Scheduling::WorkStealing);
+        for (int i = 0; i < 50; ++i)
+        {
+            thread_pool.enqueue([&counter]()
+                                {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                counter.fetch_add(1); });
+        }
+    }
+
+    EXPECT_EQ(counter.load(), 50);
+}
+
+TEST(ThreadPoolTest, WorkStealingRunPendingTaskFromOutside)
+{
+    ThreadPool thread_pool(1, ThreadPool::Scheduling::WorkStealing);
+
+    EXPECT_FALSE(thread_pool.run_pending_task());
+
+    // Keep the only worker busy so that the second task stays in the injection queue.
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> started{false};
+    auto blocker = thread_pool.enqueue([&started, released]()
+                                       {
+        started = true;
+        released.wait(); });
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+
+    auto queued = thread_pool.enqueue([]
+                                      { return 7; });
+
+    EXPECT_TRUE(thread_pool.run_pending_task());
+    EXPECT_EQ(queued.get(), 7);
+
+    release.set_value();
+    blocker.get();
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce)
+{
+    for (auto scheduling : {ThreadPool::Scheduling::SharedQueue, ThreadPool::Scheduling::WorkStealing})
+    {
+        ThreadPool thread_pool(3, scheduling);
+        std::vector<std::atomic<int>> visits(1000);
+        std::atomic<int> chunks{0};
+
+        thread_pool.parallel_for(5, 1000, 10, [&](size_t begin, size_t end)
+                                 {
+            EXPECT_LT(begin, end);
+            chunks.fetch_add(1);
+            for (size_t i = begin; i < end; i++)
+            {
+                visits[i].fetch_add(1);
+            } });
+
+        for (size_t i = 0; i < visits.size(); i++)
+        {
+            EXPECT_EQ(visits[i].load(), i < 5 ? 0 : 1);
+        }
+        EXPECT_GT(chunks.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForRespectsGrain)
+{
+    ThreadPool thread_pool(4);
+    std::atomic<int> chunks{0};
+
+    thread_pool.parallel_for(0, 100, 40, [&](size_t begin, size_t end)
+                             {
+        EXPECT_TRUE(end - begin == 40 || end == 100);
+        chunks.fetch_add(1); });
+
+    EXPECT_EQ(chunks.load(), 3);
+
+    bool called = false;
+    thread_pool.parallel_for(10, 10, 1, [&](size_t, size_t)
+                             { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsAfterAllChunks)
+{
+    ThreadPool thread_pool(2);
+    std::atomic<int> chunks{0};
+
+    EXPECT_THROW(thread_pool.parallel_for(0, 64, 1, [&](size_t begin, size_t)
+                                          {
+                     chunks.fetch_add(1);
+                     if (begin == 0)
+                     {
+                         throw std::runtime_error("chunk failed");
+                     } }),
+                 std::runtime_error);
+
+    EXPECT_EQ(chunks.load(), 8);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock)
+{
+    ThreadPool thread_pool(2, ThreadPool::Scheduling::WorkStealing);
+    std::atomic<int> total{0};
+
+    thread_pool.parallel_for(0, 8, 1, [&](size_t, size_t)
+                             { thread_pool.parallel_for(0, 100, 1, [&](size_t begin, size_t end)
+                                                        { total.fetch_add(static_cast<int>(end - begin)); }); });
+
+    EXPECT_EQ(total.load(), 800);
+}
+
+TEST(ThreadPoolTest, ParallelReduceIsDeterministic)
+{
+    ThreadPool thread_pool(3, ThreadPool::Scheduling::WorkStealing);
+    std::vector<double> values(10007);
+    double expected = 0.0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = 1.0 / static_cast<double>(i + 1);
+        expected += values[i];
+    }
+
+    auto sum = [&]()
+    {
+        return thread_pool.parallel_reduce(
+            0, values.size(), 100, 0.0,
+            [&](size_t begin, size_t end)
+            {
+                double partial = 0.0;
+                for (size_t i = begin; i < end; i++)
+                {
+                    partial += values[i];
+                }
+                return partial;
+            },
+            [](double left, double right)
+            { return left + right; });
+    };
+
+    double first = sum();
+    EXPECT_NEAR(first, expected, 1e-12);
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(sum(), first);
+    }
+
+    EXPECT_EQ(thread_pool.parallel_reduce(
+                  3, 3, 1, 42, [](size_t, size_t)
+                  { return 0; },
+                  [](int left, int right)
+                  { return left + right; }),
+              42);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
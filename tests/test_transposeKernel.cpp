@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "../include/TransposeKernel.hpp"
+#include "../include/SimdKernels.hpp"
+#include "../include/ThreadPool.hpp"
+
+#include <vector>
+
+static const SimdLevel ALL_LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+template <typename T = double>
+static std::vector<T> numbered_buffer(int size)
+{
+    std::vector<T> buffer(size);
+    for (int i = 0; i < size; i++)
+    {
+        buffer[i] = static_cast<T>(i);
+    }
+    return buffer;
+}
+
+template <typename T>
+static void check_transpose_on_every_level()
+{
+    // Small, odd, tall, wide, a few float tiles and larger than several leaves.
+    const int shapes[][2] = {{1, 1}, {3, 5}, {8, 8}, {37, 70}, {130, 9}, {48, 33}, {97, 101}};
+
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+
+        for (const auto &shape : shapes)
+        {
+            int rows = shape[0], cols = shape[1];
+            int in_stride = cols + 3, out_stride = rows + 5;
+            std::vector<T> in = numbered_buffer<T>(rows * in_stride);
+            std::vector<T> out(cols * out_stride, T(-1));
+
+            TransposeKernel::transpose(rows, cols, in.data(), in_stride, out.data(), out_stride);
+
+            for (int i = 0; i < cols; i++)
+            {
+                for (int j = 0; j < out_stride; j++)
+                {
+                    EXPECT_EQ(out[i * out_stride + j], j < rows ? in[j * in_stride + i] : T(-1));
+                }
+            }
+        }
+    }
+
+    SimdKernels::reset_level();
+}
+
+TEST(TransposeKernelTest, TransposeOnEveryLevel)
+{
+    check_transpose_on_every_level<double>();
+}
+
+TEST(TransposeKernelTest, FloatTransposeOnEveryLevel)
+{
+    check_transpose_on_every_level<float>();
+}
+
+template <typename T>
+static void check_transpose_in_place_on_every_level()
+{
+    for (SimdLevel level : ALL_LEVELS)
+    {
+        if (!SimdKernels::is_supported(level))
+        {
+            continue;
+        }
+        SimdKernels::force_level(level);
+
+        for (int n : {1, 2, 7, 8, 33, 48, 100, 131})
+        {
+            int stride = n + 2;
+            std::vector<T> original = numbered_buffer<T>(n * stride);
+            std::vector<T> data = original;
+
+            TransposeKernel::transpose_in_place(n, data.data(), stride);
+
+            for (int i = 0; i < n; i++)
+            {
+                for (int j = 0; j < stride; j++)
+                {
+                    EXPECT_EQ(data[i * stride + j], j < n ? original[j * stride + i] : original[i * stride + j]);
+                }
+            }
+        }
+    }
+
+    SimdKernels::reset_level();
+}
+
+TEST(TransposeKernelTest, TransposeInPlaceOnEveryLevel)
+{
+    check_transpose_in_place_on_every_level<double>();
+}
+
+TEST(TransposeKernelTest, FloatTransposeInPlaceOnEveryLevel)
+{
+    check_transpose_in_place_on_every_level<float>();
+}
+
+TEST(TransposeKernelTest, ParallelMatchesSerial)
+{
+    ThreadPool thread_pool(3, ThreadPool::Scheduling::WorkStealing);
+
+    const int shapes[][2] = {{300, 257}, {40, 1500}, {1500, 40}};
+    for (const auto &shape : shapes)
+    {
+        int rows = shape[0], cols = shape[1];
+        std::vector<double> in = numbered_buffer(rows * cols);
+        std::vector<double> serial(rows * cols), parallel(rows * cols);
+
+        TransposeKernel::transpose(rows, cols, in.data(), cols, serial.data(), rows);
+        TransposeKernel::transpose(thread_pool, rows, cols, in.data(), cols, parallel.data(), rows);
+        EXPECT_EQ(parallel, serial);
+    }
+
+    int n = 517;
+    std::vector<double> serial = numbered_buffer(n * n);
+    std::vector<double> parallel = serial;
+    TransposeKernel::transpose_in_place(n, serial.data(), n);
+    TransposeKernel::transpose_in_place(thread_pool, n, parallel.data(), n);
+    EXPECT_EQ(parallel, serial);
+    EXPECT_EQ(parallel[1 * n + 0], 1);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "../include/Vector.hpp"
+#include "../include/VectorKernel.hpp"
+#include "../include/MatrixAllocator.hpp"
+#include "../include/ThreadPool.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST(VectorTest, ElementsAreZeroedAndAligned)
+{
+    Vector v(13);
+
+    ASSERT_EQ(v.get_size(), 13);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % MatrixAllocator::ALIGNMENT, 0u);
+    for (int i = 0; i < 13; i++)
+    {
+        EXPECT_EQ(v(i), 0.0);
+    }
+
+    v(3) = 2.5;
+    v.set_element(12, -1.0);
+    EXPECT_EQ(v.get_element(3), 2.5);
+    EXPECT_EQ(v.data()[12], -1.0);
+
+    EXPECT_THROW(v(13), std::out_of_range);
+    EXPECT_THROW(v.get_element(-1), std::out_of_range);
+    EXPECT_THROW(Vector(-1), std::invalid_argument);
+    EXPECT_NO_THROW(Vector(0));
+}
+
+TEST(VectorTest, ConstructFromValuesAndView)
+{
+    FloatVector v(std::vector<float>{1, 2, 3});
+    FloatMatrixView view = v.view();
+
+    ASSERT_EQ(view.get_rows(), 3);
+    ASSERT_EQ(view.get_cols(), 1);
+    EXPECT_EQ(view.get_element(2, 0), 3.0f);
+    EXPECT_EQ(v.to_std_vector(), (std::vector<float>{1, 2, 3}));
+}
+
+TEST(VectorTest, CopiesAndViewsKeepTheirElements)
+{
+    Vector v(std::vector<double>{1, 2});
+    Vector copy = v;
+    MatrixView view = v.view();
+    v(0) = 5.0;
+
+    EXPECT_EQ(copy(0), 1.0);
+    EXPECT_EQ(view.get_element(0, 0), 1.0);
+    EXPECT_EQ(v(0), 5.0);
+}
+
+/**
+ * Checks y += alpha * A * x for A read row-major, column-major and with a stride that is neither.
+ */
+template <typename T>
+static void check_gemv_layouts(ThreadPool *pool)
+{
+    // Taller than a y slice and wide enough to split over the pool.
+    const int m = 1100;
+    const int n = 70;
+    std::vector<T> a = filled_buffer<T>(m * n * 2, 1);
+    std::vector<T> x = filled_buffer<T>(n, 2);
+
+    const int strides[][2] = {{n, 1}, {1, m}, {2 * n, 2}};
+    for (const auto &stride : strides)
+    {
+        std::vector<T> y = filled_buffer<T>(m, 3);
+        std::vector<T> expected = y;
+        for (int i = 0; i < m; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                expected[i] += T(2) * a[i * stride[0] + j * stride[1]] * x[j];
+            }
+        }
+
+        if (pool != nullptr)
+        {
+            VectorKernel::gemv(*pool, m, n, T(2), a.data(), stride[0], stride[1], x.data(), y.data());
+        }
+        else
+        {
+            VectorKernel::gemv(m, n, T(2), a.data(), stride[0], stride[1], x.data(), y.data());
+        }
+        EXPECT_EQ(y, expected);
+    }
+}
+
+TEST(VectorTest, GemvKernelOnEveryLayout)
+{
+    check_gemv_layouts<double>(nullptr);
+    check_gemv_layouts<float>(nullptr);
+}
+
+TEST(VectorTest, GemvKernelOnThreadPool)
+{
+    ThreadPool thread_pool(4);
+    check_gemv_layouts<double>(&thread_pool);
+    check_gemv_layouts<float>(&thread_pool);
+}
+
+TEST(VectorTest, GerDotAndAxpyKernels)
+{
+    ThreadPool thread_pool(4);
+    const int m = 600;
+    const int n = 130;
+    const int ld = 136;
+    std::vector<double> x = filled_buffer(m, 1);
+    std::vector<double> y = filled_buffer(n, 2);
+    std::vector<double> a = filled_buffer(m * ld, 3);
+    std::vector<double> expected = a;
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            expected[i * ld + j] -= 3 * x[i] * y[j];
+        }
+    }
+
+    std::vector<double> serial = a;
+    VectorKernel::ger(m, n, -3.0, x.data(), y.data(), serial.data(), ld);
+    VectorKernel::ger(thread_pool, m, n, -3.0, x.data(), y.data(), a.data(), ld);
+    EXPECT_EQ(serial, expected);
+    EXPECT_EQ(a, expected);
+
+    const std::size_t length = 100000;
+    std::vector<double> u = filled_buffer(length, 4);
+    std::vector<double> v = filled_buffer(length, 5);
+    double expected_dot = 0;
+    std::vector<double> expected_axpy = v;
+    for (std::size_t i = 0; i < length; i++)
+    {
+        expected_dot += u[i] * v[i];
+        expected_axpy[i] += 0.5 * u[i];
+    }
+    EXPECT_EQ(VectorKernel::dot(length, u.data(), v.data()), expected_dot);
+    EXPECT_EQ(VectorKernel::dot(thread_pool, length, u.data(), v.data()), expected_dot);
+
+    std::vector<double> w = v;
+    VectorKernel::axpy(length, 0.5, u.data(), v.data());
+    VectorKernel::axpy(thread_pool, length, 0.5, u.data(), w.data());
+    EXPECT_EQ(v, expected_axpy);
+    EXPECT_EQ(w, expected_axpy);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "../include/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static WorkStealingDeque::Task *make_task(std::vector<int> &log, int value)
+{
+    return new WorkStealingDeque::Task([&log, value]()
+                                       { log.push_back(value); });
+}
+
+static void run_and_delete(WorkStealingDeque::Task *task)
+{
+    (*task)();
+    delete task;
+}
+
+TEST(WorkStealingDequeTest, PopIsLifoAndStealIsFifo)
+{
+    WorkStealingDeque deque;
+    std::vector<int> log;
+
+    for (int i = 0; i < 4; i++)
+    {
+        deque.push(make_task(log, i));
+    }
+    EXPECT_EQ(deque.size(), 4);
+
+    run_and_delete(deque.pop());
+    run_and_delete(deque.steal());
+    run_and_delete(deque.pop());
+    run_and_delete(deque.steal());
+
+    EXPECT_EQ(log, std::vector<int>({3, 0, 2, 1}));
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    EXPECT_EQ(deque.size(), 0);
+}
+
+TEST(WorkStealingDequeTest, GrowsBeyondInitialCapacity)
+{
+    WorkStealingDeque deque(2);
+    std::vector<int> log;
+
+    for (int i = 0; i < 100; i++)
+    {
+        deque.push(make_task(log, i));
+    }
+    EXPECT_EQ(deque.size(), 100);
+
+    while (WorkStealingDeque::Task *task = deque.steal())
+    {
+        run_and_delete(task);
+    }
+
+    ASSERT_EQ(log.size(), 100);
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(log[i], i);
+    }
+}
+
+TEST(WorkStealingDequeTest, EveryTaskIsTakenExactlyOnceUnderConcurrentSteals)
+{
+    const int task_count = 20000;
+    const int thief_count = 3;
+
+    WorkStealingDeque deque(4);
+    std::vector<std::atomic<int>> runs(task_count);
+    std::atomic<int> taken{0};
+    std::atomic<bool> done{false};
+
+    auto run = [&](WorkStealingDeque::Task *task)
+    {
+        (*task)();
+        delete task;
+        taken.fetch_add(1);
+    };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < thief_count; t++)
+    {
+        thieves.emplace_back([&]()
+                             {
+            while (!done)
+            {
+                if (WorkStealingDeque::Task *task = deque.steal())
+                {
+                    run(task);
+                }
+            } });
+    }
+
+    for (int i = 0; i < task_count; i++)
+    {
+        deque.push(new WorkStealingDeque::Task([&runs, i]()
+                                               { runs[i].fetch_add(1); }));
+        if (i % 3 == 0)
+        {
+            if (WorkStealingDeque::Task *task = deque.pop())
+            {
+                run(task);
+            }
+        }
+    }
+
+    while (WorkStealingDeque::Task *task = deque.pop())
+    {
+        run(task);
+    }
+    while (taken < task_count)
+    {
+        std::this_thread::yield();
+    }
+
+    done = true;
+    for (auto &thief : thieves)
+    {
+        thief.join();
+    }
+
+    for (int i = 0; i < task_count; i++)
+    {
+        EXPECT_EQ(runs[i].load(), 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}